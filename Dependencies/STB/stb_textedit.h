@@ -29,6 +29,7 @@
 //
 // VERSION HISTORY
 //
+//   local             optional STB_TEXTEDIT_FINDROWCHAR/STB_TEXTEDIT_FINDROWY to skip the rows above the cursor
 //   1.12 (2018-01-29) user can change STB_TEXTEDIT_KEYTYPE, fix redo to avoid crash
 //   1.11 (2017-03-03) fix HOME on last line, dragging off single-line textfield
 //   1.10 (2016-10-25) supress warnings about casting away const with -Wcast-qual
@@ -162,6 +163,12 @@
 //    STB_TEXTEDIT_K_LINEEND2            secondary keyboard input to move cursor to end of line
 //    STB_TEXTEDIT_K_TEXTSTART2          secondary keyboard input to move cursor to start of text
 //    STB_TEXTEDIT_K_TEXTEND2            secondary keyboard input to move cursor to end of text
+//    STB_TEXTEDIT_FINDROWCHAR(obj,n,&p,&y) returns the first character of a row at or before the one containing
+//                                          character #n, stores the first character of the row before it (itself
+//                                          if it is the first row) in p and its y in y. Without it rows are laid
+//                                          out one by one from the start of the text to find the cursor.
+//    STB_TEXTEDIT_FINDROWY(obj,y,&ry)   returns the first character of a row at or before the one straddling y
+//                                          and stores its y in ry, same purpose for mouse clicks
 //
 // Todo:
 //    STB_TEXTEDIT_K_PGUP        keyboard input to move cursor up a page
@@ -397,6 +404,10 @@ static int stb_text_locate_coord(STB_TEXTEDIT_STRING *str, float x, float y)
    r.ymin = r.ymax = 0;
    r.num_chars = 0;
 
+   #ifdef STB_TEXTEDIT_FINDROWY
+   i = STB_TEXTEDIT_FINDROWY(str, y, &base_y);
+   #endif
+
    // search rows to find one that straddles 'y'
    while (i < n) {
       STB_TEXTEDIT_LAYOUTROW(&r, str, i);
@@ -527,6 +538,12 @@ static void stb_textedit_find_charpos(StbFindState *find, STB_TEXTEDIT_STRING *s
          find->y = 0;
          find->x = 0;
          find->height = 1;
+         #ifdef STB_TEXTEDIT_FINDROWCHAR
+         if (z > 0) {
+            float row_y;
+            i = STB_TEXTEDIT_FINDROWCHAR(str, z-1, &prev_start, &row_y);
+         }
+         #endif
          while (i < z) {
             STB_TEXTEDIT_LAYOUTROW(&r, str, i);
             prev_start = i;
@@ -542,6 +559,10 @@ static void stb_textedit_find_charpos(StbFindState *find, STB_TEXTEDIT_STRING *s
    // search rows to find the one that straddles character n
    find->y = 0;
 
+   #ifdef STB_TEXTEDIT_FINDROWCHAR
+   i = STB_TEXTEDIT_FINDROWCHAR(str, n, &prev_start, &find->y);
+   #endif
+
    for(;;) {
       STB_TEXTEDIT_LAYOUTROW(&r, str, i);
       if (n < i + r.num_chars)
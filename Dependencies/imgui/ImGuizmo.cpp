@@ -885,10 +885,17 @@ namespace ImGuizmo
          
          float angleStart = atan2f(cameraToModelNormalized[(4-axis)%3], cameraToModelNormalized[(3 - axis) % 3]) + ZPI * 0.5f;
 
+         // half circle from angleStart, rotating the first point by a constant step
+         const float stepCos = cosf(ZPI / (float)halfCircleSegmentCount);
+         const float stepSin = sinf(ZPI / (float)halfCircleSegmentCount);
+         float ngCos = cosf(angleStart);
+         float ngSin = sinf(angleStart);
          for (unsigned int i = 0; i < halfCircleSegmentCount; i++)
          {
-            float ng = angleStart + ZPI * ((float)i / (float)halfCircleSegmentCount);
-            vec_t axisPos = makeVect(cosf(ng), sinf(ng), 0.f);
+            vec_t axisPos = makeVect(ngCos, ngSin, 0.f);
+            const float nextCos = ngCos * stepCos - ngSin * stepSin;
+            ngSin = ngSin * stepCos + ngCos * stepSin;
+            ngCos = nextCos;
             vec_t pos = makeVect(axisPos[axis], axisPos[(axis+1)%3], axisPos[(axis+2)%3]) * gContext.mScreenFactor;
             circlePos[i] = worldToPos(pos, gContext.mMVP);
          }
@@ -34,10 +34,17 @@
 //#define IMGUI_DISABLE_FORMAT_STRING_FUNCTIONS             // Don't implement ImFormatString/ImFormatStringV so you can implement them yourself if you don't want to link with vsnprintf.
 //#define IMGUI_DISABLE_MATH_FUNCTIONS                      // Don't implement ImFabs/ImSqrt/ImPow/ImFmod/ImCos/ImSin/ImAcos/ImAtan2 wrapper so you can implement them yourself. Declare your prototypes in imconfig.h.
 //#define IMGUI_DISABLE_DEFAULT_ALLOCATORS                  // Don't implement default allocators calling malloc()/free() to avoid linking with them. You will need to call ImGui::SetAllocatorFunctions().
+//#define IMGUI_DISABLE_SIMD                                // Don't use the SSE2/AVX2/NEON code paths (text measurement), the scalar code gives the same results.
 
 //---- Include imgui_user.h at the end of imgui.h as a convenience
 //#define IMGUI_INCLUDE_IMGUI_USER_H
 
+//---- Make every ImGuiStorage use a hash index by default (O(1) inserts and lookups, see ImGuiStorage::SetHashIndexed()). Useful with very large numbers of tree nodes.
+//#define IMGUI_STORAGE_HASH_INDEXED
+
+//---- Number of strings CalcTextSize() keeps measured, with their word-wrapping line breaks (0 to disable the cache).
+//#define IMGUI_TEXT_LAYOUT_CACHE_SIZE 2048
+
 //---- Pack colors to BGRA8 instead of RGBA8 (to avoid converting from one to another)
 //#define IMGUI_USE_BGRA_PACKED_COLOR
 
@@ -284,7 +284,9 @@ CODE
 
                  // Render 'pcmd->ElemCount/3' indexed triangles.
                  // By default the indices ImDrawIdx are 16-bits, you can change them to 32-bits if your engine doesn't support 16-bits indices.
-                 MyEngineDrawIndexedTriangles(pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, idx_buffer, vtx_buffer);
+                 // If your engine can offset the vertices it indexes (e.g. glDrawElementsBaseVertex), set io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset
+                 // and add pcmd->VtxOffset: lists larger than 64K vertices then work with 16-bit indices.
+                 MyEngineDrawIndexedTriangles(pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, idx_buffer, vtx_buffer + pcmd->VtxOffset);
              }
              idx_buffer += pcmd->ElemCount;
           }
@@ -907,9 +909,14 @@ static ImVec2           CalcNextScrollFromScrollTargetAndClamp(ImGuiWindow* wind
 static void             AddDrawListToDrawData(ImVector<ImDrawList*>* out_list, ImDrawList* draw_list);
 static void             AddWindowToDrawData(ImVector<ImDrawList*>* out_list, ImGuiWindow* window);
 static void             AddWindowToSortedBuffer(ImVector<ImGuiWindow*>* out_sorted_windows, ImGuiWindow* window);
+static void             UpdateWindowsIdx(ImGuiContext& g);
 
 static ImRect           GetViewportRect();
 
+static ImVec2           CalcTextSizeUncached(ImFont* font, float font_size, float wrap_width, const char* text, const char* text_end, ImVector<int>* out_line_breaks);
+static ImGuiID          TextLayoutKey(ImFont* font, float font_size, float wrap_width, const char* text, const char* text_end);
+static const ImGuiTextLayout* TextLayoutCacheFind(ImGuiContext& g, ImFont* font, float font_size, float wrap_width, const char* text, const char* text_end);
+
 // Settings
 static void*            SettingsHandlerWindow_ReadOpen(ImGuiContext*, ImGuiSettingsHandler*, const char* name);
 static void             SettingsHandlerWindow_ReadLine(ImGuiContext*, ImGuiSettingsHandler*, void* entry, const char* line);
@@ -1006,6 +1013,7 @@ ImGuiStyle::ImGuiStyle()
     AntiAliasedLines        = true;             // Enable anti-aliasing on lines/borders. Disable if you are really short on CPU/GPU.
     AntiAliasedFill         = true;             // Enable anti-aliasing on filled shapes (rounded rectangles, circles, etc.)
     CurveTessellationTol    = 1.25f;            // Tessellation tolerance when using PathBezierCurveTo() without a specific number of segments. Decrease for highly tessellated curves (higher quality, more polygons), increase to reduce quality.
+    CircleSegmentMaxError   = 0.30f;            // Maximum error (in pixels) allowed when using AddCircle()/AddCircleFilled()/PathArcTo() without a specific number of segments, and for rounded corners. Decrease for smoother circles (more polygons), increase to reduce quality.
 
     // Default theme
     ImGui::StyleColorsDark(this);
@@ -1291,48 +1299,109 @@ int ImFormatStringV(char* buf, size_t buf_size, const char* fmt, va_list args)
 }
 #endif // #ifdef IMGUI_DISABLE_FORMAT_STRING_FUNCTIONS
 
-// Pass data_size==0 for zero-terminated strings
-// FIXME-OPT: Replace with e.g. FNV1a hash? CRC32 pretty much randomly access 1KB. Need to do proper measurements.
-ImU32 ImHash(const void* data, int data_size, ImU32 seed)
+// CRC32 (zlib polynomial) used by ImHash().
+// - ARMv8 has CRC32 instructions for this exact polynomial, used when the CPU reports them (compile time, or getauxval() on Linux).
+// - Otherwise slice-by-8: 8 tables of 256 entries, processing 8 bytes per step instead of 1.
+// - x86 SSE4.2 'crc32' is not usable here: it computes CRC32-C (Castagnoli polynomial), which would change every ID and .ini hash.
+#if defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__)) && (defined(__ARM_FEATURE_CRC32) || defined(__linux__))
+#define IMGUI_HASH_ARM_CRC32
+#include <arm_acle.h>
+#if defined(__ARM_FEATURE_CRC32)
+#define IMGUI_HASH_ARM_CRC32_TARGET
+#else
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#if defined(__clang__)
+#define IMGUI_HASH_ARM_CRC32_TARGET __attribute__((target("crc")))
+#else
+#define IMGUI_HASH_ARM_CRC32_TARGET __attribute__((target("+crc")))
+#endif
+#endif
+#endif
+
+static ImU32 GCrc32Lut[8][256] = { { 0 } };
+
+static void ImHashInitCrc32Lut()
 {
-    static ImU32 crc32_lut[256] = { 0 };
-    if (!crc32_lut[1])
+    const ImU32 polynomial = 0xEDB88320;
+    for (ImU32 i = 0; i < 256; i++)
     {
-        const ImU32 polynomial = 0xEDB88320;
-        for (ImU32 i = 0; i < 256; i++)
-        {
-            ImU32 crc = i;
-            for (ImU32 j = 0; j < 8; j++)
-                crc = (crc >> 1) ^ (ImU32(-int(crc & 1)) & polynomial);
-            crc32_lut[i] = crc;
-        }
+        ImU32 crc = i;
+        for (ImU32 j = 0; j < 8; j++)
+            crc = (crc >> 1) ^ (ImU32(-int(crc & 1)) & polynomial);
+        GCrc32Lut[0][i] = crc;
     }
+    for (ImU32 i = 0; i < 256; i++)
+        for (int table = 1; table < 8; table++)
+            GCrc32Lut[table][i] = (GCrc32Lut[table - 1][i] >> 8) ^ GCrc32Lut[0][GCrc32Lut[table - 1][i] & 0xFF];
+}
 
-    seed = ~seed;
-    ImU32 crc = seed;
-    const unsigned char* current = (const unsigned char*)data;
-
-    if (data_size > 0)
+static ImU32 ImHashCrc32SliceBy8(ImU32 crc, const unsigned char* data, size_t data_size)
+{
+    // Little-endian loads written byte by byte, compilers turn them into single loads where possible.
+    for (; data_size >= 8; data_size -= 8, data += 8)
     {
-        // Known size
-        while (data_size--)
-            crc = (crc >> 8) ^ crc32_lut[(crc & 0xFF) ^ *current++];
+        const ImU32 lo = crc ^ (data[0] | (data[1] << 8) | (data[2] << 16) | ((ImU32)data[3] << 24));
+        const ImU32 hi = data[4] | (data[5] << 8) | (data[6] << 16) | ((ImU32)data[7] << 24);
+        crc = GCrc32Lut[7][lo & 0xFF] ^ GCrc32Lut[6][(lo >> 8) & 0xFF] ^ GCrc32Lut[5][(lo >> 16) & 0xFF] ^ GCrc32Lut[4][lo >> 24] ^
+              GCrc32Lut[3][hi & 0xFF] ^ GCrc32Lut[2][(hi >> 8) & 0xFF] ^ GCrc32Lut[1][(hi >> 16) & 0xFF] ^ GCrc32Lut[0][hi >> 24];
     }
-    else
+    while (data_size--)
+        crc = (crc >> 8) ^ GCrc32Lut[0][(crc & 0xFF) ^ *data++];
+    return crc;
+}
+
+#ifdef IMGUI_HASH_ARM_CRC32
+IMGUI_HASH_ARM_CRC32_TARGET static ImU32 ImHashCrc32Arm(ImU32 crc, const unsigned char* data, size_t data_size)
+{
+    for (; data_size >= 8; data_size -= 8, data += 8)
     {
-        // Zero-terminated string
-        while (unsigned char c = *current++)
-        {
-            // We support a syntax of "label###id" where only "###id" is included in the hash, and only "label" gets displayed.
-            // Because this syntax is rarely used we are optimizing for the common case.
-            // - If we reach ### in the string we discard the hash so far and reset to the seed.
-            // - We don't do 'current += 2; continue;' after handling ### to keep the code smaller.
-            if (c == '#' && current[0] == '#' && current[1] == '#')
-                crc = seed;
-            crc = (crc >> 8) ^ crc32_lut[(crc & 0xFF) ^ c];
-        }
+        uint64_t v;
+        memcpy(&v, data, 8);
+        crc = __crc32d(crc, v);
     }
-    return ~crc;
+    while (data_size--)
+        crc = __crc32b(crc, *data++);
+    return crc;
+}
+#endif
+
+typedef ImU32 (*ImHashCrc32Func)(ImU32 crc, const unsigned char* data, size_t data_size);
+static ImHashCrc32Func GCrc32Func = NULL;
+
+// Picks the implementation on first use. Concurrent first calls from several threads all store the same values.
+static ImHashCrc32Func ImHashSelectCrc32()
+{
+    ImHashCrc32Func func = ImHashCrc32SliceBy8;
+#if defined(IMGUI_HASH_ARM_CRC32) && defined(__ARM_FEATURE_CRC32)
+    func = ImHashCrc32Arm;
+#elif defined(IMGUI_HASH_ARM_CRC32)
+    if (getauxval(AT_HWCAP) & HWCAP_CRC32)
+        func = ImHashCrc32Arm;
+#endif
+    if (func == ImHashCrc32SliceBy8)
+        ImHashInitCrc32Lut();
+    GCrc32Func = func;
+    return func;
+}
+
+// Pass data_size==0 for zero-terminated strings
+ImU32 ImHash(const void* data, int data_size, ImU32 seed)
+{
+    ImHashCrc32Func crc32 = GCrc32Func ? GCrc32Func : ImHashSelectCrc32();
+    const unsigned char* current = (const unsigned char*)data;
+    if (data_size > 0)
+        return ~crc32(~seed, current, (size_t)data_size);
+
+    // Zero-terminated string
+    // We support a syntax of "label###id" where only "###id" is included in the hash, and only "label" gets displayed.
+    // Hashing from the last "###" onward (overlapping, so "####id" hashes "###id") matches the old byte-by-byte implementation
+    // which reset the hash to the seed whenever it reached "###". Most strings don't contain any '#', strchr() skips them quickly.
+    const char* start = (const char*)current;
+    for (const char* p = strchr(start, '#'); p != NULL; p = strchr(p + 1, '#'))
+        if (p[1] == '#' && p[2] == '#')
+            start = p;
+    return ~crc32(~seed, (const unsigned char*)start, strlen(start));
 }
 
 FILE* ImFileOpen(const char* filename, const char* mode)
@@ -1397,6 +1466,37 @@ void* ImFileLoadToMemory(const char* filename, const char* file_open_mode, size_
 // [SECTION] MISC HELPERS/UTILITIES (ImText* functions)
 //-----------------------------------------------------------------------------
 
+// Bytes below 0x20 (control characters) and above 0x7F (UTF-8 sequences) are both below 0x20 as signed chars: one comparison finds either.
+int ImTextCountPrintableAscii(const char* in_text, const char* in_text_end)
+{
+    const char* s = in_text;
+#if defined(IMGUI_ENABLE_AVX2)
+    const __m256i limit32 = _mm256_set1_epi8(0x20);
+    for (; in_text_end - s >= 32; s += 32)
+        if (unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpgt_epi8(limit32, _mm256_loadu_si256((const __m256i*)(const void*)s))))
+            return (int)(s - in_text) + ImCountTrailingZeros(mask);
+#endif
+#if defined(IMGUI_ENABLE_SSE2)
+    const __m128i limit = _mm_set1_epi8(0x20);
+    for (; in_text_end - s >= 16; s += 16)
+        if (unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmplt_epi8(_mm_loadu_si128((const __m128i*)(const void*)s), limit)))
+            return (int)(s - in_text) + ImCountTrailingZeros(mask);
+#elif defined(IMGUI_ENABLE_NEON)
+    const int8x16_t limit = vdupq_n_s8(0x20);
+    for (; in_text_end - s >= 16; s += 16)
+    {
+        // Narrow the 16 byte comparison mask to 4 bits per byte, so it fits a 64-bit lane
+        uint8x16_t below = vcltq_s8(vld1q_s8((const int8_t*)(const void*)s), limit);
+        unsigned long long mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(below), 4)), 0);
+        if (mask != 0)
+            return (int)(s - in_text) + ImCountTrailingZeros64(mask) / 4;
+    }
+#endif
+    while (s < in_text_end && (signed char)*s >= 0x20)
+        s++;
+    return (int)(s - in_text);
+}
+
 // Convert UTF-8 to 32-bits character, process single character input.
 // Based on stb_from_utf8() from github.com/nothings/stb/
 // We handle UTF-8 decoding error by skipping forward.
@@ -1712,6 +1812,95 @@ static ImVector<ImGuiStorage::Pair>::iterator LowerBound(ImVector<ImGuiStorage::
     return first;
 }
 
+// Hash index: open addressing with linear probing, kept at most 70% full. Slots are 8 bytes so a probe sequence usually stays
+// within one cache line. Keys are mixed first, as user keys (e.g. SetInt(i) in a loop) may be anything but well distributed.
+static inline int StorageHashSlot(ImGuiID key, int mask)
+{
+    ImU32 h = key;
+    h ^= h >> 16;
+    h *= 0x7FEB352D;
+    h ^= h >> 15;
+    return (int)(h & (ImU32)mask);
+}
+
+static void StorageHashInsertSlot(ImGuiStorage* storage, ImGuiID key, int index)
+{
+    const int mask = storage->HashIndex.Size - 1;
+    int slot = StorageHashSlot(key, mask);
+    while (storage->HashIndex.Data[slot].index >= 0)
+        slot = (slot + 1) & mask;
+    storage->HashIndex.Data[slot].key = key;
+    storage->HashIndex.Data[slot].index = index;
+}
+
+static void StorageHashRebuild(ImGuiStorage* storage, int min_count)
+{
+    int size = 16;
+    while (size * 7 < min_count * 10)
+        size <<= 1;
+    storage->HashIndex.resize(size);
+    memset(storage->HashIndex.Data, 0xFF, (size_t)size * sizeof(ImGuiStorage::HashSlot));
+    for (int i = 0; i < storage->Data.Size; i++)
+        StorageHashInsertSlot(storage, storage->Data[i].key, i);
+}
+
+static ImGuiStorage::Pair* StorageFind(const ImGuiStorage* storage, ImGuiID key)
+{
+    ImVector<ImGuiStorage::Pair>& data = const_cast<ImVector<ImGuiStorage::Pair>&>(storage->Data);
+    if (!storage->HashIndexed)
+    {
+        ImVector<ImGuiStorage::Pair>::iterator it = LowerBound(data, key);
+        return (it == data.end() || it->key != key) ? NULL : it;
+    }
+    if (storage->HashIndex.Size == 0)
+        return NULL;
+    const int mask = storage->HashIndex.Size - 1;
+    for (int slot = StorageHashSlot(key, mask); ; slot = (slot + 1) & mask)
+    {
+        const ImGuiStorage::HashSlot& hash_slot = storage->HashIndex.Data[slot];
+        if (hash_slot.index < 0)
+            return NULL;
+        if (hash_slot.key == key)
+            return &data.Data[hash_slot.index];
+    }
+}
+
+// Returns the existing pair for 'pair.key', or inserts 'pair'.
+static ImGuiStorage::Pair* StorageFindOrInsert(ImGuiStorage* storage, const ImGuiStorage::Pair& pair)
+{
+    if (!storage->HashIndexed)
+    {
+        ImVector<ImGuiStorage::Pair>::iterator it = LowerBound(storage->Data, pair.key);
+        if (it == storage->Data.end() || it->key != pair.key)
+            it = storage->Data.insert(it, pair);
+        return it;
+    }
+    if (ImGuiStorage::Pair* existing = StorageFind(storage, pair.key))
+        return existing;
+    if ((storage->Data.Size + 1) * 10 > storage->HashIndex.Size * 7)
+        StorageHashRebuild(storage, storage->Data.Size + 1);
+    storage->Data.push_back(pair);
+    StorageHashInsertSlot(storage, pair.key, storage->Data.Size - 1);
+    return &storage->Data.back();
+}
+
+// Switching to the hash index keeps Data as is, switching back sorts it.
+void ImGuiStorage::SetHashIndexed(bool enabled)
+{
+    if (HashIndexed == enabled)
+        return;
+    HashIndexed = enabled;
+    if (enabled)
+    {
+        StorageHashRebuild(this, Data.Size);
+    }
+    else
+    {
+        HashIndex.clear();
+        BuildSortByKey();
+    }
+}
+
 // For quicker full rebuild of a storage (instead of an incremental one), you may add all your contents and then sort once.
 void ImGuiStorage::BuildSortByKey()
 {
@@ -1727,14 +1916,14 @@ void ImGuiStorage::BuildSortByKey()
     };
     if (Data.Size > 1)
         ImQsort(Data.Data, (size_t)Data.Size, sizeof(Pair), StaticFunc::PairCompareByID);
+    if (HashIndexed)
+        StorageHashRebuild(this, Data.Size);
 }
 
 int ImGuiStorage::GetInt(ImGuiID key, int default_val) const
 {
-    ImVector<Pair>::iterator it = LowerBound(const_cast<ImVector<ImGuiStorage::Pair>&>(Data), key);
-    if (it == Data.end() || it->key != key)
-        return default_val;
-    return it->val_i;
+    const Pair* it = StorageFind(this, key);
+    return it ? it->val_i : default_val;
 }
 
 bool ImGuiStorage::GetBool(ImGuiID key, bool default_val) const
@@ -1744,27 +1933,20 @@ bool ImGuiStorage::GetBool(ImGuiID key, bool default_val) const
 
 float ImGuiStorage::GetFloat(ImGuiID key, float default_val) const
 {
-    ImVector<Pair>::iterator it = LowerBound(const_cast<ImVector<ImGuiStorage::Pair>&>(Data), key);
-    if (it == Data.end() || it->key != key)
-        return default_val;
-    return it->val_f;
+    const Pair* it = StorageFind(this, key);
+    return it ? it->val_f : default_val;
 }
 
 void* ImGuiStorage::GetVoidPtr(ImGuiID key) const
 {
-    ImVector<Pair>::iterator it = LowerBound(const_cast<ImVector<ImGuiStorage::Pair>&>(Data), key);
-    if (it == Data.end() || it->key != key)
-        return NULL;
-    return it->val_p;
+    const Pair* it = StorageFind(this, key);
+    return it ? it->val_p : NULL;
 }
 
 // References are only valid until a new value is added to the storage. Calling a Set***() function or a Get***Ref() function invalidates the pointer.
 int* ImGuiStorage::GetIntRef(ImGuiID key, int default_val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-        it = Data.insert(it, Pair(key, default_val));
-    return &it->val_i;
+    return &StorageFindOrInsert(this, Pair(key, default_val))->val_i;
 }
 
 bool* ImGuiStorage::GetBoolRef(ImGuiID key, bool default_val)
@@ -1774,30 +1956,18 @@ bool* ImGuiStorage::GetBoolRef(ImGuiID key, bool default_val)
 
 float* ImGuiStorage::GetFloatRef(ImGuiID key, float default_val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-        it = Data.insert(it, Pair(key, default_val));
-    return &it->val_f;
+    return &StorageFindOrInsert(this, Pair(key, default_val))->val_f;
 }
 
 void** ImGuiStorage::GetVoidPtrRef(ImGuiID key, void* default_val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-        it = Data.insert(it, Pair(key, default_val));
-    return &it->val_p;
+    return &StorageFindOrInsert(this, Pair(key, default_val))->val_p;
 }
 
 // FIXME-OPT: Need a way to reuse the result of lower_bound when doing GetInt()/SetInt() - not too bad because it only happens on explicit interaction (maximum one a frame)
 void ImGuiStorage::SetInt(ImGuiID key, int val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-    {
-        Data.insert(it, Pair(key, val));
-        return;
-    }
-    it->val_i = val;
+    StorageFindOrInsert(this, Pair(key, val))->val_i = val;
 }
 
 void ImGuiStorage::SetBool(ImGuiID key, bool val)
@@ -1807,24 +1977,12 @@ void ImGuiStorage::SetBool(ImGuiID key, bool val)
 
 void ImGuiStorage::SetFloat(ImGuiID key, float val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-    {
-        Data.insert(it, Pair(key, val));
-        return;
-    }
-    it->val_f = val;
+    StorageFindOrInsert(this, Pair(key, val))->val_f = val;
 }
 
 void ImGuiStorage::SetVoidPtr(ImGuiID key, void* val)
 {
-    ImVector<Pair>::iterator it = LowerBound(Data, key);
-    if (it == Data.end() || it->key != key)
-    {
-        Data.insert(it, Pair(key, val));
-        return;
-    }
-    it->val_p = val;
+    StorageFindOrInsert(this, Pair(key, val))->val_p = val;
 }
 
 void ImGuiStorage::SetAllInt(int v)
@@ -2125,7 +2283,13 @@ void ImGui::RenderTextWrapped(ImVec2 pos, const char* text, const char* text_end
 
     if (text != text_end)
     {
-        window->DrawList->AddText(g.Font, g.FontSize, pos, GetColorU32(ImGuiCol_Text), text, text_end, wrap_width);
+        // Reuse the line breaks found when the text was measured: TextWrapped() always calls CalcTextSize() first
+        const ImGuiTextLayout* layout = (wrap_width > 0.0f) ? TextLayoutCacheFind(g, g.Font, g.FontSize, wrap_width, text, text_end) : NULL;
+        const ImU32 col = GetColorU32(ImGuiCol_Text);
+        if (layout && (col & IM_COL32_A_MASK) != 0)
+            g.Font->RenderText(window->DrawList, g.FontSize, pos, col, window->DrawList->_ClipRectStack.back(), text, text_end, wrap_width, false, layout->LineBreaks.Data, layout->LineBreaks.Size);
+        else if (!layout)
+            window->DrawList->AddText(g.Font, g.FontSize, pos, col, text, text_end, wrap_width);
         if (g.LogEnabled)
             LogRenderedText(&pos, text, text_end);
     }
@@ -2339,6 +2503,7 @@ ImGuiWindow::ImGuiWindow(ImGuiContext* context, const char* name)
     ItemWidthDefault = 0.0f;
     FontWindowScale = 1.0f;
     SettingsIdx = -1;
+    WindowsIdx = -1;
 
     DrawList = &DrawListInst;
     DrawList->_OwnerName = Name;
@@ -3091,6 +3256,7 @@ void ImGui::NewFrame()
     IM_ASSERT(g.IO.Fonts->Fonts.Size > 0                                && "Font Atlas not built. Did you call io.Fonts->GetTexDataAsRGBA32() / GetTexDataAsAlpha8() ?");
     IM_ASSERT(g.IO.Fonts->Fonts[0]->IsLoaded()                          && "Font Atlas not built. Did you call io.Fonts->GetTexDataAsRGBA32() / GetTexDataAsAlpha8() ?");
     IM_ASSERT(g.Style.CurveTessellationTol > 0.0f                       && "Invalid style setting");
+    IM_ASSERT(g.Style.CircleSegmentMaxError > 0.0f                      && "Invalid style setting");
     IM_ASSERT(g.Style.Alpha >= 0.0f && g.Style.Alpha <= 1.0f            && "Invalid style setting. Alpha cannot be negative (allows us to avoid a few clamps in color computations)");
     IM_ASSERT((g.FrameCount == 0 || g.FrameCountEnded == g.FrameCount)  && "Forgot to call Render() or EndFrame() at the end of the previous frame?");
     for (int n = 0; n < ImGuiKey_COUNT; n++)
@@ -3129,6 +3295,9 @@ void ImGui::NewFrame()
 
     g.Time += g.IO.DeltaTime;
     g.FrameScopeActive = true;
+    g.TextLayoutCache.LastFrameHits = g.TextLayoutCache.FrameHits;
+    g.TextLayoutCache.LastFrameMisses = g.TextLayoutCache.FrameMisses;
+    g.TextLayoutCache.FrameHits = g.TextLayoutCache.FrameMisses = 0;
     g.FrameCount += 1;
     g.TooltipOverrideCount = 0;
     g.WindowsActiveCount = 0;
@@ -3139,11 +3308,14 @@ void ImGui::NewFrame()
     IM_ASSERT(g.Font->IsLoaded());
     g.DrawListSharedData.ClipRectFullscreen = ImVec4(0.0f, 0.0f, g.IO.DisplaySize.x, g.IO.DisplaySize.y);
     g.DrawListSharedData.CurveTessellationTol = g.Style.CurveTessellationTol;
+    g.DrawListSharedData.SetCircleSegmentMaxError(g.Style.CircleSegmentMaxError);
 
     g.OverlayDrawList.Clear();
     g.OverlayDrawList.PushTextureID(g.IO.Fonts->TexID);
     g.OverlayDrawList.PushClipRectFullScreen();
     g.OverlayDrawList.Flags = (g.Style.AntiAliasedLines ? ImDrawListFlags_AntiAliasedLines : 0) | (g.Style.AntiAliasedFill ? ImDrawListFlags_AntiAliasedFill : 0);
+    if (g.IO.BackendFlags & ImGuiBackendFlags_RendererHasVtxOffset)
+        g.OverlayDrawList.Flags |= ImDrawListFlags_AllowVtxOffset;
 
     // Mark rendering data as invalid to prevent user who may have a handle on it to use it
     g.DrawData.Clear();
@@ -3288,6 +3460,7 @@ void ImGui::Shutdown(ImGuiContext* context)
         IM_DELETE(g.Windows[i]);
     g.Windows.clear();
     g.WindowsSortBuffer.clear();
+    g.WindowsNavFocusable.clear();
     g.CurrentWindow = NULL;
     g.CurrentWindowStack.clear();
     g.WindowsById.Clear();
@@ -3303,14 +3476,19 @@ void ImGui::Shutdown(ImGuiContext* context)
     g.CurrentPopupStack.clear();
     g.DrawDataBuilder.ClearFreeMemory();
     g.OverlayDrawList.ClearFreeMemory();
+    g.TextLayoutCache.ClearFreeMemory();
     g.PrivateClipboard.clear();
     g.InputTextState.TextW.clear();
+    g.InputTextState.TextA.clear();
+    g.InputTextState.LinesBeforeGap.clear();
+    g.InputTextState.LinesAfterGap.clear();
     g.InputTextState.InitialText.clear();
     g.InputTextState.TempBuffer.clear();
 
     for (int i = 0; i < g.SettingsWindows.Size; i++)
         IM_DELETE(g.SettingsWindows[i].Name);
     g.SettingsWindows.clear();
+    g.SettingsWindowsIdx.Clear();
     g.SettingsHandlers.clear();
 
     if (g.LogFile && g.LogFile != stdout)
@@ -3369,12 +3547,14 @@ static void AddDrawListToDrawData(ImVector<ImDrawList*>* out_list, ImDrawList* d
     // Draw list sanity check. Detect mismatch between PrimReserve() calls and incrementing _VtxCurrentIdx, _VtxWritePtr etc. May trigger for you if you are using PrimXXX functions incorrectly.
     IM_ASSERT(draw_list->VtxBuffer.Size == 0 || draw_list->_VtxWritePtr == draw_list->VtxBuffer.Data + draw_list->VtxBuffer.Size);
     IM_ASSERT(draw_list->IdxBuffer.Size == 0 || draw_list->_IdxWritePtr == draw_list->IdxBuffer.Data + draw_list->IdxBuffer.Size);
-    IM_ASSERT((int)draw_list->_VtxCurrentIdx == draw_list->VtxBuffer.Size);
+    IM_ASSERT((int)(draw_list->_VtxCurrentOffset + draw_list->_VtxCurrentIdx) == draw_list->VtxBuffer.Size);
 
-    // Check that draw_list doesn't use more vertices than indexable (default ImDrawIdx = unsigned short = 2 bytes = 64K vertices per ImDrawList = per window)
+    // Check that draw_list doesn't use more vertices than indexable (default ImDrawIdx = unsigned short = 2 bytes = 64K vertices per ImDrawList = per window, unless the renderer supports VtxOffset)
     // If this assert triggers because you are drawing lots of stuff manually:
     // A) Make sure you are coarse clipping, because ImDrawList let all your vertices pass. You can use the Metrics window to inspect draw list contents.
-    // B) If you need/want meshes with more than 64K vertices, uncomment the '#define ImDrawIdx unsigned int' line in imconfig.h to set the index size to 4 bytes.
+    // B) If your renderer can offset the vertices of a draw call (see ImDrawCmd::VtxOffset), set io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset.
+    //    Draw lists then start a new command when they go past 64K vertices and this only triggers for a single primitive larger than that.
+    //    Otherwise, uncomment the '#define ImDrawIdx unsigned int' line in imconfig.h to set the index size to 4 bytes.
     //    You'll need to handle the 4-bytes indices to your renderer. For example, the OpenGL example code detect index size at compile-time by doing:
     //      glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, idx_buffer_offset);
     //    Your own engine or render API may use different parameters or function calls to specify index sizes. 2 and 4 bytes indices are generally supported by most API.
@@ -3550,6 +3730,9 @@ void ImGui::EndFrame()
 
     IM_ASSERT(g.Windows.Size == g.WindowsSortBuffer.Size);  // we done something wrong
     g.Windows.swap(g.WindowsSortBuffer);
+
+    g.WindowsIdxDirty = true;
+    UpdateWindowsIdx(g);
     g.IO.MetricsActiveWindows = g.WindowsActiveCount;
 
     // Unlock font atlas
@@ -3620,12 +3803,43 @@ ImVec2 ImGui::CalcTextSize(const char* text, const char* text_end, bool hide_tex
         text_display_end = FindRenderedTextEnd(text, text_end);      // Hide anything after a '##' string
     else
         text_display_end = text_end;
+    if (!text_display_end)
+        text_display_end = text + strlen(text);                       // The cache key and the cached length need the actual end
 
     ImFont* font = g.Font;
     const float font_size = g.FontSize;
     if (text == text_display_end)
         return ImVec2(0.0f, font_size);
-    ImVec2 text_size = font->CalcTextSizeA(font_size, FLT_MAX, wrap_width, text, text_display_end, NULL);
+
+    // Most labels are measured every frame (and often twice), cache the longer ones
+    const int text_length = (int)(text_display_end - text);
+    if (IMGUI_TEXT_LAYOUT_CACHE_SIZE > 0 && (text_length >= IMGUI_TEXT_LAYOUT_CACHE_MIN_LENGTH || wrap_width > 0.0f))
+    {
+        ImGuiTextLayoutCache& cache = g.TextLayoutCache;
+        if (cache.FontGeneration != GImFontLookupGeneration)
+        {
+            cache.Clear();
+            cache.FontGeneration = GImFontLookupGeneration;
+        }
+        const ImGuiID key = TextLayoutKey(font, font_size, wrap_width, text, text_display_end);
+        if (ImGuiTextLayout* layout = cache.Find(key, font, font_size, wrap_width, text_length, g.FrameCount))
+        {
+            cache.FrameHits++;
+            return layout->Size;
+        }
+        cache.FrameMisses++;
+        if (ImGuiTextLayout* layout = cache.Add(key, font, font_size, wrap_width, text_length, g.FrameCount))
+        {
+            layout->Size = CalcTextSizeUncached(font, font_size, wrap_width, text, text_display_end, (wrap_width > 0.0f) ? &layout->LineBreaks : NULL);
+            return layout->Size;
+        }
+    }
+    return CalcTextSizeUncached(font, font_size, wrap_width, text, text_display_end, NULL);
+}
+
+static ImVec2 CalcTextSizeUncached(ImFont* font, float font_size, float wrap_width, const char* text, const char* text_end, ImVector<int>* out_line_breaks)
+{
+    ImVec2 text_size = font->CalcTextSizeA(font_size, FLT_MAX, wrap_width, text, text_end, NULL, out_line_breaks);
 
     // Cancel out character spacing for the last character of a line (it is baked into glyph->AdvanceX field)
     const float font_scale = font_size / font->FontSize;
@@ -3637,6 +3851,145 @@ ImVec2 ImGui::CalcTextSize(const char* text, const char* text_end, bool hide_tex
     return text_size;
 }
 
+// The seed makes different fonts, sizes and wrap widths unlikely to collide, Find() compares them anyway.
+static ImGuiID TextLayoutKey(ImFont* font, float font_size, float wrap_width, const char* text, const char* text_end)
+{
+    struct { ImFont* Font; float FontSize; float WrapWidth; } seed_data;
+    memset(&seed_data, 0, sizeof(seed_data));
+    seed_data.Font = font;
+    seed_data.FontSize = font_size;
+    seed_data.WrapWidth = wrap_width;
+    return ImHash(text, (int)(text_end - text), ImHash(&seed_data, (int)sizeof(seed_data), 0));
+}
+
+// Lookup only, for the rendering side. NULL if the text wasn't measured with CalcTextSize() this frame or the previous ones.
+static const ImGuiTextLayout* TextLayoutCacheFind(ImGuiContext& g, ImFont* font, float font_size, float wrap_width, const char* text, const char* text_end)
+{
+    ImGuiTextLayoutCache& cache = g.TextLayoutCache;
+    if (cache.Count == 0 || cache.FontGeneration != GImFontLookupGeneration)
+        return NULL;
+    return cache.Find(TextLayoutKey(font, font_size, wrap_width, text, text_end), font, font_size, wrap_width, (int)(text_end - text), g.FrameCount);
+}
+
+static void TextLayoutCacheUnlink(ImGuiTextLayoutCache* cache, int idx)
+{
+    ImGuiTextLayout& layout = cache->Entries[idx];
+    if (layout.LruPrev != -1) cache->Entries[layout.LruPrev].LruNext = layout.LruNext; else cache->LruHead = layout.LruNext;
+    if (layout.LruNext != -1) cache->Entries[layout.LruNext].LruPrev = layout.LruPrev; else cache->LruTail = layout.LruPrev;
+}
+
+static void TextLayoutCacheLinkFront(ImGuiTextLayoutCache* cache, int idx)
+{
+    ImGuiTextLayout& layout = cache->Entries[idx];
+    layout.LruPrev = -1;
+    layout.LruNext = cache->LruHead;
+    if (cache->LruHead != -1) cache->Entries[cache->LruHead].LruPrev = idx; else cache->LruTail = idx;
+    cache->LruHead = idx;
+}
+
+void ImGuiTextLayoutCache::Clear()
+{
+    for (int n = 0; n < Count; n++)
+        Entries[n].LineBreaks.resize(0);
+    for (int n = 0; n < Slots.Size; n++)
+        Slots[n] = -1;
+    Count = 0;
+    LruHead = LruTail = -1;
+}
+
+void ImGuiTextLayoutCache::ClearFreeMemory()
+{
+    for (int n = 0; n < Entries.Size; n++)
+        Entries[n].LineBreaks.clear();
+    Entries.clear();
+    Slots.clear();
+    Count = 0;
+    LruHead = LruTail = -1;
+}
+
+ImGuiTextLayout* ImGuiTextLayoutCache::Find(ImGuiID key, ImFont* font, float font_size, float wrap_width, int text_length, int frame_count)
+{
+    if (Slots.Size == 0)
+        return NULL;
+    const int mask = Slots.Size - 1;
+    for (int slot = (int)(key & mask); Slots[slot] != -1; slot = (slot + 1) & mask)
+    {
+        const int idx = Slots[slot];
+        ImGuiTextLayout& layout = Entries[idx];
+        if (layout.Key != key || layout.TextLength != text_length || layout.Font != font || layout.FontSize != font_size || layout.WrapWidth != wrap_width)
+            continue;
+        if (LruHead != idx)
+        {
+            TextLayoutCacheUnlink(this, idx);
+            TextLayoutCacheLinkFront(this, idx);
+        }
+        layout.LastFrameUsed = frame_count;
+        return &layout;
+    }
+    return NULL;
+}
+
+ImGuiTextLayout* ImGuiTextLayoutCache::Add(ImGuiID key, ImFont* font, float font_size, float wrap_width, int text_length, int frame_count)
+{
+    if (Entries.Size == 0)
+    {
+        // Entries own heap memory (LineBreaks) and ImVector<> doesn't construct: allocate once and zero-fill
+        Entries.resize(IMGUI_TEXT_LAYOUT_CACHE_SIZE);
+        memset(Entries.Data, 0, (size_t)Entries.Size * sizeof(ImGuiTextLayout));
+        int slots_count = 16;
+        while (slots_count < Entries.Size * 2)
+            slots_count <<= 1;
+        Slots.resize(slots_count, -1);
+    }
+
+    const int mask = Slots.Size - 1;
+    int idx;
+    if (Count < Entries.Size)
+    {
+        idx = Count++;
+    }
+    else
+    {
+        // Evict the least recently used entry, unless the whole cache is needed by this frame: thrashing it would only add hashing work
+        idx = LruTail;
+        if (Entries[idx].LastFrameUsed == frame_count)
+            return NULL;
+        TextLayoutCacheUnlink(this, idx);
+
+        // Backward shift deletion, keeps probe sequences intact without tombstones
+        int slot = (int)(Entries[idx].Key & mask);
+        while (Slots[slot] != idx)
+            slot = (slot + 1) & mask;
+        for (int next = (slot + 1) & mask; Slots[next] != -1; next = (next + 1) & mask)
+        {
+            const int home = (int)(Entries[Slots[next]].Key & mask);
+            if (((next - home) & mask) >= ((next - slot) & mask))
+            {
+                Slots[slot] = Slots[next];
+                slot = next;
+            }
+        }
+        Slots[slot] = -1;
+    }
+
+    ImGuiTextLayout& layout = Entries[idx];
+    layout.Key = key;
+    layout.Font = font;
+    layout.FontSize = font_size;
+    layout.WrapWidth = wrap_width;
+    layout.TextLength = text_length;
+    layout.Size = ImVec2(0.0f, 0.0f);
+    layout.LineBreaks.resize(0);
+    layout.LastFrameUsed = frame_count;
+    TextLayoutCacheLinkFront(this, idx);
+
+    int slot = (int)(key & mask);
+    while (Slots[slot] != -1)
+        slot = (slot + 1) & mask;
+    Slots[slot] = idx;
+    return &layout;
+}
+
 // Helper to calculate coarse clipping of large list of evenly sized items.
 // NB: Prefer using the ImGuiListClipper higher-level helper if you can! Read comments and instructions there on how those use this sort of pattern.
 // NB: 'items_count' is only used to clamp the result, if you don't know your count you can use INT_MAX
@@ -4200,9 +4553,16 @@ static ImGuiWindow* CreateNewWindow(const char* name, ImVec2 size, ImGuiWindowFl
     }
 
     if (flags & ImGuiWindowFlags_NoBringToFrontOnFocus)
+    {
+        window->WindowsIdx = g.Windows.empty() ? 0 : g.Windows.front()->WindowsIdx - 1;
         g.Windows.insert(g.Windows.begin(), window); // Quite slow but rare and only once
+        g.WindowsIdxDirty = true;
+    }
     else
+    {
+        window->WindowsIdx = g.Windows.empty() ? 0 : g.Windows.back()->WindowsIdx + 1;
         g.Windows.push_back(window);
+    }
     return window;
 }
 
@@ -4797,6 +5157,8 @@ bool ImGui::Begin(const char* name, bool* p_open, ImGuiWindowFlags flags)
         // Setup draw list and outer clipping rectangle
         window->DrawList->Clear();
         window->DrawList->Flags = (g.Style.AntiAliasedLines ? ImDrawListFlags_AntiAliasedLines : 0) | (g.Style.AntiAliasedFill ? ImDrawListFlags_AntiAliasedFill : 0);
+        if (g.IO.BackendFlags & ImGuiBackendFlags_RendererHasVtxOffset)
+            window->DrawList->Flags |= ImDrawListFlags_AllowVtxOffset;
         window->DrawList->PushTextureID(g.Font->ContainerAtlas->TexID);
         ImRect viewport_rect(GetViewportRect());
         if ((flags & ImGuiWindowFlags_ChildWindow) && !(flags & ImGuiWindowFlags_Popup) && !window_is_child_tooltip)
@@ -5120,19 +5482,73 @@ void ImGui::End()
     SetCurrentWindow(g.CurrentWindowStack.empty() ? NULL : g.CurrentWindowStack.back());
 }
 
+// Index of the first window of 'windows' (sorted like g.Windows) with a WindowsIdx >= 'windows_idx'
+static int LowerBoundWindowsIdx(const ImVector<ImGuiWindow*>& windows, int windows_idx)
+{
+    int lo = 0, hi = windows.Size;
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (windows[mid]->WindowsIdx < windows_idx) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+// Reindexing writes to every window, which are scattered in memory: it is deferred until an index is needed, moves only shift pointers.
+static void UpdateWindowsIdx(ImGuiContext& g)
+{
+    if (!g.WindowsIdxDirty)
+        return;
+    g.WindowsNavFocusable.resize(0);
+    for (int i = 0; i != g.Windows.Size; i++)
+    {
+        ImGuiWindow* window = g.Windows[i];
+        window->WindowsIdx = i;
+        if (ImGui::IsWindowNavFocusable(window))
+            g.WindowsNavFocusable.push_back(window);
+    }
+    g.WindowsIdxDirty = false;
+}
+
+// While g.WindowsIdxDirty is set WindowsIdx are only increasing along g.Windows (with gaps), which is enough for a binary search.
+static int FindWindowIndexFromSortKey(ImGuiContext& g, ImGuiWindow* window)
+{
+    if (!g.WindowsIdxDirty)
+        return window->WindowsIdx;
+    const int i = LowerBoundWindowsIdx(g.Windows, window->WindowsIdx);
+    IM_ASSERT(i < g.Windows.Size && g.Windows[i] == window);
+    return i;
+}
+
+// Moves g.Windows[src] to the front or the back of g.Windows, shifting the windows in between.
+// Only the moved window gets a new WindowsIdx (one past the front or back one), the others keep theirs until UpdateWindowsIdx().
+static void MoveWindowInWindows(ImGuiContext& g, int src, int dst)
+{
+    IM_ASSERT(src >= 0 && src < g.Windows.Size && (dst == 0 || dst == g.Windows.Size - 1));
+    ImGuiWindow* window = g.Windows[src];
+    if (src == dst)
+        return;
+    if (src < dst)
+    {
+        memmove(&g.Windows[src], &g.Windows[src + 1], (size_t)(dst - src) * sizeof(ImGuiWindow*));
+        window->WindowsIdx = g.Windows[dst - 1]->WindowsIdx + 1;
+    }
+    else
+    {
+        memmove(&g.Windows[dst + 1], &g.Windows[dst], (size_t)(src - dst) * sizeof(ImGuiWindow*));
+        window->WindowsIdx = g.Windows[dst + 1]->WindowsIdx - 1;
+    }
+    g.Windows[dst] = window;
+    g.WindowsIdxDirty = true;
+}
+
 void ImGui::BringWindowToFront(ImGuiWindow* window)
 {
     ImGuiContext& g = *GImGui;
     ImGuiWindow* current_front_window = g.Windows.back();
     if (current_front_window == window || current_front_window->RootWindow == window)
         return;
-    for (int i = g.Windows.Size - 2; i >= 0; i--) // We can ignore the front most window
-        if (g.Windows[i] == window)
-        {
-            g.Windows.erase(g.Windows.Data + i);
-            g.Windows.push_back(window);
-            break;
-        }
+    MoveWindowInWindows(g, FindWindowIndexFromSortKey(g, window), g.Windows.Size - 1);
 }
 
 void ImGui::BringWindowToBack(ImGuiWindow* window)
@@ -5140,13 +5556,7 @@ void ImGui::BringWindowToBack(ImGuiWindow* window)
     ImGuiContext& g = *GImGui;
     if (g.Windows[0] == window)
         return;
-    for (int i = 0; i < g.Windows.Size; i++)
-        if (g.Windows[i] == window)
-        {
-            memmove(&g.Windows[1], &g.Windows[0], (size_t)i * sizeof(ImGuiWindow*));
-            g.Windows[0] = window;
-            break;
-        }
+    MoveWindowInWindows(g, FindWindowIndexFromSortKey(g, window), 0);
 }
 
 // Moving window to front of display and set focus (which happens to be back of our sorted list)
@@ -7431,22 +7841,29 @@ static float ImGui::NavUpdatePageUpPageDown(int allowed_dir_flags)
     return 0.0f;
 }
 
-static int FindWindowIndex(ImGuiWindow* window) // FIXME-OPT O(N)
+static int FindWindowIndex(ImGuiWindow* window)
 {
     ImGuiContext& g = *GImGui;
-    for (int i = g.Windows.Size-1; i >= 0; i--)
-        if (g.Windows[i] == window)
-            return i;
-    return -1;
+    UpdateWindowsIdx(g);
+    return window->WindowsIdx;
 }
 
-static ImGuiWindow* FindWindowNavFocusable(int i_start, int i_stop, int dir) // FIXME-OPT O(N)
+// First nav focusable window met going from g.Windows[i_start] in direction 'dir', stopping before g.Windows[i_stop].
+// A binary search in the list of nav focusable windows, rebuilt with the window indices (at the end of the frame, or here after windows were moved).
+static ImGuiWindow* FindWindowNavFocusable(int i_start, int i_stop, int dir)
 {
     ImGuiContext& g = *GImGui;
-    for (int i = i_start; i >= 0 && i < g.Windows.Size && i != i_stop; i += dir)
-        if (ImGui::IsWindowNavFocusable(g.Windows[i]))
-            return g.Windows[i];
-    return NULL;
+    UpdateWindowsIdx(g);
+    const ImVector<ImGuiWindow*>& nav_windows = g.WindowsNavFocusable;
+    int n = LowerBoundWindowsIdx(nav_windows, i_start);
+    if (dir < 0 && (n == nav_windows.Size || nav_windows[n]->WindowsIdx > i_start))
+        n--;
+    if (n < 0 || n >= nav_windows.Size)
+        return NULL;
+    const int i = nav_windows[n]->WindowsIdx;
+    if (dir > 0 ? (i_stop >= i_start && i_stop <= i) : (i_stop <= i_start && i_stop >= i))
+        return NULL;
+    return nav_windows[n];
 }
 
 static void NavUpdateWindowingHighlightWindow(int focus_change_dir)
@@ -8453,16 +8870,15 @@ static ImGuiWindowSettings* CreateNewWindowSettings(const char* name)
     ImGuiWindowSettings* settings = &g.SettingsWindows.back();
     settings->Name = ImStrdup(name);
     settings->ID = ImHash(name, 0);
+    g.SettingsWindowsIdx.SetInt(settings->ID, g.SettingsWindows.Size - 1);
     return settings;
 }
 
 ImGuiWindowSettings* ImGui::FindWindowSettings(ImGuiID id)
 {
     ImGuiContext& g = *GImGui;
-    for (int i = 0; i != g.SettingsWindows.Size; i++)
-        if (g.SettingsWindows[i].ID == id)
-            return &g.SettingsWindows[i];
-    return NULL;
+    int idx = g.SettingsWindowsIdx.GetInt(id, -1);
+    return (idx != -1) ? &g.SettingsWindows[idx] : NULL;
 }
 
 void ImGui::LoadIniSettingsFromDisk(const char* ini_filename)
@@ -8774,6 +9190,8 @@ void ImGui::ShowMetricsWindow(bool* p_open)
     ImGui::Text("%d vertices, %d indices (%d triangles)", io.MetricsRenderVertices, io.MetricsRenderIndices, io.MetricsRenderIndices / 3);
     ImGui::Text("%d active windows (%d visible)", io.MetricsActiveWindows, io.MetricsRenderWindows);
     ImGui::Text("%d allocations", io.MetricsActiveAllocations);
+    const ImGuiTextLayoutCache& text_layout_cache = GImGui->TextLayoutCache;
+    ImGui::Text("Text layout cache: %d hits, %d misses (%d/%d entries)", text_layout_cache.LastFrameHits, text_layout_cache.LastFrameMisses, text_layout_cache.Count, IMGUI_TEXT_LAYOUT_CACHE_SIZE);
     ImGui::Checkbox("Show clipping rectangles when hovering draw commands", &show_draw_cmd_clip_rects);
     ImGui::Checkbox("Ctrl shows window begin order", &show_window_begin_order);
 
@@ -8815,7 +9233,7 @@ void ImGui::ShowMetricsWindow(bool* p_open)
                     ImRect clip_rect = pcmd->ClipRect;
                     ImRect vtxs_rect;
                     for (int i = elem_offset; i < elem_offset + (int)pcmd->ElemCount; i++)
-                        vtxs_rect.Add(draw_list->VtxBuffer[idx_buffer ? idx_buffer[i] : i].pos);
+                        vtxs_rect.Add(draw_list->VtxBuffer[idx_buffer ? pcmd->VtxOffset + idx_buffer[i] : i].pos);
                     clip_rect.Floor(); overlay_draw_list->AddRect(clip_rect.Min, clip_rect.Max, IM_COL32(255,255,0,255));
                     vtxs_rect.Floor(); overlay_draw_list->AddRect(vtxs_rect.Min, vtxs_rect.Max, IM_COL32(255,0,255,255));
                 }
@@ -8832,7 +9250,7 @@ void ImGui::ShowMetricsWindow(bool* p_open)
                         ImVec2 triangles_pos[3];
                         for (int n = 0; n < 3; n++, vtx_i++)
                         {
-                            ImDrawVert& v = draw_list->VtxBuffer[idx_buffer ? idx_buffer[vtx_i] : vtx_i];
+                            ImDrawVert& v = draw_list->VtxBuffer[idx_buffer ? pcmd->VtxOffset + idx_buffer[vtx_i] : vtx_i];
                             triangles_pos[n] = v.pos;
                             buf_p += ImFormatString(buf_p, (int)(buf_end - buf_p), "%s %04d: pos (%8.2f,%8.2f), uv (%.6f,%.6f), col %08X\n", (n == 0) ? "vtx" : "   ", vtx_i, v.pos.x, v.pos.y, v.uv.x, v.uv.y, v.col);
                         }
@@ -8897,7 +9315,7 @@ void ImGui::ShowMetricsWindow(bool* p_open)
                 }
                 ImGui::TreePop();
             }
-            ImGui::BulletText("Storage: %d bytes", window->StateStorage.Data.Size * (int)sizeof(ImGuiStorage::Pair));
+            ImGui::BulletText("Storage: %d bytes", window->StateStorage.Data.Size * (int)sizeof(ImGuiStorage::Pair) + window->StateStorage.HashIndex.Size * (int)sizeof(ImGuiStorage::HashSlot));
             ImGui::TreePop();
         }
     };
@@ -64,6 +64,7 @@ struct ImDrawChannel;               // Temporary storage for outputting drawing
 struct ImDrawCmd;                   // A single draw command within a parent ImDrawList (generally maps to 1 GPU draw call)
 struct ImDrawData;                  // All draw command lists required to render the frame
 struct ImDrawList;                  // A single draw command list (generally one per window, conceptually you may see this as a dynamic "mesh" builder)
+struct ImDrawListBlock;             // Retained geometry recorded from a draw list, appended to draw lists again without tessellating it
 struct ImDrawListSharedData;        // Data shared among multiple draw lists (typically owned by parent ImGui context, but you may create one yourself)
 struct ImDrawVert;                  // A single vertex (20 bytes by default, override layout with IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT)
 struct ImFont;                      // Runtime data for a single font within a parent ImFontAtlas
@@ -869,7 +870,8 @@ enum ImGuiBackendFlags_
 {
     ImGuiBackendFlags_HasGamepad            = 1 << 0,   // Back-end supports gamepad and currently has one connected.
     ImGuiBackendFlags_HasMouseCursors       = 1 << 1,   // Back-end supports honoring GetMouseCursor() value to change the OS cursor shape.
-    ImGuiBackendFlags_HasSetMousePos        = 1 << 2    // Back-end supports io.WantSetMousePos requests to reposition the OS mouse position (only used if ImGuiConfigFlags_NavEnableSetMousePos is set).
+    ImGuiBackendFlags_HasSetMousePos        = 1 << 2,   // Back-end supports io.WantSetMousePos requests to reposition the OS mouse position (only used if ImGuiConfigFlags_NavEnableSetMousePos is set).
+    ImGuiBackendFlags_RendererHasVtxOffset  = 1 << 3    // Back-end renderer supports ImDrawCmd::VtxOffset. This enables output of large meshes (64K+ vertices) while still using 16-bit indices.
 };
 
 // Enumeration for PushStyleColor() / PopStyleColor()
@@ -1067,6 +1069,7 @@ struct ImGuiStyle
     bool        AntiAliasedLines;           // Enable anti-aliasing on lines/borders. Disable if you are really tight on CPU/GPU.
     bool        AntiAliasedFill;            // Enable anti-aliasing on filled shapes (rounded rectangles, circles, etc.)
     float       CurveTessellationTol;       // Tessellation tolerance when using PathBezierCurveTo() without a specific number of segments. Decrease for highly tessellated curves (higher quality, more polygons), increase to reduce quality.
+    float       CircleSegmentMaxError;      // Maximum error (in pixels) allowed when using AddCircle()/AddCircleFilled()/PathArcTo() without a specific number of segments, and for rounded corners. Decrease for smoother circles (more polygons), increase to reduce quality.
     ImVec4      Colors[ImGuiCol_COUNT];
 
     IMGUI_API ImGuiStyle();
@@ -1391,12 +1394,28 @@ struct ImGuiStorage
         Pair(ImGuiID _key, float _val_f) { key = _key; val_f = _val_f; }
         Pair(ImGuiID _key, void* _val_p) { key = _key; val_p = _val_p; }
     };
+    struct HashSlot
+    {
+        ImGuiID key;
+        int     index;                  // Index into Data, -1 for an empty slot
+    };
     ImVector<Pair>      Data;
+    ImVector<HashSlot>  HashIndex;      // Open-addressing table (linear probing), only used when HashIndexed is set
+    bool                HashIndexed;
+
+#ifdef IMGUI_STORAGE_HASH_INDEXED
+    ImGuiStorage()      { HashIndexed = true; }
+#else
+    ImGuiStorage()      { HashIndexed = false; }
+#endif
 
     // - Get***() functions find pair, never add/allocate. Pairs are sorted so a query is O(log N)
     // - Set***() functions find pair, insertion on demand if missing.
     // - Sorted insertion is costly, paid once. A typical frame shouldn't need to insert any new pair.
-    void                Clear() { Data.clear(); }
+    // - With a hash index, Data is kept in insertion order instead and both queries and insertions are O(1) on average.
+    //   Worth it for storages holding many thousands of keys (e.g. huge trees), otherwise the sorted vector is smaller and just as fast.
+    void                Clear() { Data.clear(); HashIndex.clear(); }
+    IMGUI_API void      SetHashIndexed(bool enabled);
     IMGUI_API int       GetInt(ImGuiID key, int default_val = 0) const;
     IMGUI_API void      SetInt(ImGuiID key, int val);
     IMGUI_API bool      GetBool(ImGuiID key, bool default_val = false) const;
@@ -1419,6 +1438,7 @@ struct ImGuiStorage
     IMGUI_API void      SetAllInt(int val);
 
     // For quicker full rebuild of a storage (instead of an incremental one), you may add all your contents and then sort once.
+    // (With a hash index, this sorts Data and rebuilds the index.)
     IMGUI_API void      BuildSortByKey();
 };
 
@@ -1580,8 +1600,9 @@ struct ImDrawCmd
     ImTextureID     TextureId;              // User-provided texture ID. Set by user in ImfontAtlas::SetTexID() for fonts or passed to Image*() functions. Ignore if never using images or multiple fonts atlas.
     ImDrawCallback  UserCallback;           // If != NULL, call the function instead of rendering the vertices. clip_rect and texture_id will be set normally.
     void*           UserCallbackData;       // The draw callback code can access this.
+    unsigned int    VtxOffset;              // Start offset in vertex buffer, add it to every index of the command. Always 0 unless the back-end sets ImGuiBackendFlags_RendererHasVtxOffset, then lists past 64K vertices with 16-bit indices start new commands with VtxOffset > 0.
 
-    ImDrawCmd() { ElemCount = 0; ClipRect.x = ClipRect.y = ClipRect.z = ClipRect.w = 0.0f; TextureId = NULL; UserCallback = NULL; UserCallbackData = NULL; }
+    ImDrawCmd() { ElemCount = 0; ClipRect.x = ClipRect.y = ClipRect.z = ClipRect.w = 0.0f; TextureId = NULL; UserCallback = NULL; UserCallbackData = NULL; VtxOffset = 0; }
 };
 
 // Vertex index (override with '#define ImDrawIdx unsigned int' inside in imconfig.h)
@@ -1613,6 +1634,38 @@ struct ImDrawChannel
     ImVector<ImDrawIdx>     IdxBuffer;
 };
 
+// Retained geometry, for static content (grids, axis ticks, diagrams) that would otherwise be tessellated again every frame.
+// Primitives drawn between ImDrawList::BeginBlock() and EndBlock() are moved into the block instead of being drawn, ImDrawList::AddBlock() then appends a copy
+// of them (translated if you want) to any draw list, in this frame and later ones. Nothing invalidates a block for you: call Invalidate() when what it shows
+// changes (or the font atlas is rebuilt) and record it again.
+struct ImDrawListBlockCmd
+{
+    unsigned int            ElemCount;          // Number of indices, relative to the first vertex of the command
+    unsigned int            VtxCount;           // Number of vertices, they follow those of the previous command in VtxBuffer
+    ImTextureID             TextureId;
+};
+
+struct ImDrawListBlock
+{
+    ImVector<ImDrawListBlockCmd> CmdBuffer;
+    ImVector<ImDrawIdx>     IdxBuffer;
+    ImVector<ImDrawVert>    VtxBuffer;
+    ImVec2                  BoundsMin;          // Bounding box of VtxBuffer, AddBlock() skips blocks entirely outside of the clip rect
+    ImVec2                  BoundsMax;
+    bool                    Valid;              // Set by EndBlock(), cleared by Invalidate()/Clear()
+
+    // [Internal] draw list state when recording began, restored by EndBlock()
+    ImDrawCmd               _Cmd;
+    int                     _CmdIndex;
+    int                     _IdxStart;
+    unsigned int            _VtxCurrentOffset;
+    unsigned int            _VtxCurrentIdx;
+
+    ImDrawListBlock()       { BoundsMin = BoundsMax = ImVec2(0.0f, 0.0f); Valid = false; _CmdIndex = _IdxStart = 0; _VtxCurrentOffset = _VtxCurrentIdx = 0; }
+    void Invalidate()       { Valid = false; }                                                          // Record again, reusing the buffers
+    void Clear()            { CmdBuffer.clear(); IdxBuffer.clear(); VtxBuffer.clear(); Valid = false; } // Invalidate and free the buffers
+};
+
 enum ImDrawCornerFlags_
 {
     ImDrawCornerFlags_TopLeft   = 1 << 0, // 0x1
@@ -1629,7 +1682,8 @@ enum ImDrawCornerFlags_
 enum ImDrawListFlags_
 {
     ImDrawListFlags_AntiAliasedLines = 1 << 0,
-    ImDrawListFlags_AntiAliasedFill  = 1 << 1
+    ImDrawListFlags_AntiAliasedFill  = 1 << 1,
+    ImDrawListFlags_AllowVtxOffset   = 1 << 2   // Can emit 'VtxOffset > 0' to allow large meshes. Set when 'ImGuiBackendFlags_RendererHasVtxOffset' is enabled.
 };
 
 // Draw command list
@@ -1649,7 +1703,8 @@ struct ImDrawList
     // [Internal, used while building lists]
     const ImDrawListSharedData* _Data;          // Pointer to shared draw data (you can use ImGui::GetDrawListSharedData() to get the one from current ImGui context)
     const char*             _OwnerName;         // Pointer to owner window's name for debugging
-    unsigned int            _VtxCurrentIdx;     // [Internal] == VtxBuffer.Size
+    unsigned int            _VtxCurrentOffset;  // [Internal] VtxOffset of the current command, == VtxBuffer.Size - _VtxCurrentIdx
+    unsigned int            _VtxCurrentIdx;     // [Internal] == VtxBuffer.Size unless the list went past 64K vertices with 16-bit indices, then it restarts from 0 at _VtxCurrentOffset
     ImDrawVert*             _VtxWritePtr;       // [Internal] point within VtxBuffer.Data after each add command (to avoid using the ImVector<> operators too much)
     ImDrawIdx*              _IdxWritePtr;       // [Internal] point within IdxBuffer.Data after each add command (to avoid using the ImVector<> operators too much)
     ImVector<ImVec4>        _ClipRectStack;     // [Internal]
@@ -1658,6 +1713,7 @@ struct ImDrawList
     int                     _ChannelsCurrent;   // [Internal] current channel number (0)
     int                     _ChannelsCount;     // [Internal] number of active channels (1+)
     ImVector<ImDrawChannel> _Channels;          // [Internal] draw channels for columns API (not resized down so _ChannelsCount may be smaller than _Channels.Size)
+    ImDrawListBlock*        _Block;             // [Internal] block being recorded, between BeginBlock() and EndBlock()
 
     // If you want to create ImDrawList instances, pass them ImGui::GetDrawListSharedData() or create and use your own ImDrawListSharedData (so you can use ImDrawList without ImGui)
     ImDrawList(const ImDrawListSharedData* shared_data) { _Data = shared_data; _OwnerName = NULL; Clear(); }
@@ -1679,8 +1735,8 @@ struct ImDrawList
     IMGUI_API void  AddQuadFilled(const ImVec2& a, const ImVec2& b, const ImVec2& c, const ImVec2& d, ImU32 col);
     IMGUI_API void  AddTriangle(const ImVec2& a, const ImVec2& b, const ImVec2& c, ImU32 col, float thickness = 1.0f);
     IMGUI_API void  AddTriangleFilled(const ImVec2& a, const ImVec2& b, const ImVec2& c, ImU32 col);
-    IMGUI_API void  AddCircle(const ImVec2& centre, float radius, ImU32 col, int num_segments = 12, float thickness = 1.0f);
-    IMGUI_API void  AddCircleFilled(const ImVec2& centre, float radius, ImU32 col, int num_segments = 12);
+    IMGUI_API void  AddCircle(const ImVec2& centre, float radius, ImU32 col, int num_segments = 0, float thickness = 1.0f);                       // num_segments = 0: picked from the radius and style.CircleSegmentMaxError
+    IMGUI_API void  AddCircleFilled(const ImVec2& centre, float radius, ImU32 col, int num_segments = 0);
     IMGUI_API void  AddText(const ImVec2& pos, ImU32 col, const char* text_begin, const char* text_end = NULL);
     IMGUI_API void  AddText(const ImFont* font, float font_size, const ImVec2& pos, ImU32 col, const char* text_begin, const char* text_end = NULL, float wrap_width = 0.0f, const ImVec4* cpu_fine_clip_rect = NULL);
     IMGUI_API void  AddImage(ImTextureID user_texture_id, const ImVec2& a, const ImVec2& b, const ImVec2& uv_a = ImVec2(0,0), const ImVec2& uv_b = ImVec2(1,1), ImU32 col = 0xFFFFFFFF);
@@ -1689,6 +1745,7 @@ struct ImDrawList
     IMGUI_API void  AddPolyline(const ImVec2* points, const int num_points, ImU32 col, bool closed, float thickness);
     IMGUI_API void  AddConvexPolyFilled(const ImVec2* points, const int num_points, ImU32 col); // Note: Anti-aliased filling requires points to be in clockwise order.
     IMGUI_API void  AddBezierCurve(const ImVec2& pos0, const ImVec2& cp0, const ImVec2& cp1, const ImVec2& pos1, ImU32 col, float thickness, int num_segments = 0);
+    IMGUI_API void  AddBezierCurves(const ImVec2* points, int curves_count, ImU32 col, float thickness, int num_segments = 0);                      // Separate curves, 4 points each (pos0, cp0, cp1, pos1), e.g. the wires of a node graph
 
     // Stateful path API, add points then finish with PathFillConvex() or PathStroke()
     inline    void  PathClear()                                                 { _Path.resize(0); }
@@ -1696,9 +1753,10 @@ struct ImDrawList
     inline    void  PathLineToMergeDuplicate(const ImVec2& pos)                 { if (_Path.Size == 0 || memcmp(&_Path[_Path.Size-1], &pos, 8) != 0) _Path.push_back(pos); }
     inline    void  PathFillConvex(ImU32 col)                                   { AddConvexPolyFilled(_Path.Data, _Path.Size, col); PathClear(); }  // Note: Anti-aliased filling requires points to be in clockwise order.
     inline    void  PathStroke(ImU32 col, bool closed, float thickness = 1.0f)  { AddPolyline(_Path.Data, _Path.Size, col, closed, thickness); PathClear(); }
-    IMGUI_API void  PathArcTo(const ImVec2& centre, float radius, float a_min, float a_max, int num_segments = 10);
+    IMGUI_API void  PathArcTo(const ImVec2& centre, float radius, float a_min, float a_max, int num_segments = 0);                                   // num_segments = 0: picked from the radius and style.CircleSegmentMaxError
     IMGUI_API void  PathArcToFast(const ImVec2& centre, float radius, int a_min_of_12, int a_max_of_12);                                            // Use precomputed angles for a 12 steps circle
     IMGUI_API void  PathBezierCurveTo(const ImVec2& p1, const ImVec2& p2, const ImVec2& p3, int num_segments = 0);
+    IMGUI_API void  PathBezierCurvesTo(const ImVec2* points, int curves_count, int num_segments = 0);                                                // Chained curves from the last point, 3 points each (cp0, cp1, pos1)
     IMGUI_API void  PathRect(const ImVec2& rect_min, const ImVec2& rect_max, float rounding = 0.0f, int rounding_corners_flags = ImDrawCornerFlags_All);
 
     // Channels
@@ -1708,6 +1766,13 @@ struct ImDrawList
     IMGUI_API void  ChannelsMerge();
     IMGUI_API void  ChannelsSetCurrent(int channel_index);
 
+    // Retained geometry (see ImDrawListBlock)
+    // - Primitives between BeginBlock() and EndBlock() are recorded into the block rather than drawn. Clip rects pushed in between are ignored, AddBlock() uses the current one. Keep pushes balanced.
+    // - AddBlock() appends the recorded vertices and indices with a copy, moved by 'offset'. Recording may use AddBlock() to nest other blocks.
+    IMGUI_API void  BeginBlock(ImDrawListBlock* block);
+    IMGUI_API void  EndBlock();
+    IMGUI_API void  AddBlock(const ImDrawListBlock* block, const ImVec2& offset = ImVec2(0, 0));
+
     // Advanced
     IMGUI_API void  AddCallback(ImDrawCallback callback, void* callback_data);  // Your rendering function must check for 'UserCallback' in ImDrawCmd and call the function instead of rendering triangles.
     IMGUI_API void  AddDrawCmd();                                               // This is useful if you need to forcefully create a new draw call (to allow for dependent rendering / blending). Otherwise primitives are merged into the same draw-call as much as possible
@@ -1947,10 +2012,11 @@ struct ImFont
 
     // 'max_width' stops rendering after a certain width (could be turned into a 2d size). FLT_MAX to disable.
     // 'wrap_width' enable automatic word-wrapping across multiple lines to fit into given width. 0.0f to disable.
-    IMGUI_API ImVec2            CalcTextSizeA(float size, float max_width, float wrap_width, const char* text_begin, const char* text_end = NULL, const char** remaining = NULL) const; // utf8
+    // 'out_line_breaks' receives the word-wrapping end of each line (offsets from text_begin), RenderText() can reuse them for the same text, size and wrap_width.
+    IMGUI_API ImVec2            CalcTextSizeA(float size, float max_width, float wrap_width, const char* text_begin, const char* text_end = NULL, const char** remaining = NULL, ImVector<int>* out_line_breaks = NULL) const; // utf8
     IMGUI_API const char*       CalcWordWrapPositionA(float scale, const char* text, const char* text_end, float wrap_width) const;
     IMGUI_API void              RenderChar(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col, unsigned short c) const;
-    IMGUI_API void              RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col, const ImVec4& clip_rect, const char* text_begin, const char* text_end, float wrap_width = 0.0f, bool cpu_fine_clip = false) const;
+    IMGUI_API void              RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col, const ImVec4& clip_rect, const char* text_begin, const char* text_end, float wrap_width = 0.0f, bool cpu_fine_clip = false, const int* line_breaks = NULL, int line_breaks_count = 0) const;
 
     // [Internal]
     IMGUI_API void              GrowIndex(int new_size);
@@ -327,6 +327,7 @@ ImDrawListSharedData::ImDrawListSharedData()
     Font = NULL;
     FontSize = 0.0f;
     CurveTessellationTol = 0.0f;
+    CircleSegmentMaxError = 0.0f;
     ClipRectFullscreen = ImVec4(-8192.0f, -8192.0f, +8192.0f, +8192.0f);
 
     // Const data
@@ -335,6 +336,30 @@ ImDrawListSharedData::ImDrawListSharedData()
         const float a = ((float)i * 2 * IM_PI) / (float)IM_ARRAYSIZE(CircleVtx12);
         CircleVtx12[i] = ImVec2(ImCos(a), ImSin(a));
     }
+    for (int n = 0; n < IM_ARRAYSIZE(CircleVtxTableOffsets); n++)
+        CircleVtxTableOffsets[n] = -1;
+    for (int num_segments = IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MIN; num_segments <= IM_DRAWLIST_CIRCLE_TABLE_SEGMENT_MAX; num_segments += 4)
+    {
+        const int offset = CircleVtxTableOffsets[num_segments >> 2] = CircleVtxTables.Size;
+        CircleVtxTables.resize(offset + num_segments);
+        for (int i = 0; i < num_segments; i++)
+        {
+            const float a = ((float)i * 2 * IM_PI) / (float)num_segments;
+            CircleVtxTables[offset + i] = ImVec2(ImCos(a), ImSin(a));
+        }
+    }
+    SetCircleSegmentMaxError(0.30f);
+}
+
+void ImDrawListSharedData::SetCircleSegmentMaxError(float max_error)
+{
+    IM_ASSERT(max_error > 0.0f);
+    if (CircleSegmentMaxError == max_error)
+        return;
+    CircleSegmentMaxError = max_error;
+    CircleSegmentCounts[0] = IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MIN;
+    for (int i = 1; i < IM_ARRAYSIZE(CircleSegmentCounts); i++)
+        CircleSegmentCounts[i] = (unsigned short)IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_CALC((float)i, max_error);
 }
 
 void ImDrawList::Clear()
@@ -343,6 +368,7 @@ void ImDrawList::Clear()
     IdxBuffer.resize(0);
     VtxBuffer.resize(0);
     Flags = ImDrawListFlags_AntiAliasedLines | ImDrawListFlags_AntiAliasedFill;
+    _VtxCurrentOffset = 0;
     _VtxCurrentIdx = 0;
     _VtxWritePtr = NULL;
     _IdxWritePtr = NULL;
@@ -351,6 +377,7 @@ void ImDrawList::Clear()
     _Path.resize(0);
     _ChannelsCurrent = 0;
     _ChannelsCount = 1;
+    _Block = NULL;
     // NB: Do not clear channels so our allocations are re-used after the first frame.
 }
 
@@ -359,6 +386,7 @@ void ImDrawList::ClearFreeMemory()
     CmdBuffer.clear();
     IdxBuffer.clear();
     VtxBuffer.clear();
+    _VtxCurrentOffset = 0;
     _VtxCurrentIdx = 0;
     _VtxWritePtr = NULL;
     _IdxWritePtr = NULL;
@@ -367,6 +395,7 @@ void ImDrawList::ClearFreeMemory()
     _Path.clear();
     _ChannelsCurrent = 0;
     _ChannelsCount = 1;
+    _Block = NULL;
     for (int i = 0; i < _Channels.Size; i++)
     {
         if (i == 0) memset(&_Channels[0], 0, sizeof(_Channels[0]));  // channel 0 is a copy of CmdBuffer/IdxBuffer, don't destruct again
@@ -395,6 +424,7 @@ void ImDrawList::AddDrawCmd()
     ImDrawCmd draw_cmd;
     draw_cmd.ClipRect = GetCurrentClipRect();
     draw_cmd.TextureId = GetCurrentTextureId();
+    draw_cmd.VtxOffset = _VtxCurrentOffset;
 
     IM_ASSERT(draw_cmd.ClipRect.x <= draw_cmd.ClipRect.z && draw_cmd.ClipRect.y <= draw_cmd.ClipRect.w);
     CmdBuffer.push_back(draw_cmd);
@@ -421,18 +451,21 @@ void ImDrawList::UpdateClipRect()
     // If current command is used with different settings we need to add a new command
     const ImVec4 curr_clip_rect = GetCurrentClipRect();
     ImDrawCmd* curr_cmd = CmdBuffer.Size > 0 ? &CmdBuffer.Data[CmdBuffer.Size-1] : NULL;
-    if (!curr_cmd || (curr_cmd->ElemCount != 0 && memcmp(&curr_cmd->ClipRect, &curr_clip_rect, sizeof(ImVec4)) != 0) || curr_cmd->UserCallback != NULL)
+    if (!curr_cmd || (curr_cmd->ElemCount != 0 && (memcmp(&curr_cmd->ClipRect, &curr_clip_rect, sizeof(ImVec4)) != 0 || curr_cmd->VtxOffset != _VtxCurrentOffset)) || curr_cmd->UserCallback != NULL)
     {
         AddDrawCmd();
         return;
     }
 
-    // Try to merge with previous command if it matches, else use current command
-    ImDrawCmd* prev_cmd = CmdBuffer.Size > 1 ? curr_cmd - 1 : NULL;
-    if (curr_cmd->ElemCount == 0 && prev_cmd && memcmp(&prev_cmd->ClipRect, &curr_clip_rect, sizeof(ImVec4)) == 0 && prev_cmd->TextureId == GetCurrentTextureId() && prev_cmd->UserCallback == NULL)
+    // Try to merge with previous command if it matches, else use current command (a block being recorded needs the command it started in)
+    ImDrawCmd* prev_cmd = (CmdBuffer.Size > 1 && (_Block == NULL || CmdBuffer.Size - 1 > _Block->_CmdIndex)) ? curr_cmd - 1 : NULL;
+    if (curr_cmd->ElemCount == 0 && prev_cmd && memcmp(&prev_cmd->ClipRect, &curr_clip_rect, sizeof(ImVec4)) == 0 && prev_cmd->TextureId == GetCurrentTextureId() && prev_cmd->VtxOffset == _VtxCurrentOffset && prev_cmd->UserCallback == NULL)
         CmdBuffer.pop_back();
     else
+    {
         curr_cmd->ClipRect = curr_clip_rect;
+        curr_cmd->VtxOffset = _VtxCurrentOffset;
+    }
 }
 
 void ImDrawList::UpdateTextureID()
@@ -440,18 +473,21 @@ void ImDrawList::UpdateTextureID()
     // If current command is used with different settings we need to add a new command
     const ImTextureID curr_texture_id = GetCurrentTextureId();
     ImDrawCmd* curr_cmd = CmdBuffer.Size ? &CmdBuffer.back() : NULL;
-    if (!curr_cmd || (curr_cmd->ElemCount != 0 && curr_cmd->TextureId != curr_texture_id) || curr_cmd->UserCallback != NULL)
+    if (!curr_cmd || (curr_cmd->ElemCount != 0 && (curr_cmd->TextureId != curr_texture_id || curr_cmd->VtxOffset != _VtxCurrentOffset)) || curr_cmd->UserCallback != NULL)
     {
         AddDrawCmd();
         return;
     }
 
-    // Try to merge with previous command if it matches, else use current command
-    ImDrawCmd* prev_cmd = CmdBuffer.Size > 1 ? curr_cmd - 1 : NULL;
-    if (curr_cmd->ElemCount == 0 && prev_cmd && prev_cmd->TextureId == curr_texture_id && memcmp(&prev_cmd->ClipRect, &GetCurrentClipRect(), sizeof(ImVec4)) == 0 && prev_cmd->UserCallback == NULL)
+    // Try to merge with previous command if it matches, else use current command (a block being recorded needs the command it started in)
+    ImDrawCmd* prev_cmd = (CmdBuffer.Size > 1 && (_Block == NULL || CmdBuffer.Size - 1 > _Block->_CmdIndex)) ? curr_cmd - 1 : NULL;
+    if (curr_cmd->ElemCount == 0 && prev_cmd && prev_cmd->TextureId == curr_texture_id && memcmp(&prev_cmd->ClipRect, &GetCurrentClipRect(), sizeof(ImVec4)) == 0 && prev_cmd->VtxOffset == _VtxCurrentOffset && prev_cmd->UserCallback == NULL)
         CmdBuffer.pop_back();
     else
+    {
         curr_cmd->TextureId = curr_texture_id;
+        curr_cmd->VtxOffset = _VtxCurrentOffset;
+    }
 }
 
 #undef GetCurrentClipRect
@@ -529,6 +565,7 @@ void ImDrawList::ChannelsSplit(int channels_count)
             ImDrawCmd draw_cmd;
             draw_cmd.ClipRect = _ClipRectStack.back();
             draw_cmd.TextureId = _TextureIdStack.back();
+            draw_cmd.VtxOffset = _VtxCurrentOffset;
             _Channels[i].CmdBuffer.push_back(draw_cmd);
         }
     }
@@ -578,11 +615,164 @@ void ImDrawList::ChannelsSetCurrent(int idx)
     memcpy(&CmdBuffer, &_Channels.Data[_ChannelsCurrent].CmdBuffer, sizeof(CmdBuffer));
     memcpy(&IdxBuffer, &_Channels.Data[_ChannelsCurrent].IdxBuffer, sizeof(IdxBuffer));
     _IdxWritePtr = IdxBuffer.Data + IdxBuffer.Size;
+
+    // Another channel may have moved the list to a new vertex offset (see PrimReserve), the indices we write next are relative to it
+    ImDrawCmd* curr_cmd = CmdBuffer.Size ? &CmdBuffer.Data[CmdBuffer.Size-1] : NULL;
+    if (curr_cmd && curr_cmd->VtxOffset != _VtxCurrentOffset)
+    {
+        if (curr_cmd->ElemCount == 0 && curr_cmd->UserCallback == NULL)
+            curr_cmd->VtxOffset = _VtxCurrentOffset;
+        else
+            AddDrawCmd();
+    }
+}
+
+// Don't switch channels while recording, the block is taken from the current channel's buffers.
+void ImDrawList::BeginBlock(ImDrawListBlock* block)
+{
+    IM_ASSERT(_Block == NULL && "Already recording a block, call EndBlock() first");
+    IM_ASSERT(CmdBuffer.Size > 0);
+    _Block = block;
+    block->CmdBuffer.resize(0);
+    block->IdxBuffer.resize(0);
+    block->VtxBuffer.resize(0);
+    block->Valid = false;
+    block->_Cmd = CmdBuffer.Data[CmdBuffer.Size-1];
+    block->_CmdIndex = CmdBuffer.Size - 1;
+    block->_IdxStart = IdxBuffer.Size;
+    block->_VtxCurrentOffset = _VtxCurrentOffset;
+    block->_VtxCurrentIdx = _VtxCurrentIdx;
+}
+
+void ImDrawList::EndBlock()
+{
+    ImDrawListBlock* block = _Block;
+    IM_ASSERT(block != NULL && "Call BeginBlock() first");
+    IM_ASSERT(CmdBuffer.Size > block->_CmdIndex);
+    const unsigned int vtx_start = block->_VtxCurrentOffset + block->_VtxCurrentIdx;
+
+    // One block command for each draw command that got indices since BeginBlock(). Their vertices are copied in order, and the indices made
+    // relative to the first one (draw commands count from VtxOffset, and may have started before the block).
+    block->IdxBuffer.resize(IdxBuffer.Size - block->_IdxStart);
+    const ImDrawIdx* idx_read = IdxBuffer.Data + block->_IdxStart;
+    ImDrawIdx* idx_write = block->IdxBuffer.Data;
+    for (int cmd_n = block->_CmdIndex; cmd_n < CmdBuffer.Size; cmd_n++)
+    {
+        const ImDrawCmd& cmd = CmdBuffer.Data[cmd_n];
+        IM_ASSERT(cmd.UserCallback == NULL && "Callbacks can't be recorded in a block");
+        const unsigned int elem_count = (cmd_n == block->_CmdIndex) ? cmd.ElemCount - block->_Cmd.ElemCount : cmd.ElemCount;
+        if (elem_count == 0)
+            continue;
+
+        unsigned int idx_min = idx_read[0], idx_max = idx_read[0];
+        for (unsigned int i = 1; i < elem_count; i++)
+        {
+            idx_min = ImMin(idx_min, (unsigned int)idx_read[i]);
+            idx_max = ImMax(idx_max, (unsigned int)idx_read[i]);
+        }
+        IM_ASSERT(cmd.VtxOffset + idx_min >= vtx_start);
+        for (unsigned int i = 0; i < elem_count; i++)
+            idx_write[i] = (ImDrawIdx)(idx_read[i] - idx_min);
+
+        ImDrawListBlockCmd block_cmd;
+        block_cmd.ElemCount = elem_count;
+        block_cmd.VtxCount = idx_max - idx_min + 1;
+        block_cmd.TextureId = cmd.TextureId;
+        block->CmdBuffer.push_back(block_cmd);
+        const int block_vtx_size = block->VtxBuffer.Size;
+        block->VtxBuffer.resize(block_vtx_size + (int)block_cmd.VtxCount);
+        memcpy(block->VtxBuffer.Data + block_vtx_size, VtxBuffer.Data + cmd.VtxOffset + idx_min, block_cmd.VtxCount * sizeof(ImDrawVert));
+        idx_read += elem_count;
+        idx_write += elem_count;
+    }
+
+    block->BoundsMin = block->BoundsMax = block->VtxBuffer.Size ? block->VtxBuffer.Data[0].pos : ImVec2(0.0f, 0.0f);
+    for (int i = 1; i < block->VtxBuffer.Size; i++)
+    {
+        const ImVec2& pos = block->VtxBuffer.Data[i].pos;
+        block->BoundsMin = ImMin(block->BoundsMin, pos);
+        block->BoundsMax = ImMax(block->BoundsMax, pos);
+    }
+    block->Valid = true;
+
+    // Put the list back as it was before BeginBlock()
+    CmdBuffer.resize(block->_CmdIndex + 1);
+    CmdBuffer.Data[block->_CmdIndex] = block->_Cmd;
+    IdxBuffer.resize(block->_IdxStart);
+    VtxBuffer.resize((int)vtx_start);
+    _VtxCurrentOffset = block->_VtxCurrentOffset;
+    _VtxCurrentIdx = block->_VtxCurrentIdx;
+    _VtxWritePtr = VtxBuffer.Data + VtxBuffer.Size;
+    _IdxWritePtr = IdxBuffer.Data + IdxBuffer.Size;
+    _Block = NULL;
+}
+
+void ImDrawList::AddBlock(const ImDrawListBlock* block, const ImVec2& offset)
+{
+    IM_ASSERT(block->Valid && "Record the block with BeginBlock()/EndBlock() first");
+    IM_ASSERT(block != _Block);
+    if (block->CmdBuffer.Size == 0)
+        return;
+
+    // Coarse clipping of the whole block
+    const ImVec4& clip_rect = _ClipRectStack.Size ? _ClipRectStack.Data[_ClipRectStack.Size-1] : _Data->ClipRectFullscreen;
+    if (block->BoundsMin.x + offset.x > clip_rect.z || block->BoundsMin.y + offset.y > clip_rect.w || block->BoundsMax.x + offset.x < clip_rect.x || block->BoundsMax.y + offset.y < clip_rect.y)
+        return;
+
+    const bool translate = (offset.x != 0.0f || offset.y != 0.0f);
+    const ImDrawIdx* idx_read = block->IdxBuffer.Data;
+    const ImDrawVert* vtx_read = block->VtxBuffer.Data;
+    for (int cmd_n = 0; cmd_n < block->CmdBuffer.Size; cmd_n++)
+    {
+        const ImDrawListBlockCmd& cmd = block->CmdBuffer.Data[cmd_n];
+        const bool push_texture_id = (cmd.TextureId != (_TextureIdStack.Size ? _TextureIdStack.Data[_TextureIdStack.Size-1] : NULL));
+        if (push_texture_id)
+            PushTextureID(cmd.TextureId);
+        PrimReserve((int)cmd.ElemCount, (int)cmd.VtxCount);
+
+        // Indices are copied as they are when the command starts at our first vertex, vertices when they don't move
+        const unsigned int idx_base = _VtxCurrentIdx;
+        if (idx_base == 0)
+            memcpy(_IdxWritePtr, idx_read, cmd.ElemCount * sizeof(ImDrawIdx));
+        else
+            for (unsigned int i = 0; i < cmd.ElemCount; i++)
+                _IdxWritePtr[i] = (ImDrawIdx)(idx_read[i] + idx_base);
+        if (!translate)
+            memcpy(_VtxWritePtr, vtx_read, cmd.VtxCount * sizeof(ImDrawVert));
+        else
+            for (unsigned int i = 0; i < cmd.VtxCount; i++)
+            {
+                _VtxWritePtr[i] = vtx_read[i];
+                _VtxWritePtr[i].pos.x += offset.x;
+                _VtxWritePtr[i].pos.y += offset.y;
+            }
+        _IdxWritePtr += cmd.ElemCount;
+        _VtxWritePtr += cmd.VtxCount;
+        _VtxCurrentIdx += cmd.VtxCount;
+        idx_read += cmd.ElemCount;
+        vtx_read += cmd.VtxCount;
+
+        if (push_texture_id)
+            PopTextureID();
+    }
 }
 
 // NB: this can be called with negative count for removing primitives (as long as the result does not underflow)
 void ImDrawList::PrimReserve(int idx_count, int vtx_count)
 {
+    // Large mesh support: once 16-bit indices can't address the new vertices, continue in a new command whose indices start over from VtxOffset
+    // (a single primitive still has to fit in 64K vertices, AddPolyline() splits longer lines itself)
+    if (sizeof(ImDrawIdx) == 2 && (_VtxCurrentIdx + vtx_count >= (1 << 16)) && (Flags & ImDrawListFlags_AllowVtxOffset))
+    {
+        _VtxCurrentOffset = VtxBuffer.Size;
+        _VtxCurrentIdx = 0;
+        ImDrawCmd* curr_cmd = &CmdBuffer.Data[CmdBuffer.Size-1];
+        if (curr_cmd->ElemCount == 0 && curr_cmd->UserCallback == NULL)
+            curr_cmd->VtxOffset = _VtxCurrentOffset;
+        else
+            AddDrawCmd();
+    }
+
     ImDrawCmd& draw_cmd = CmdBuffer.Data[CmdBuffer.Size-1];
     draw_cmd.ElemCount += idx_count;
 
@@ -640,6 +830,170 @@ void ImDrawList::PrimQuadUV(const ImVec2& a, const ImVec2& b, const ImVec2& c, c
     _IdxWritePtr += 6;
 }
 
+// Polyline and convex fill tessellation helpers. Normals and their averages are computed for a block of points at a time, 4 or 8
+// at once with SIMD, and kept as separate x and y arrays. The SIMD code does the same operations in the same order as the scalar
+// loops (no reciprocal estimates, no fused multiply-add), so every path outputs bit identical vertices.
+#define IM_POLYLINE_BLOCK_SIZE  256
+
+// Normal of each segment points[i] -> points[i+1] for i in [0, count), reads points[count].
+static void ImPolylineComputeNormals(const ImVec2* points, int count, float* out_nx, float* out_ny)
+{
+    int i = 0;
+#if defined(IMGUI_ENABLE_AVX2)
+    const __m256 zero8 = _mm256_setzero_ps();
+    const __m256 one8 = _mm256_set1_ps(1.0f);
+    for (; i + 8 <= count; i += 8)
+    {
+        // Segment differences of 8 points (x y interleaved), then split into x and y. Shuffles work within 128-bit lanes: put the 64-bit pairs back in order after.
+        const float* p = &points[i].x;
+        const __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(p + 2), _mm256_loadu_ps(p));
+        const __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(p + 10), _mm256_loadu_ps(p + 8));
+        const __m256 dx = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(d0, d1, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0)));
+        const __m256 dy = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(d0, d1, _MM_SHUFFLE(3, 1, 3, 1))), _MM_SHUFFLE(3, 1, 2, 0)));
+        const __m256 d = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        const __m256 inv_len = _mm256_blendv_ps(one8, _mm256_div_ps(one8, _mm256_sqrt_ps(d)), _mm256_cmp_ps(d, zero8, _CMP_GT_OQ));
+        _mm256_storeu_ps(out_nx + i, _mm256_mul_ps(dy, inv_len));
+        _mm256_storeu_ps(out_ny + i, _mm256_xor_ps(_mm256_mul_ps(dx, inv_len), _mm256_set1_ps(-0.0f)));
+    }
+#endif
+#if defined(IMGUI_ENABLE_SSE2)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        const float* p = &points[i].x;
+        const __m128 d0 = _mm_sub_ps(_mm_loadu_ps(p + 2), _mm_loadu_ps(p));
+        const __m128 d1 = _mm_sub_ps(_mm_loadu_ps(p + 6), _mm_loadu_ps(p + 4));
+        const __m128 dx = _mm_shuffle_ps(d0, d1, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 dy = _mm_shuffle_ps(d0, d1, _MM_SHUFFLE(3, 1, 3, 1));
+        const __m128 d = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        const __m128 mask = _mm_cmpgt_ps(d, zero);
+        const __m128 inv_len = _mm_or_ps(_mm_and_ps(mask, _mm_div_ps(one, _mm_sqrt_ps(d))), _mm_andnot_ps(mask, one));
+        _mm_storeu_ps(out_nx + i, _mm_mul_ps(dy, inv_len));
+        _mm_storeu_ps(out_ny + i, _mm_xor_ps(_mm_mul_ps(dx, inv_len), _mm_set1_ps(-0.0f)));
+    }
+#elif defined(IMGUI_ENABLE_NEON) && defined(__aarch64__)
+    // AArch64 only: ARMv7 NEON has no IEEE division or square root
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        const float32x4x2_t p0 = vld2q_f32(&points[i].x);
+        const float32x4x2_t p1 = vld2q_f32(&points[i + 1].x);
+        const float32x4_t dx = vsubq_f32(p1.val[0], p0.val[0]);
+        const float32x4_t dy = vsubq_f32(p1.val[1], p0.val[1]);
+        const float32x4_t d = vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy));
+        const float32x4_t inv_len = vbslq_f32(vcgtq_f32(d, vdupq_n_f32(0.0f)), vdivq_f32(one, vsqrtq_f32(d)), one);
+        vst1q_f32(out_nx + i, vmulq_f32(dy, inv_len));
+        vst1q_f32(out_ny + i, vnegq_f32(vmulq_f32(dx, inv_len)));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        ImVec2 diff = points[i+1] - points[i];
+        diff *= ImInvLength(diff, 1.0f);
+        out_nx[i] = diff.y;
+        out_ny[i] = -diff.x;
+    }
+}
+
+// Offset of each point i in [0, count) from the normals of the segments before (nx[i]) and after it (nx[i+1]): their average,
+// scaled by 1/length^2 so the edges keep their width at the joint, up to 100x for very sharp angles.
+static void ImPolylineAverageNormals(const float* nx, const float* ny, int count, float* out_dx, float* out_dy)
+{
+    int i = 0;
+#if defined(IMGUI_ENABLE_AVX2)
+    const __m256 half8 = _mm256_set1_ps(0.5f);
+    const __m256 one8 = _mm256_set1_ps(1.0f);
+    const __m256 min_dmr2_8 = _mm256_set1_ps(0.000001f);
+    const __m256 max_scale8 = _mm256_set1_ps(100.0f);
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256 dx = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(nx + i), _mm256_loadu_ps(nx + i + 1)), half8);
+        const __m256 dy = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(ny + i), _mm256_loadu_ps(ny + i + 1)), half8);
+        const __m256 dmr2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        const __m256 mask = _mm256_cmp_ps(dmr2, min_dmr2_8, _CMP_GT_OQ);
+        const __m256 scale = _mm256_min_ps(_mm256_div_ps(one8, dmr2), max_scale8);
+        _mm256_storeu_ps(out_dx + i, _mm256_blendv_ps(dx, _mm256_mul_ps(dx, scale), mask));
+        _mm256_storeu_ps(out_dy + i, _mm256_blendv_ps(dy, _mm256_mul_ps(dy, scale), mask));
+    }
+#endif
+#if defined(IMGUI_ENABLE_SSE2)
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 min_dmr2 = _mm_set1_ps(0.000001f);
+    const __m128 max_scale = _mm_set1_ps(100.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 dx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(nx + i), _mm_loadu_ps(nx + i + 1)), half);
+        const __m128 dy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(ny + i), _mm_loadu_ps(ny + i + 1)), half);
+        const __m128 dmr2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        const __m128 mask = _mm_cmpgt_ps(dmr2, min_dmr2);
+        const __m128 scale = _mm_min_ps(_mm_div_ps(one, dmr2), max_scale);
+        _mm_storeu_ps(out_dx + i, _mm_or_ps(_mm_and_ps(mask, _mm_mul_ps(dx, scale)), _mm_andnot_ps(mask, dx)));
+        _mm_storeu_ps(out_dy + i, _mm_or_ps(_mm_and_ps(mask, _mm_mul_ps(dy, scale)), _mm_andnot_ps(mask, dy)));
+    }
+#elif defined(IMGUI_ENABLE_NEON) && defined(__aarch64__)
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        const float32x4_t dx = vmulq_f32(vaddq_f32(vld1q_f32(nx + i), vld1q_f32(nx + i + 1)), half);
+        const float32x4_t dy = vmulq_f32(vaddq_f32(vld1q_f32(ny + i), vld1q_f32(ny + i + 1)), half);
+        const float32x4_t dmr2 = vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy));
+        const uint32x4_t mask = vcgtq_f32(dmr2, vdupq_n_f32(0.000001f));
+        const float32x4_t scale = vminq_f32(vdivq_f32(one, dmr2), vdupq_n_f32(100.0f));
+        vst1q_f32(out_dx + i, vbslq_f32(mask, vmulq_f32(dx, scale), dx));
+        vst1q_f32(out_dy + i, vbslq_f32(mask, vmulq_f32(dy, scale), dy));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        ImVec2 dm = (ImVec2(nx[i], ny[i]) + ImVec2(nx[i+1], ny[i+1])) * 0.5f;
+        float dmr2 = dm.x*dm.x + dm.y*dm.y;
+        if (dmr2 > 0.000001f)
+        {
+            float scale = 1.0f / dmr2;
+            if (scale > 100.0f) scale = 100.0f;
+            dm *= scale;
+        }
+        out_dx[i] = dm.x;
+        out_dy[i] = dm.y;
+    }
+}
+
+// Normal of the closing segment points[points_count-1] -> points[0], the one before the first point of a closed line.
+static ImVec2 ImPolylineClosingNormal(const ImVec2* points, int points_count)
+{
+    ImVec2 diff = points[0] - points[points_count-1];
+    diff *= ImInvLength(diff, 1.0f);
+    return ImVec2(diff.y, -diff.x);
+}
+
+// Offsets of the points [first, first+count) of a polyline, and the normal of the last segment in 'out_last_n'. 'prev_n' is the normal
+// of the segment ending at points[first] (ignored for the first point of an open line, which is offset by the normal of its segment).
+static void ImPolylineComputeOffsets(const ImVec2* points, int points_count, bool closed, int first, int count, ImVec2 prev_n, float* nx, float* ny, float* out_dx, float* out_dy, ImVec2* out_last_n)
+{
+    // nx[j+1] is the normal of the segment starting at points[first+j], the last segment of the line wraps (closed) or repeats the one before (open)
+    nx[0] = prev_n.x;
+    ny[0] = prev_n.y;
+    const int direct_count = ImMin(first + count, points_count - 1) - first;
+    ImPolylineComputeNormals(points + first, direct_count, nx + 1, ny + 1);
+    if (direct_count < count)
+    {
+        const ImVec2 last_n = closed ? ImPolylineClosingNormal(points, points_count) : ImVec2(nx[count-1], ny[count-1]);
+        nx[count] = last_n.x;
+        ny[count] = last_n.y;
+    }
+
+    ImPolylineAverageNormals(nx, ny, count, out_dx, out_dy);
+    if (first == 0 && !closed)
+    {
+        out_dx[0] = nx[1];
+        out_dy[0] = ny[1];
+    }
+    *out_last_n = ImVec2(nx[count], ny[count]);
+}
+
 // TODO: Thickness anti-aliased lines cap are missing their AA fringe.
 void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32 col, bool closed, float thickness)
 {
@@ -659,163 +1013,147 @@ void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32
         const float AA_SIZE = 1.0f;
         const ImU32 col_trans = col & ~IM_COL32_A_MASK;
 
-        const int idx_count = thick_line ? count*18 : count*12;
-        const int vtx_count = thick_line ? points_count*4 : points_count*3;
-        PrimReserve(idx_count, vtx_count);
-
-        // Temporary buffer
-        ImVec2* temp_normals = (ImVec2*)alloca(points_count * (thick_line ? 5 : 3) * sizeof(ImVec2));
-        ImVec2* temp_points = temp_normals + points_count;
+        const int vtx_stride = thick_line ? 4 : 3;
+        const int idx_stride = thick_line ? 18 : 12;
 
-        for (int i1 = 0; i1 < count; i1++)
-        {
-            const int i2 = (i1+1) == points_count ? 0 : i1+1;
-            ImVec2 diff = points[i2] - points[i1];
-            diff *= ImInvLength(diff, 1.0f);
-            temp_normals[i1].x = diff.y;
-            temp_normals[i1].y = -diff.x;
-        }
-        if (!closed)
-            temp_normals[points_count-1] = temp_normals[points_count-2];
+        // With 16-bit indices and VtxOffset support, a line needing more than 64K vertices is written in pieces small enough to be indexed. A piece
+        // starts with a copy of the vertices the previous one ended with, and the last piece of a split closed line ends with a copy of the first ones.
+        const int piece_max_points = (sizeof(ImDrawIdx) == 2 && (Flags & ImDrawListFlags_AllowVtxOffset)) ? 0xFFFF / vtx_stride : points_count;
+        const bool split = points_count > piece_max_points;
+        const int line_vtx_start = VtxBuffer.Size;
 
-        if (!thick_line)
+        float nx[IM_POLYLINE_BLOCK_SIZE+1], ny[IM_POLYLINE_BLOCK_SIZE+1], dx[IM_POLYLINE_BLOCK_SIZE], dy[IM_POLYLINE_BLOCK_SIZE];
+        const float half_inner_thickness = (thickness - AA_SIZE) * 0.5f;
+        ImVec2 prev_n = closed ? ImPolylineClosingNormal(points, points_count) : ImVec2(0.0f, 0.0f);
+        for (int piece_first = 0; piece_first < points_count; )
         {
-            if (!closed)
+            const int piece_copy_prev = piece_first > 0 ? 1 : 0;
+            int piece_count = ImMin(points_count - piece_first, piece_max_points - piece_copy_prev);
+            if (split && closed && piece_first + piece_count == points_count && piece_copy_prev + piece_count == piece_max_points)
+                piece_count--; // No room left for the closing copy, leave the last point to one more piece
+            const int piece_copy_close = (split && closed && piece_first + piece_count == points_count) ? 1 : 0;
+            const int piece_vtx_points = piece_copy_prev + piece_count + piece_copy_close;
+            const int piece_segments = split ? piece_vtx_points - 1 : count;
+            PrimReserve(piece_segments * idx_stride, piece_vtx_points * vtx_stride);
+
+            if (!thick_line)
             {
-                temp_points[0] = points[0] + temp_normals[0] * AA_SIZE;
-                temp_points[1] = points[0] - temp_normals[0] * AA_SIZE;
-                temp_points[(points_count-1)*2+0] = points[points_count-1] + temp_normals[points_count-1] * AA_SIZE;
-                temp_points[(points_count-1)*2+1] = points[points_count-1] - temp_normals[points_count-1] * AA_SIZE;
-            }
+                unsigned int idx1 = _VtxCurrentIdx;
+                for (int i1 = 0; i1 < piece_segments; i1++)
+                {
+                    unsigned int idx2 = (i1+1) == piece_vtx_points ? _VtxCurrentIdx : idx1+3;
 
-            // FIXME-OPT: Merge the different loops, possibly remove the temporary buffer.
-            unsigned int idx1 = _VtxCurrentIdx;
-            for (int i1 = 0; i1 < count; i1++)
-            {
-                const int i2 = (i1+1) == points_count ? 0 : i1+1;
-                unsigned int idx2 = (i1+1) == points_count ? _VtxCurrentIdx : idx1+3;
+                    // Add indexes
+                    _IdxWritePtr[0] = (ImDrawIdx)(idx2+0); _IdxWritePtr[1] = (ImDrawIdx)(idx1+0); _IdxWritePtr[2] = (ImDrawIdx)(idx1+2);
+                    _IdxWritePtr[3] = (ImDrawIdx)(idx1+2); _IdxWritePtr[4] = (ImDrawIdx)(idx2+2); _IdxWritePtr[5] = (ImDrawIdx)(idx2+0);
+                    _IdxWritePtr[6] = (ImDrawIdx)(idx2+1); _IdxWritePtr[7] = (ImDrawIdx)(idx1+1); _IdxWritePtr[8] = (ImDrawIdx)(idx1+0);
+                    _IdxWritePtr[9] = (ImDrawIdx)(idx1+0); _IdxWritePtr[10]= (ImDrawIdx)(idx2+0); _IdxWritePtr[11]= (ImDrawIdx)(idx2+1);
+                    _IdxWritePtr += 12;
 
-                // Average normals
-                ImVec2 dm = (temp_normals[i1] + temp_normals[i2]) * 0.5f;
-                float dmr2 = dm.x*dm.x + dm.y*dm.y;
-                if (dmr2 > 0.000001f)
-                {
-                    float scale = 1.0f / dmr2;
-                    if (scale > 100.0f) scale = 100.0f;
-                    dm *= scale;
+                    idx1 = idx2;
                 }
-                dm *= AA_SIZE;
-                temp_points[i2*2+0] = points[i2] + dm;
-                temp_points[i2*2+1] = points[i2] - dm;
-
-                // Add indexes
-                _IdxWritePtr[0] = (ImDrawIdx)(idx2+0); _IdxWritePtr[1] = (ImDrawIdx)(idx1+0); _IdxWritePtr[2] = (ImDrawIdx)(idx1+2);
-                _IdxWritePtr[3] = (ImDrawIdx)(idx1+2); _IdxWritePtr[4] = (ImDrawIdx)(idx2+2); _IdxWritePtr[5] = (ImDrawIdx)(idx2+0);
-                _IdxWritePtr[6] = (ImDrawIdx)(idx2+1); _IdxWritePtr[7] = (ImDrawIdx)(idx1+1); _IdxWritePtr[8] = (ImDrawIdx)(idx1+0);
-                _IdxWritePtr[9] = (ImDrawIdx)(idx1+0); _IdxWritePtr[10]= (ImDrawIdx)(idx2+0); _IdxWritePtr[11]= (ImDrawIdx)(idx2+1);
-                _IdxWritePtr += 12;
-
-                idx1 = idx2;
             }
-
-            // Add vertexes
-            for (int i = 0; i < points_count; i++)
+            else
             {
-                _VtxWritePtr[0].pos = points[i];          _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col;
-                _VtxWritePtr[1].pos = temp_points[i*2+0]; _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col_trans;
-                _VtxWritePtr[2].pos = temp_points[i*2+1]; _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = col_trans;
-                _VtxWritePtr += 3;
+                unsigned int idx1 = _VtxCurrentIdx;
+                for (int i1 = 0; i1 < piece_segments; i1++)
+                {
+                    unsigned int idx2 = (i1+1) == piece_vtx_points ? _VtxCurrentIdx : idx1+4;
+
+                    // Add indexes
+                    _IdxWritePtr[0]  = (ImDrawIdx)(idx2+1); _IdxWritePtr[1]  = (ImDrawIdx)(idx1+1); _IdxWritePtr[2]  = (ImDrawIdx)(idx1+2);
+                    _IdxWritePtr[3]  = (ImDrawIdx)(idx1+2); _IdxWritePtr[4]  = (ImDrawIdx)(idx2+2); _IdxWritePtr[5]  = (ImDrawIdx)(idx2+1);
+                    _IdxWritePtr[6]  = (ImDrawIdx)(idx2+1); _IdxWritePtr[7]  = (ImDrawIdx)(idx1+1); _IdxWritePtr[8]  = (ImDrawIdx)(idx1+0);
+                    _IdxWritePtr[9]  = (ImDrawIdx)(idx1+0); _IdxWritePtr[10] = (ImDrawIdx)(idx2+0); _IdxWritePtr[11] = (ImDrawIdx)(idx2+1);
+                    _IdxWritePtr[12] = (ImDrawIdx)(idx2+2); _IdxWritePtr[13] = (ImDrawIdx)(idx1+2); _IdxWritePtr[14] = (ImDrawIdx)(idx1+3);
+                    _IdxWritePtr[15] = (ImDrawIdx)(idx1+3); _IdxWritePtr[16] = (ImDrawIdx)(idx2+3); _IdxWritePtr[17] = (ImDrawIdx)(idx2+2);
+                    _IdxWritePtr += 18;
+
+                    idx1 = idx2;
+                }
             }
-        }
-        else
-        {
-            const float half_inner_thickness = (thickness - AA_SIZE) * 0.5f;
-            if (!closed)
+
+            if (piece_copy_prev)
             {
-                temp_points[0] = points[0] + temp_normals[0] * (half_inner_thickness + AA_SIZE);
-                temp_points[1] = points[0] + temp_normals[0] * (half_inner_thickness);
-                temp_points[2] = points[0] - temp_normals[0] * (half_inner_thickness);
-                temp_points[3] = points[0] - temp_normals[0] * (half_inner_thickness + AA_SIZE);
-                temp_points[(points_count-1)*4+0] = points[points_count-1] + temp_normals[points_count-1] * (half_inner_thickness + AA_SIZE);
-                temp_points[(points_count-1)*4+1] = points[points_count-1] + temp_normals[points_count-1] * (half_inner_thickness);
-                temp_points[(points_count-1)*4+2] = points[points_count-1] - temp_normals[points_count-1] * (half_inner_thickness);
-                temp_points[(points_count-1)*4+3] = points[points_count-1] - temp_normals[points_count-1] * (half_inner_thickness + AA_SIZE);
+                memcpy(_VtxWritePtr, _VtxWritePtr - vtx_stride, vtx_stride * sizeof(ImDrawVert));
+                _VtxWritePtr += vtx_stride;
             }
 
-            // FIXME-OPT: Merge the different loops, possibly remove the temporary buffer.
-            unsigned int idx1 = _VtxCurrentIdx;
-            for (int i1 = 0; i1 < count; i1++)
+            // Add vertexes, a block of points at a time: the offsets of a block are computed together then the vertices written directly
+            for (int first = piece_first; first < piece_first + piece_count; first += IM_POLYLINE_BLOCK_SIZE)
             {
-                const int i2 = (i1+1) == points_count ? 0 : i1+1;
-                unsigned int idx2 = (i1+1) == points_count ? _VtxCurrentIdx : idx1+4;
-
-                // Average normals
-                ImVec2 dm = (temp_normals[i1] + temp_normals[i2]) * 0.5f;
-                float dmr2 = dm.x*dm.x + dm.y*dm.y;
-                if (dmr2 > 0.000001f)
+                const int block_count = ImMin(IM_POLYLINE_BLOCK_SIZE, piece_first + piece_count - first);
+                ImPolylineComputeOffsets(points, points_count, closed, first, block_count, prev_n, nx, ny, dx, dy, &prev_n);
+                const ImVec2* block_points = points + first;
+                if (!thick_line)
+                {
+                    for (int i = 0; i < block_count; i++)
+                    {
+                        const ImVec2 dm = ImVec2(dx[i], dy[i]) * AA_SIZE;
+                        _VtxWritePtr[0].pos = block_points[i];      _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col;
+                        _VtxWritePtr[1].pos = block_points[i] + dm; _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col_trans;
+                        _VtxWritePtr[2].pos = block_points[i] - dm; _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = col_trans;
+                        _VtxWritePtr += 3;
+                    }
+                }
+                else
                 {
-                    float scale = 1.0f / dmr2;
-                    if (scale > 100.0f) scale = 100.0f;
-                    dm *= scale;
+                    for (int i = 0; i < block_count; i++)
+                    {
+                        const ImVec2 dm = ImVec2(dx[i], dy[i]);
+                        const ImVec2 dm_out = dm * (half_inner_thickness + AA_SIZE);
+                        const ImVec2 dm_in = dm * half_inner_thickness;
+                        _VtxWritePtr[0].pos = block_points[i] + dm_out; _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col_trans;
+                        _VtxWritePtr[1].pos = block_points[i] + dm_in;  _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col;
+                        _VtxWritePtr[2].pos = block_points[i] - dm_in;  _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = col;
+                        _VtxWritePtr[3].pos = block_points[i] - dm_out; _VtxWritePtr[3].uv = uv; _VtxWritePtr[3].col = col_trans;
+                        _VtxWritePtr += 4;
+                    }
                 }
-                ImVec2 dm_out = dm * (half_inner_thickness + AA_SIZE);
-                ImVec2 dm_in = dm * half_inner_thickness;
-                temp_points[i2*4+0] = points[i2] + dm_out;
-                temp_points[i2*4+1] = points[i2] + dm_in;
-                temp_points[i2*4+2] = points[i2] - dm_in;
-                temp_points[i2*4+3] = points[i2] - dm_out;
-
-                // Add indexes
-                _IdxWritePtr[0]  = (ImDrawIdx)(idx2+1); _IdxWritePtr[1]  = (ImDrawIdx)(idx1+1); _IdxWritePtr[2]  = (ImDrawIdx)(idx1+2);
-                _IdxWritePtr[3]  = (ImDrawIdx)(idx1+2); _IdxWritePtr[4]  = (ImDrawIdx)(idx2+2); _IdxWritePtr[5]  = (ImDrawIdx)(idx2+1);
-                _IdxWritePtr[6]  = (ImDrawIdx)(idx2+1); _IdxWritePtr[7]  = (ImDrawIdx)(idx1+1); _IdxWritePtr[8]  = (ImDrawIdx)(idx1+0);
-                _IdxWritePtr[9]  = (ImDrawIdx)(idx1+0); _IdxWritePtr[10] = (ImDrawIdx)(idx2+0); _IdxWritePtr[11] = (ImDrawIdx)(idx2+1);
-                _IdxWritePtr[12] = (ImDrawIdx)(idx2+2); _IdxWritePtr[13] = (ImDrawIdx)(idx1+2); _IdxWritePtr[14] = (ImDrawIdx)(idx1+3);
-                _IdxWritePtr[15] = (ImDrawIdx)(idx1+3); _IdxWritePtr[16] = (ImDrawIdx)(idx2+3); _IdxWritePtr[17] = (ImDrawIdx)(idx2+2);
-                _IdxWritePtr += 18;
-
-                idx1 = idx2;
             }
 
-            // Add vertexes
-            for (int i = 0; i < points_count; i++)
+            if (piece_copy_close)
             {
-                _VtxWritePtr[0].pos = temp_points[i*4+0]; _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col_trans;
-                _VtxWritePtr[1].pos = temp_points[i*4+1]; _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col;
-                _VtxWritePtr[2].pos = temp_points[i*4+2]; _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = col;
-                _VtxWritePtr[3].pos = temp_points[i*4+3]; _VtxWritePtr[3].uv = uv; _VtxWritePtr[3].col = col_trans;
-                _VtxWritePtr += 4;
+                memcpy(_VtxWritePtr, VtxBuffer.Data + line_vtx_start, vtx_stride * sizeof(ImDrawVert));
+                _VtxWritePtr += vtx_stride;
             }
+            _VtxCurrentIdx += (unsigned int)(piece_vtx_points * vtx_stride);
+            piece_first += piece_count;
         }
-        _VtxCurrentIdx += (ImDrawIdx)vtx_count;
     }
     else
     {
         // Non Anti-aliased Stroke
-        const int idx_count = count*6;
-        const int vtx_count = count*4;      // FIXME-OPT: Not sharing edges
-        PrimReserve(idx_count, vtx_count);
-
-        for (int i1 = 0; i1 < count; i1++)
+        // Segments don't share vertices: with 16-bit indices and VtxOffset support, reserve as many at a time as can be indexed
+        const int piece_max_segments = (sizeof(ImDrawIdx) == 2 && (Flags & ImDrawListFlags_AllowVtxOffset)) ? 0xFFFF / 4 : count;
+        for (int piece_first = 0; piece_first < count; piece_first += piece_max_segments)
         {
-            const int i2 = (i1+1) == points_count ? 0 : i1+1;
-            const ImVec2& p1 = points[i1];
-            const ImVec2& p2 = points[i2];
-            ImVec2 diff = p2 - p1;
-            diff *= ImInvLength(diff, 1.0f);
-
-            const float dx = diff.x * (thickness * 0.5f);
-            const float dy = diff.y * (thickness * 0.5f);
-            _VtxWritePtr[0].pos.x = p1.x + dy; _VtxWritePtr[0].pos.y = p1.y - dx; _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col;
-            _VtxWritePtr[1].pos.x = p2.x + dy; _VtxWritePtr[1].pos.y = p2.y - dx; _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col;
-            _VtxWritePtr[2].pos.x = p2.x - dy; _VtxWritePtr[2].pos.y = p2.y + dx; _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = col;
-            _VtxWritePtr[3].pos.x = p1.x - dy; _VtxWritePtr[3].pos.y = p1.y + dx; _VtxWritePtr[3].uv = uv; _VtxWritePtr[3].col = col;
-            _VtxWritePtr += 4;
-
-            _IdxWritePtr[0] = (ImDrawIdx)(_VtxCurrentIdx); _IdxWritePtr[1] = (ImDrawIdx)(_VtxCurrentIdx+1); _IdxWritePtr[2] = (ImDrawIdx)(_VtxCurrentIdx+2);
-            _IdxWritePtr[3] = (ImDrawIdx)(_VtxCurrentIdx); _IdxWritePtr[4] = (ImDrawIdx)(_VtxCurrentIdx+2); _IdxWritePtr[5] = (ImDrawIdx)(_VtxCurrentIdx+3);
-            _IdxWritePtr += 6;
-            _VtxCurrentIdx += 4;
+            const int piece_count = ImMin(piece_max_segments, count - piece_first);
+            const int idx_count = piece_count*6;
+            const int vtx_count = piece_count*4;      // FIXME-OPT: Not sharing edges
+            PrimReserve(idx_count, vtx_count);
+
+            for (int i1 = piece_first; i1 < piece_first + piece_count; i1++)
+            {
+                const int i2 = (i1+1) == points_count ? 0 : i1+1;
+                const ImVec2& p1 = points[i1];
+                const ImVec2& p2 = points[i2];
+                ImVec2 diff = p2 - p1;
+                diff *= ImInvLength(diff, 1.0f);
+
+                const float dx = diff.x * (thickness * 0.5f);
+                const float dy = diff.y * (thickness * 0.5f);
+                _VtxWritePtr[0].pos.x = p1.x + dy; _VtxWritePtr[0].pos.y = p1.y - dx; _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col;
+                _VtxWritePtr[1].pos.x = p2.x + dy; _VtxWritePtr[1].pos.y = p2.y - dx; _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col;
+                _VtxWritePtr[2].pos.x = p2.x - dy; _VtxWritePtr[2].pos.y = p2.y + dx; _VtxWritePtr[2].uv = uv; _VtxWritePtr[2].col = col;
+                _VtxWritePtr[3].pos.x = p1.x - dy; _VtxWritePtr[3].pos.y = p1.y + dx; _VtxWritePtr[3].uv = uv; _VtxWritePtr[3].col = col;
+                _VtxWritePtr += 4;
+
+                _IdxWritePtr[0] = (ImDrawIdx)(_VtxCurrentIdx); _IdxWritePtr[1] = (ImDrawIdx)(_VtxCurrentIdx+1); _IdxWritePtr[2] = (ImDrawIdx)(_VtxCurrentIdx+2);
+                _IdxWritePtr[3] = (ImDrawIdx)(_VtxCurrentIdx); _IdxWritePtr[4] = (ImDrawIdx)(_VtxCurrentIdx+2); _IdxWritePtr[5] = (ImDrawIdx)(_VtxCurrentIdx+3);
+                _IdxWritePtr += 6;
+                _VtxCurrentIdx += 4;
+            }
         }
     }
 }
@@ -842,42 +1180,29 @@ void ImDrawList::AddConvexPolyFilled(const ImVec2* points, const int points_coun
             _IdxWritePtr += 3;
         }
 
-        // Compute normals
-        ImVec2* temp_normals = (ImVec2*)alloca(points_count * sizeof(ImVec2));
+        // Add indexes for fringes
         for (int i0 = points_count-1, i1 = 0; i1 < points_count; i0 = i1++)
         {
-            const ImVec2& p0 = points[i0];
-            const ImVec2& p1 = points[i1];
-            ImVec2 diff = p1 - p0;
-            diff *= ImInvLength(diff, 1.0f);
-            temp_normals[i0].x = diff.y;
-            temp_normals[i0].y = -diff.x;
+            _IdxWritePtr[0] = (ImDrawIdx)(vtx_inner_idx+(i1<<1)); _IdxWritePtr[1] = (ImDrawIdx)(vtx_inner_idx+(i0<<1)); _IdxWritePtr[2] = (ImDrawIdx)(vtx_outer_idx+(i0<<1));
+            _IdxWritePtr[3] = (ImDrawIdx)(vtx_outer_idx+(i0<<1)); _IdxWritePtr[4] = (ImDrawIdx)(vtx_outer_idx+(i1<<1)); _IdxWritePtr[5] = (ImDrawIdx)(vtx_inner_idx+(i1<<1));
+            _IdxWritePtr += 6;
         }
 
-        for (int i0 = points_count-1, i1 = 0; i1 < points_count; i0 = i1++)
+        // Add vertices, the outline is a closed polyline
+        float nx[IM_POLYLINE_BLOCK_SIZE+1], ny[IM_POLYLINE_BLOCK_SIZE+1], dx[IM_POLYLINE_BLOCK_SIZE], dy[IM_POLYLINE_BLOCK_SIZE];
+        ImVec2 prev_n = ImPolylineClosingNormal(points, points_count);
+        for (int first = 0; first < points_count; first += IM_POLYLINE_BLOCK_SIZE)
         {
-            // Average normals
-            const ImVec2& n0 = temp_normals[i0];
-            const ImVec2& n1 = temp_normals[i1];
-            ImVec2 dm = (n0 + n1) * 0.5f;
-            float dmr2 = dm.x*dm.x + dm.y*dm.y;
-            if (dmr2 > 0.000001f)
+            const int block_count = ImMin(IM_POLYLINE_BLOCK_SIZE, points_count - first);
+            ImPolylineComputeOffsets(points, points_count, true, first, block_count, prev_n, nx, ny, dx, dy, &prev_n);
+            const ImVec2* block_points = points + first;
+            for (int i = 0; i < block_count; i++)
             {
-                float scale = 1.0f / dmr2;
-                if (scale > 100.0f) scale = 100.0f;
-                dm *= scale;
+                const ImVec2 dm = ImVec2(dx[i], dy[i]) * (AA_SIZE * 0.5f);
+                _VtxWritePtr[0].pos = (block_points[i] - dm); _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col;        // Inner
+                _VtxWritePtr[1].pos = (block_points[i] + dm); _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col_trans;  // Outer
+                _VtxWritePtr += 2;
             }
-            dm *= AA_SIZE * 0.5f;
-
-            // Add vertices
-            _VtxWritePtr[0].pos = (points[i1] - dm); _VtxWritePtr[0].uv = uv; _VtxWritePtr[0].col = col;        // Inner
-            _VtxWritePtr[1].pos = (points[i1] + dm); _VtxWritePtr[1].uv = uv; _VtxWritePtr[1].col = col_trans;  // Outer
-            _VtxWritePtr += 2;
-
-            // Add indexes for fringes
-            _IdxWritePtr[0] = (ImDrawIdx)(vtx_inner_idx+(i1<<1)); _IdxWritePtr[1] = (ImDrawIdx)(vtx_inner_idx+(i0<<1)); _IdxWritePtr[2] = (ImDrawIdx)(vtx_outer_idx+(i0<<1));
-            _IdxWritePtr[3] = (ImDrawIdx)(vtx_outer_idx+(i0<<1)); _IdxWritePtr[4] = (ImDrawIdx)(vtx_outer_idx+(i1<<1)); _IdxWritePtr[5] = (ImDrawIdx)(vtx_inner_idx+(i1<<1));
-            _IdxWritePtr += 6;
         }
         _VtxCurrentIdx += (ImDrawIdx)vtx_count;
     }
@@ -916,6 +1241,36 @@ void ImDrawList::PathArcToFast(const ImVec2& centre, float radius, int a_min_of_
     }
 }
 
+// Appends 'count' points of a unit circle table scaled by 'radius', starting at entry 'i_start' and walking the table forward (i_step = +1) or backward (i_step = -1).
+static void PathArcToTable(ImVector<ImVec2>* path, const ImVec2& centre, float radius, const ImVec2* table, int table_size, int i_start, int count, int i_step)
+{
+    const int path_size = path->Size;
+    path->resize(path_size + count);
+    ImVec2* out = path->Data + path_size;
+    for (int n = 0, i = i_start; n < count; n++)
+    {
+        out[n] = ImVec2(centre.x + table[i].x * radius, centre.y + table[i].y * radius);
+        i += i_step;
+        if (i == table_size)
+            i = 0;
+        else if (i < 0)
+            i = table_size - 1;
+    }
+}
+
+// Point of a unit circle table at angle 'a' (in table steps) when it falls on an entry, else computed.
+static inline ImVec2 CircleVtxAt(const ImVec2* table, int table_size, float a, float a_to_i)
+{
+    const float f = a * a_to_i;
+    const float f_nearest = ImFloorStd(f + 0.5f);
+    if (ImFabs(f - f_nearest) < 1e-3f)
+    {
+        int i = (int)f_nearest % table_size;
+        return table[i < 0 ? i + table_size : i];
+    }
+    return ImVec2(ImCos(a), ImSin(a));
+}
+
 void ImDrawList::PathArcTo(const ImVec2& centre, float radius, float a_min, float a_max, int num_segments)
 {
     if (radius == 0.0f)
@@ -923,62 +1278,178 @@ void ImDrawList::PathArcTo(const ImVec2& centre, float radius, float a_min, floa
         _Path.push_back(centre);
         return;
     }
-    _Path.reserve(_Path.Size + (num_segments + 1));
-    for (int i = 0; i <= num_segments; i++)
+
+    const int table_size = (num_segments <= 0) ? _Data->CalcCircleSegmentCount(radius) : 0;
+    const ImVec2* table = (num_segments <= 0) ? _Data->GetCircleVtx(table_size) : NULL;
+    if (table != NULL)
     {
-        const float a = a_min + ((float)i / (float)num_segments) * (a_max - a_min);
-        _Path.push_back(ImVec2(centre.x + ImCos(a) * radius, centre.y + ImSin(a) * radius));
+        // Automatic segment count: both ends, plus the entries of the unit circle table for this radius that fall between them.
+        const float a_to_i = (float)table_size / (IM_PI * 2.0f);
+        const float f_min = a_min * a_to_i;
+        const float f_max = a_max * a_to_i;
+        const float eps = 1e-3f; // Entries this close to an end are the end itself
+        int i_first, i_last, i_step;
+        if (f_max >= f_min)
+        {
+            i_first = (int)ImFloorStd(f_min + eps) + 1;
+            i_last = (int)ImCeil(f_max - eps) - 1;
+            i_step = +1;
+        }
+        else
+        {
+            i_first = (int)ImCeil(f_min - eps) - 1;
+            i_last = (int)ImFloorStd(f_max + eps) + 1;
+            i_step = -1;
+        }
+        const int count = ImMax((i_last - i_first) * i_step + 1, 0);
+        int i_start = i_first % table_size;
+        if (i_start < 0)
+            i_start += table_size;
+
+        const ImVec2 p_min = CircleVtxAt(table, table_size, a_min, a_to_i);
+        const ImVec2 p_max = CircleVtxAt(table, table_size, a_max, a_to_i);
+        _Path.reserve(_Path.Size + count + 2);
+        _Path.push_back(ImVec2(centre.x + p_min.x * radius, centre.y + p_min.y * radius));
+        PathArcToTable(&_Path, centre, radius, table, table_size, i_start, count, i_step);
+        _Path.push_back(ImVec2(centre.x + p_max.x * radius, centre.y + p_max.y * radius));
+        return;
+    }
+
+    // Automatic segment count without a table: as many segments as the table would have had points over this arc
+    if (num_segments <= 0)
+        num_segments = ImMax((int)ImCeil(ImFabs(a_max - a_min) * (float)table_size / (IM_PI * 2.0f)), 1);
+
+    // Specific segment count: rotate the first point by a constant step rather than calling ImCos/ImSin for every point. The last point is computed so the error doesn't show at the end.
+    const float a_step = (a_max - a_min) / (float)num_segments;
+    const float step_cos = ImCos(a_step);
+    const float step_sin = ImSin(a_step);
+    float c = ImCos(a_min);
+    float s = ImSin(a_min);
+    _Path.reserve(_Path.Size + (num_segments + 1));
+    for (int i = 0; i < num_segments; i++)
+    {
+        _Path.push_back(ImVec2(centre.x + c * radius, centre.y + s * radius));
+        const float c_next = c * step_cos - s * step_sin;
+        s = s * step_cos + c * step_sin;
+        c = c_next;
+    }
+    _Path.push_back(ImVec2(centre.x + ImCos(a_max) * radius, centre.y + ImSin(a_max) * radius));
+}
+
+// Adaptive flattening: split at t=0.5 until a piece is flat within tess_tol, appending the end point of each flat piece.
+// Depth first over a fixed stack instead of recursing, the pieces come out in the same order (and with the same arithmetic) as a recursive subdivision.
+#define IM_BEZIER_CASTELJAU_MAX_LEVEL   10
+static void PathBezierToCasteljau(ImVector<ImVec2>* path, float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4, float tess_tol)
+{
+    // The piece being looked at is on top, the second halves still to do are below it (at most one per level, a piece never sits higher than its level)
+    struct Piece { float x1, y1, x2, y2, x3, y3, x4, y4; int level; };
+    Piece stack[IM_BEZIER_CASTELJAU_MAX_LEVEL + 1];
+    Piece* c = stack;
+    c->x1 = x1; c->y1 = y1; c->x2 = x2; c->y2 = y2; c->x3 = x3; c->y3 = y3; c->x4 = x4; c->y4 = y4; c->level = 0;
+    for (;;)
+    {
+        float dx = c->x4 - c->x1;
+        float dy = c->y4 - c->y1;
+        float d2 = ((c->x2 - c->x4) * dy - (c->y2 - c->y4) * dx);
+        float d3 = ((c->x3 - c->x4) * dy - (c->y3 - c->y4) * dx);
+        d2 = (d2 >= 0) ? d2 : -d2;
+        d3 = (d3 >= 0) ? d3 : -d3;
+        if ((d2+d3) * (d2+d3) < tess_tol * (dx*dx + dy*dy))
+        {
+            path->push_back(ImVec2(c->x4, c->y4));
+        }
+        else if (c->level < IM_BEZIER_CASTELJAU_MAX_LEVEL)
+        {
+            float x12 = (c->x1+c->x2)*0.5f,   y12 = (c->y1+c->y2)*0.5f;
+            float x23 = (c->x2+c->x3)*0.5f,   y23 = (c->y2+c->y3)*0.5f;
+            float x34 = (c->x3+c->x4)*0.5f,   y34 = (c->y3+c->y4)*0.5f;
+            float x123 = (x12+x23)*0.5f,      y123 = (y12+y23)*0.5f;
+            float x234 = (x23+x34)*0.5f,      y234 = (y23+y34)*0.5f;
+            float x1234 = (x123+x234)*0.5f,   y1234 = (y123+y234)*0.5f;
+
+            // Second half replaces the piece, the first half goes on top of it
+            Piece* first = c + 1;
+            first->x1 = c->x1; first->y1 = c->y1; first->x2 = x12; first->y2 = y12; first->x3 = x123; first->y3 = y123; first->x4 = x1234; first->y4 = y1234; first->level = c->level + 1;
+            c->x1 = x1234; c->y1 = y1234; c->x2 = x234; c->y2 = y234; c->x3 = x34; c->y3 = y34; c->level++;
+            c = first;
+            continue;
+        }
+        if (c == stack)
+            break;
+        c--;
     }
 }
 
-static void PathBezierToCasteljau(ImVector<ImVec2>* path, float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4, float tess_tol, int level)
+// Fixed step flattening by forward differencing: three additions per point instead of evaluating the polynomial.
+// Differences are taken relative to p1 to keep them small, and the last point is p4 itself so rounding doesn't accumulate at the end.
+static void PathBezierToForwardDifferences(ImVector<ImVec2>* path, const ImVec2& p1, const ImVec2& p2, const ImVec2& p3, const ImVec2& p4, int num_segments)
 {
-    float dx = x4 - x1;
-    float dy = y4 - y1;
-    float d2 = ((x2 - x4) * dy - (y2 - y4) * dx);
-    float d3 = ((x3 - x4) * dy - (y3 - y4) * dx);
-    d2 = (d2 >= 0) ? d2 : -d2;
-    d3 = (d3 >= 0) ? d3 : -d3;
-    if ((d2+d3) * (d2+d3) < tess_tol * (dx*dx + dy*dy))
-    {
-        path->push_back(ImVec2(x4, y4));
-    }
-    else if (level < 10)
-    {
-        float x12 = (x1+x2)*0.5f,       y12 = (y1+y2)*0.5f;
-        float x23 = (x2+x3)*0.5f,       y23 = (y2+y3)*0.5f;
-        float x34 = (x3+x4)*0.5f,       y34 = (y3+y4)*0.5f;
-        float x123 = (x12+x23)*0.5f,    y123 = (y12+y23)*0.5f;
-        float x234 = (x23+x34)*0.5f,    y234 = (y23+y34)*0.5f;
-        float x1234 = (x123+x234)*0.5f, y1234 = (y123+y234)*0.5f;
+    if (num_segments <= 0)
+        return;
+
+    // B(t) - p1 = a*t^3 + b*t^2 + c*t
+    const float ax = (p4.x - p1.x) + 3.0f * (p2.x - p3.x), ay = (p4.y - p1.y) + 3.0f * (p2.y - p3.y);
+    const float bx = 3.0f * ((p1.x - p2.x) + (p3.x - p2.x)), by = 3.0f * ((p1.y - p2.y) + (p3.y - p2.y));
+    const float cx = 3.0f * (p2.x - p1.x),                   cy = 3.0f * (p2.y - p1.y);
+    const float h = 1.0f / (float)num_segments;
+    const float h2 = h * h;
+    const float h3 = h2 * h;
+    float d1x = ax * h3 + bx * h2 + cx * h, d1y = ay * h3 + by * h2 + cy * h;
+    float d2x = 6.0f * ax * h3 + 2.0f * bx * h2, d2y = 6.0f * ay * h3 + 2.0f * by * h2;
+    const float d3x = 6.0f * ax * h3, d3y = 6.0f * ay * h3;
 
-        PathBezierToCasteljau(path, x1,y1,        x12,y12,    x123,y123,  x1234,y1234, tess_tol, level+1);
-        PathBezierToCasteljau(path, x1234,y1234,  x234,y234,  x34,y34,    x4,y4,       tess_tol, level+1);
+    const int path_size = path->Size;
+    path->resize(path_size + num_segments);
+    ImVec2* out = path->Data + path_size;
+    float x = 0.0f, y = 0.0f;
+    for (int i = 0; i < num_segments - 1; i++)
+    {
+        x += d1x; y += d1y;
+        d1x += d2x; d1y += d2y;
+        d2x += d3x; d2y += d3y;
+        out[i] = ImVec2(p1.x + x, p1.y + y);
     }
+    out[num_segments - 1] = p4;
 }
 
 void ImDrawList::PathBezierCurveTo(const ImVec2& p2, const ImVec2& p3, const ImVec2& p4, int num_segments)
 {
     ImVec2 p1 = _Path.back();
     if (num_segments == 0)
+        PathBezierToCasteljau(&_Path, p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, p4.x, p4.y, _Data->CurveTessellationTol); // Auto-tessellated
+    else
+        PathBezierToForwardDifferences(&_Path, p1, p2, p3, p4, num_segments);
+}
+
+void ImDrawList::PathBezierCurvesTo(const ImVec2* points, int curves_count, int num_segments)
+{
+    if (curves_count <= 0)
+        return;
+    if (num_segments > 0)
+        _Path.reserve(_Path.Size + curves_count * num_segments);
+
+    ImVec2 p1 = _Path.back();
+    const float tess_tol = _Data->CurveTessellationTol;
+    for (int n = 0; n < curves_count; n++, points += 3)
     {
-        // Auto-tessellated
-        PathBezierToCasteljau(&_Path, p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, p4.x, p4.y, _Data->CurveTessellationTol, 0);
+        if (num_segments == 0)
+            PathBezierToCasteljau(&_Path, p1.x, p1.y, points[0].x, points[0].y, points[1].x, points[1].y, points[2].x, points[2].y, tess_tol);
+        else
+            PathBezierToForwardDifferences(&_Path, p1, points[0], points[1], points[2], num_segments);
+        p1 = points[2];
     }
-    else
+}
+
+// Quarter arc of a rounded corner, from angle quadrant*PI/2 to (quadrant+1)*PI/2. Automatic segment counts are multiples of 4, so both ends are table entries.
+static inline void PathRectCorner(ImVector<ImVec2>* path, const ImVec2& centre, float radius, const ImVec2* table, int table_size, int quadrant)
+{
+    if (radius == 0.0f)
     {
-        float t_step = 1.0f / (float)num_segments;
-        for (int i_step = 1; i_step <= num_segments; i_step++)
-        {
-            float t = t_step * i_step;
-            float u = 1.0f - t;
-            float w1 = u*u*u;
-            float w2 = 3*u*u*t;
-            float w3 = 3*u*t*t;
-            float w4 = t*t*t;
-            _Path.push_back(ImVec2(w1*p1.x + w2*p2.x + w3*p3.x + w4*p4.x, w1*p1.y + w2*p2.y + w3*p3.y + w4*p4.y));
-        }
+        path->push_back(centre);
+        return;
     }
+    const int quarter = table_size / 4;
+    PathArcToTable(path, centre, radius, table, table_size, quadrant * quarter, quarter + 1, +1);
 }
 
 void ImDrawList::PathRect(const ImVec2& a, const ImVec2& b, float rounding, int rounding_corners)
@@ -999,10 +1470,22 @@ void ImDrawList::PathRect(const ImVec2& a, const ImVec2& b, float rounding, int
         const float rounding_tr = (rounding_corners & ImDrawCornerFlags_TopRight) ? rounding : 0.0f;
         const float rounding_br = (rounding_corners & ImDrawCornerFlags_BotRight) ? rounding : 0.0f;
         const float rounding_bl = (rounding_corners & ImDrawCornerFlags_BotLeft) ? rounding : 0.0f;
-        PathArcToFast(ImVec2(a.x + rounding_tl, a.y + rounding_tl), rounding_tl, 6, 9);
-        PathArcToFast(ImVec2(b.x - rounding_tr, a.y + rounding_tr), rounding_tr, 9, 12);
-        PathArcToFast(ImVec2(b.x - rounding_br, b.y - rounding_br), rounding_br, 0, 3);
-        PathArcToFast(ImVec2(a.x + rounding_bl, b.y - rounding_bl), rounding_bl, 3, 6);
+        const int table_size = _Data->CalcCircleSegmentCount(rounding);
+        const ImVec2* table = _Data->GetCircleVtx(table_size);
+        _Path.reserve(_Path.Size + (table_size / 4 + 1) * 4);
+        if (table == NULL)
+        {
+            // Rounding too large for the tables
+            PathArcTo(ImVec2(a.x + rounding_tl, a.y + rounding_tl), rounding_tl, IM_PI, IM_PI * 1.5f, table_size / 4);
+            PathArcTo(ImVec2(b.x - rounding_tr, a.y + rounding_tr), rounding_tr, IM_PI * 1.5f, IM_PI * 2.0f, table_size / 4);
+            PathArcTo(ImVec2(b.x - rounding_br, b.y - rounding_br), rounding_br, 0.0f, IM_PI * 0.5f, table_size / 4);
+            PathArcTo(ImVec2(a.x + rounding_bl, b.y - rounding_bl), rounding_bl, IM_PI * 0.5f, IM_PI, table_size / 4);
+            return;
+        }
+        PathRectCorner(&_Path, ImVec2(a.x + rounding_tl, a.y + rounding_tl), rounding_tl, table, table_size, 2);
+        PathRectCorner(&_Path, ImVec2(b.x - rounding_tr, a.y + rounding_tr), rounding_tr, table, table_size, 3);
+        PathRectCorner(&_Path, ImVec2(b.x - rounding_br, b.y - rounding_br), rounding_br, table, table_size, 0);
+        PathRectCorner(&_Path, ImVec2(a.x + rounding_bl, b.y - rounding_bl), rounding_bl, table, table_size, 1);
     }
 }
 
@@ -1106,21 +1589,39 @@ void ImDrawList::AddTriangleFilled(const ImVec2& a, const ImVec2& b, const ImVec
 
 void ImDrawList::AddCircle(const ImVec2& centre, float radius, ImU32 col, int num_segments, float thickness)
 {
-    if ((col & IM_COL32_A_MASK) == 0)
+    if ((col & IM_COL32_A_MASK) == 0 || radius <= 0.0f)
         return;
 
-    const float a_max = IM_PI*2.0f * ((float)num_segments - 1.0f) / (float)num_segments;
-    PathArcTo(centre, radius-0.5f, 0.0f, a_max, num_segments);
+    num_segments = (num_segments <= 0) ? _Data->CalcCircleSegmentCount(radius) : ImMax(num_segments, 3);
+    if (const ImVec2* table = _Data->GetCircleVtx(num_segments))
+    {
+        _Path.reserve(_Path.Size + num_segments);
+        PathArcToTable(&_Path, centre, radius-0.5f, table, num_segments, 0, num_segments, +1);
+    }
+    else
+    {
+        const float a_max = IM_PI*2.0f * ((float)num_segments - 1.0f) / (float)num_segments;
+        PathArcTo(centre, radius-0.5f, 0.0f, a_max, num_segments - 1);
+    }
     PathStroke(col, true, thickness);
 }
 
 void ImDrawList::AddCircleFilled(const ImVec2& centre, float radius, ImU32 col, int num_segments)
 {
-    if ((col & IM_COL32_A_MASK) == 0)
+    if ((col & IM_COL32_A_MASK) == 0 || radius <= 0.0f)
         return;
 
-    const float a_max = IM_PI*2.0f * ((float)num_segments - 1.0f) / (float)num_segments;
-    PathArcTo(centre, radius, 0.0f, a_max, num_segments);
+    num_segments = (num_segments <= 0) ? _Data->CalcCircleSegmentCount(radius) : ImMax(num_segments, 3);
+    if (const ImVec2* table = _Data->GetCircleVtx(num_segments))
+    {
+        _Path.reserve(_Path.Size + num_segments);
+        PathArcToTable(&_Path, centre, radius, table, num_segments, 0, num_segments, +1);
+    }
+    else
+    {
+        const float a_max = IM_PI*2.0f * ((float)num_segments - 1.0f) / (float)num_segments;
+        PathArcTo(centre, radius, 0.0f, a_max, num_segments - 1);
+    }
     PathFillConvex(col);
 }
 
@@ -1134,6 +1635,19 @@ void ImDrawList::AddBezierCurve(const ImVec2& pos0, const ImVec2& cp0, const ImV
     PathStroke(col, false, thickness);
 }
 
+void ImDrawList::AddBezierCurves(const ImVec2* points, int curves_count, ImU32 col, float thickness, int num_segments)
+{
+    if ((col & IM_COL32_A_MASK) == 0)
+        return;
+
+    for (int n = 0; n < curves_count; n++, points += 4)
+    {
+        PathLineTo(points[0]);
+        PathBezierCurvesTo(points + 1, 1, num_segments);
+        PathStroke(col, false, thickness);
+    }
+}
+
 void ImDrawList::AddText(const ImFont* font, float font_size, const ImVec2& pos, ImU32 col, const char* text_begin, const char* text_end, float wrap_width, const ImVec4* cpu_fine_clip_rect)
 {
     if ((col & IM_COL32_A_MASK) == 0)
@@ -1240,8 +1754,15 @@ void ImDrawData::DeIndexAllBuffers()
         if (cmd_list->IdxBuffer.empty())
             continue;
         new_vtx_buffer.resize(cmd_list->IdxBuffer.Size);
-        for (int j = 0; j < cmd_list->IdxBuffer.Size; j++)
-            new_vtx_buffer[j] = cmd_list->VtxBuffer[cmd_list->IdxBuffer[j]];
+        int idx_offset = 0;
+        for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+        {
+            ImDrawCmd& cmd = cmd_list->CmdBuffer[cmd_i];
+            for (int j = idx_offset; j < idx_offset + (int)cmd.ElemCount; j++)
+                new_vtx_buffer[j] = cmd_list->VtxBuffer[cmd.VtxOffset + cmd_list->IdxBuffer[j]];
+            idx_offset += cmd.ElemCount;
+            cmd.VtxOffset = 0;
+        }
         cmd_list->VtxBuffer.swap(new_vtx_buffer);
         cmd_list->IdxBuffer.resize(0);
         TotalVtxCount += cmd_list->VtxBuffer.Size;
@@ -2264,6 +2785,8 @@ void ImFontAtlas::GlyphRangesBuilder::BuildRanges(ImVector<ImWchar>* out_ranges)
 // [SECTION] ImFont
 //-----------------------------------------------------------------------------
 
+int GImFontLookupGeneration = 0;
+
 ImFont::ImFont()
 {
     Scale = 1.0f;
@@ -2303,6 +2826,8 @@ void    ImFont::ClearOutputData()
 
 void ImFont::BuildLookupTable()
 {
+    GImFontLookupGeneration++;
+
     int max_codepoint = 0;
     for (int i = 0; i != Glyphs.Size; i++)
         max_codepoint = ImMax(max_codepoint, (int)Glyphs[i].Codepoint);
@@ -2391,6 +2916,7 @@ void ImFont::AddRemapChar(ImWchar dst, ImWchar src, bool overwrite_dst)
         return;
 
     GrowIndex(dst + 1);
+    GImFontLookupGeneration++;
     IndexLookup[dst] = (src < index_size) ? IndexLookup.Data[src] : (unsigned short)-1;
     IndexAdvanceX[dst] = (src < index_size) ? IndexAdvanceX.Data[src] : 1.0f;
 }
@@ -2415,6 +2941,12 @@ const ImFontGlyph* ImFont::FindGlyphNoFallback(ImWchar c) const
     return &Glyphs.Data[i];
 }
 
+// Blanks and punctuation handled by CalcWordWrapPositionA()
+static inline bool ImCharIsWrapSeparatorA(char c)
+{
+    return c == ' ' || c == '\t' || c == '.' || c == ',' || c == ';' || c == '!' || c == '?' || c == '\"';
+}
+
 const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const char* text_end, float wrap_width) const
 {
     // Simple word-wrapping for English, not full-featured. Please submit failing cases!
@@ -2441,9 +2973,29 @@ const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const c
     const char* prev_word_end = NULL;
     bool inside_word = true;
 
+    const float* ascii_advances = (IndexAdvanceX.Size >= 0x80) ? IndexAdvanceX.Data : NULL;
+    const char* ascii_run_end = text;
+
     const char* s = text;
     while (s < text_end)
     {
+        // Printable ASCII other than blanks and punctuation only makes the current word wider: skip decoding and classifying it.
+        // Runs are scanned in small chunks as we usually return long before text_end.
+        if (inside_word && ascii_advances)
+        {
+            if (s >= ascii_run_end)
+                ascii_run_end = s + ImTextCountPrintableAscii(s, (text_end - s > 64) ? s + 64 : text_end);
+            for (; s < ascii_run_end && !ImCharIsWrapSeparatorA(*s); s++)
+            {
+                word_width += ascii_advances[(unsigned char)*s];
+                word_end = s + 1;
+                if (line_width + word_width >= wrap_width)
+                    return (word_width < wrap_width) ? (prev_word_end ? prev_word_end : word_end) : s;
+            }
+            if (s >= text_end)
+                break;
+        }
+
         unsigned int c = (unsigned int)*s;
         const char* next_s;
         if (c < 0x80)
@@ -2514,7 +3066,7 @@ const char* ImFont::CalcWordWrapPositionA(float scale, const char* text, const c
     return s;
 }
 
-ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, const char* text_begin, const char* text_end, const char** remaining) const
+ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, const char* text_begin, const char* text_end, const char** remaining, ImVector<int>* out_line_breaks) const
 {
     if (!text_end)
         text_end = text_begin + strlen(text_begin); // FIXME-OPT: Need to avoid this.
@@ -2527,6 +3079,7 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
 
     const bool word_wrap_enabled = (wrap_width > 0.0f);
     const char* word_wrap_eol = NULL;
+    const float* ascii_advances = (IndexAdvanceX.Size >= 0x80) ? IndexAdvanceX.Data : NULL;
 
     const char* s = text_begin;
     while (s < text_end)
@@ -2539,6 +3092,8 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
                 word_wrap_eol = CalcWordWrapPositionA(scale, s, text_end, wrap_width - line_width);
                 if (word_wrap_eol == s) // Wrap_width is too small to fit anything. Force displaying 1 character to minimize the height discontinuity.
                     word_wrap_eol++;    // +1 may not be a character start point in UTF-8 but it's ok because we use s >= word_wrap_eol below
+                if (out_line_breaks)
+                    out_line_breaks->push_back((int)(word_wrap_eol - text_begin));
             }
 
             if (s >= word_wrap_eol)
@@ -2559,6 +3114,32 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
             }
         }
 
+        // Printable ASCII needs no decoding: measure the whole run, up to the wrapping point. Same operations in the same order as below.
+        if (ascii_advances)
+        {
+            const char* run_end = s + ImTextCountPrintableAscii(s, word_wrap_enabled ? word_wrap_eol : text_end);
+            if (run_end > s)
+            {
+                if (max_width == FLT_MAX)
+                {
+                    // Finite advances can't add up to FLT_MAX, leave the comparison out of the loop-carried dependency
+                    for (; s < run_end; s++)
+                        line_width += ascii_advances[(unsigned char)*s] * scale;
+                    continue;
+                }
+                for (; s < run_end; s++)
+                {
+                    const float char_width = ascii_advances[(unsigned char)*s] * scale;
+                    if (line_width + char_width >= max_width)
+                        break;
+                    line_width += char_width;
+                }
+                if (s < run_end)
+                    break;
+                continue;
+            }
+        }
+
         // Decode and advance source
         const char* prev_s = s;
         unsigned int c = (unsigned int)*s;
@@ -2622,7 +3203,7 @@ void ImFont::RenderChar(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
     }
 }
 
-void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col, const ImVec4& clip_rect, const char* text_begin, const char* text_end, float wrap_width, bool cpu_fine_clip) const
+void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col, const ImVec4& clip_rect, const char* text_begin, const char* text_end, float wrap_width, bool cpu_fine_clip, const int* line_breaks, int line_breaks_count) const
 {
     if (!text_end)
         text_end = text_begin + strlen(text_begin); // ImGui functions generally already provides a valid text_end, so this is merely to handle direct calls.
@@ -2639,30 +3220,25 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
     const float line_height = FontSize * scale;
     const bool word_wrap_enabled = (wrap_width > 0.0f);
     const char* word_wrap_eol = NULL;
+    int line_break_n = 0;
 
-    // Fast-forward to first visible line
+    // Without word-wrapping lines end at '\n': skip the lines above the clip rectangle and drop the ones below it without decoding them.
+    // This also avoids over-reserving in the call to PrimReserve() for large text.
+    // Note that very large horizontal line will still be affected by the issue (e.g. a one megabyte string buffer without a newline will likely crash atm)
     const char* s = text_begin;
-    if (y + line_height < clip_rect.y && !word_wrap_enabled)
-        while (y + line_height < clip_rect.y)
+    if (!word_wrap_enabled)
+    {
+        while (y + line_height < clip_rect.y && s < text_end)
         {
-            while (s < text_end)
-                if (*s++ == '\n')
-                    break;
+            const char* line_end = (const char*)memchr(s, '\n', (size_t)(text_end - s));
+            s = line_end ? line_end + 1 : text_end;
             y += line_height;
         }
-
-    // For large text, scan for the last visible line in order to avoid over-reserving in the call to PrimReserve()
-    // Note that very large horizontal line will still be affected by the issue (e.g. a one megabyte string buffer without a newline will likely crash atm)
-    if (text_end - s > 10000 && !word_wrap_enabled)
-    {
         const char* s_end = s;
-        float y_end = y;
-        while (y_end < clip_rect.w)
+        for (float y_end = y; y_end < clip_rect.w && s_end < text_end; y_end += line_height)
         {
-            while (s_end < text_end)
-                if (*s_end++ == '\n')
-                    break;
-            y_end += line_height;
+            const char* line_end = (const char*)memchr(s_end, '\n', (size_t)(text_end - s_end));
+            s_end = line_end ? line_end + 1 : text_end;
         }
         text_end = s_end;
     }
@@ -2677,13 +3253,22 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
     ImDrawIdx* idx_write = draw_list->_IdxWritePtr;
     unsigned int vtx_current_idx = draw_list->_VtxCurrentIdx;
 
+#if defined(IMGUI_ENABLE_SSE2) && !defined(IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT)
+    const __m128 scale4 = _mm_set1_ps(scale);
+#endif
+
     while (s < text_end)
     {
         if (word_wrap_enabled)
         {
-            // Calculate how far we can render. Requires two passes on the string data but keeps the code simple and not intrusive for what's essentially an uncommon feature.
-            if (!word_wrap_eol)
+            // Line breaks from CalcTextSizeA() were found at the same points (start of text and after each wrap, where x == pos.x).
+            if (!word_wrap_eol && line_break_n < line_breaks_count)
+            {
+                word_wrap_eol = text_begin + line_breaks[line_break_n++];
+            }
+            else if (!word_wrap_eol)
             {
+                // Calculate how far we can render. Requires two passes on the string data but keeps the code simple and not intrusive for what's essentially an uncommon feature.
                 word_wrap_eol = CalcWordWrapPositionA(scale, s, text_end, wrap_width - (x - pos.x));
                 if (word_wrap_eol == s) // Wrap_width is too small to fit anything. Force displaying 1 character to minimize the height discontinuity.
                     word_wrap_eol++;    // +1 may not be a character start point in UTF-8 but it's ok because we use s >= word_wrap_eol below
@@ -2732,73 +3317,92 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
                 continue;
         }
 
-        float char_width = 0.0f;
-        if (const ImFontGlyph* glyph = FindGlyph((unsigned short)c))
+        const ImFontGlyph* glyph = FindGlyph((unsigned short)c);
+        if (glyph == NULL)
+            continue;
+        const float char_width = glyph->AdvanceX * scale;
+
+        // Arbitrarily assume that both space and tabs are empty glyphs as an optimization
+        // We don't do a second finer clipping test on the Y axis as we've already skipped anything before clip_rect.y and exit once we pass clip_rect.w
+        if (c == ' ' || c == '\t' || x + glyph->X0 * scale > clip_rect.z || x + glyph->X1 * scale < clip_rect.x)
         {
-            char_width = glyph->AdvanceX * scale;
+            x += char_width;
+            continue;
+        }
 
-            // Arbitrarily assume that both space and tabs are empty glyphs as an optimization
-            if (c != ' ' && c != '\t')
-            {
-                // We don't do a second finer clipping test on the Y axis as we've already skipped anything before clip_rect.y and exit once we pass clip_rect.w
-                float x1 = x + glyph->X0 * scale;
-                float x2 = x + glyph->X1 * scale;
-                float y1 = y + glyph->Y0 * scale;
-                float y2 = y + glyph->Y1 * scale;
-                if (x1 <= clip_rect.z && x2 >= clip_rect.x)
-                {
-                    // Render a character
-                    float u1 = glyph->U0;
-                    float v1 = glyph->V0;
-                    float u2 = glyph->U1;
-                    float v2 = glyph->V1;
-
-                    // CPU side clipping used to fit text in their frame when the frame is too small. Only does clipping for axis aligned quads.
-                    if (cpu_fine_clip)
-                    {
-                        if (x1 < clip_rect.x)
-                        {
-                            u1 = u1 + (1.0f - (x2 - clip_rect.x) / (x2 - x1)) * (u2 - u1);
-                            x1 = clip_rect.x;
-                        }
-                        if (y1 < clip_rect.y)
-                        {
-                            v1 = v1 + (1.0f - (y2 - clip_rect.y) / (y2 - y1)) * (v2 - v1);
-                            y1 = clip_rect.y;
-                        }
-                        if (x2 > clip_rect.z)
-                        {
-                            u2 = u1 + ((clip_rect.z - x1) / (x2 - x1)) * (u2 - u1);
-                            x2 = clip_rect.z;
-                        }
-                        if (y2 > clip_rect.w)
-                        {
-                            v2 = v1 + ((clip_rect.w - y1) / (y2 - y1)) * (v2 - v1);
-                            y2 = clip_rect.w;
-                        }
-                        if (y1 >= y2)
-                        {
-                            x += char_width;
-                            continue;
-                        }
-                    }
+        // We are NOT calling PrimRectUV() here because non-inlined causes too much overhead in a debug builds. Inlined here:
+        idx_write[0] = (ImDrawIdx)(vtx_current_idx); idx_write[1] = (ImDrawIdx)(vtx_current_idx+1); idx_write[2] = (ImDrawIdx)(vtx_current_idx+2);
+        idx_write[3] = (ImDrawIdx)(vtx_current_idx); idx_write[4] = (ImDrawIdx)(vtx_current_idx+2); idx_write[5] = (ImDrawIdx)(vtx_current_idx+3);
 
-                    // We are NOT calling PrimRectUV() here because non-inlined causes too much overhead in a debug builds. Inlined here:
-                    {
-                        idx_write[0] = (ImDrawIdx)(vtx_current_idx); idx_write[1] = (ImDrawIdx)(vtx_current_idx+1); idx_write[2] = (ImDrawIdx)(vtx_current_idx+2);
-                        idx_write[3] = (ImDrawIdx)(vtx_current_idx); idx_write[4] = (ImDrawIdx)(vtx_current_idx+2); idx_write[5] = (ImDrawIdx)(vtx_current_idx+3);
-                        vtx_write[0].pos.x = x1; vtx_write[0].pos.y = y1; vtx_write[0].col = col; vtx_write[0].uv.x = u1; vtx_write[0].uv.y = v1;
-                        vtx_write[1].pos.x = x2; vtx_write[1].pos.y = y1; vtx_write[1].col = col; vtx_write[1].uv.x = u2; vtx_write[1].uv.y = v1;
-                        vtx_write[2].pos.x = x2; vtx_write[2].pos.y = y2; vtx_write[2].col = col; vtx_write[2].uv.x = u2; vtx_write[2].uv.y = v2;
-                        vtx_write[3].pos.x = x1; vtx_write[3].pos.y = y2; vtx_write[3].col = col; vtx_write[3].uv.x = u1; vtx_write[3].uv.y = v2;
-                        vtx_write += 4;
-                        vtx_current_idx += 4;
-                        idx_write += 6;
-                    }
-                }
+        if (!cpu_fine_clip)
+        {
+#if defined(IMGUI_ENABLE_SSE2) && !defined(IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT)
+            // Corners and UV of a glyph are 4 consecutive floats each: position the corners with one multiply-add, then each vertex
+            // is a shuffle of both written with a single 16 bytes store for pos+uv. Same operations as the scalar code, same results.
+            const __m128 p = _mm_add_ps(_mm_setr_ps(x, y, x, y), _mm_mul_ps(_mm_loadu_ps(&glyph->X0), scale4)); // x1 y1 x2 y2
+            const __m128 t = _mm_loadu_ps(&glyph->U0);                                                      // u1 v1 u2 v2
+            const __m128 p_swap = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 0, 1, 2));                            // x2 y1 x1 y2
+            const __m128 t_swap = _mm_shuffle_ps(t, t, _MM_SHUFFLE(3, 0, 1, 2));                            // u2 v1 u1 v2
+            _mm_storeu_ps(&vtx_write[0].pos.x, _mm_movelh_ps(p, t));
+            _mm_storeu_ps(&vtx_write[1].pos.x, _mm_movelh_ps(p_swap, t_swap));
+            _mm_storeu_ps(&vtx_write[2].pos.x, _mm_movehl_ps(t, p));
+            _mm_storeu_ps(&vtx_write[3].pos.x, _mm_movehl_ps(t_swap, p_swap));
+            vtx_write[0].col = vtx_write[1].col = vtx_write[2].col = vtx_write[3].col = col;
+#else
+            const float x1 = x + glyph->X0 * scale;
+            const float x2 = x + glyph->X1 * scale;
+            const float y1 = y + glyph->Y0 * scale;
+            const float y2 = y + glyph->Y1 * scale;
+            vtx_write[0].pos.x = x1; vtx_write[0].pos.y = y1; vtx_write[0].col = col; vtx_write[0].uv.x = glyph->U0; vtx_write[0].uv.y = glyph->V0;
+            vtx_write[1].pos.x = x2; vtx_write[1].pos.y = y1; vtx_write[1].col = col; vtx_write[1].uv.x = glyph->U1; vtx_write[1].uv.y = glyph->V0;
+            vtx_write[2].pos.x = x2; vtx_write[2].pos.y = y2; vtx_write[2].col = col; vtx_write[2].uv.x = glyph->U1; vtx_write[2].uv.y = glyph->V1;
+            vtx_write[3].pos.x = x1; vtx_write[3].pos.y = y2; vtx_write[3].col = col; vtx_write[3].uv.x = glyph->U0; vtx_write[3].uv.y = glyph->V1;
+#endif
+        }
+        else
+        {
+            // CPU side clipping used to fit text in their frame when the frame is too small. Only does clipping for axis aligned quads.
+            float x1 = x + glyph->X0 * scale;
+            float x2 = x + glyph->X1 * scale;
+            float y1 = y + glyph->Y0 * scale;
+            float y2 = y + glyph->Y1 * scale;
+            float u1 = glyph->U0;
+            float v1 = glyph->V0;
+            float u2 = glyph->U1;
+            float v2 = glyph->V1;
+            if (x1 < clip_rect.x)
+            {
+                u1 = u1 + (1.0f - (x2 - clip_rect.x) / (x2 - x1)) * (u2 - u1);
+                x1 = clip_rect.x;
+            }
+            if (y1 < clip_rect.y)
+            {
+                v1 = v1 + (1.0f - (y2 - clip_rect.y) / (y2 - y1)) * (v2 - v1);
+                y1 = clip_rect.y;
             }
+            if (x2 > clip_rect.z)
+            {
+                u2 = u1 + ((clip_rect.z - x1) / (x2 - x1)) * (u2 - u1);
+                x2 = clip_rect.z;
+            }
+            if (y2 > clip_rect.w)
+            {
+                v2 = v1 + ((clip_rect.w - y1) / (y2 - y1)) * (v2 - v1);
+                y2 = clip_rect.w;
+            }
+            if (y1 >= y2)
+            {
+                x += char_width;
+                continue;
+            }
+            vtx_write[0].pos.x = x1; vtx_write[0].pos.y = y1; vtx_write[0].col = col; vtx_write[0].uv.x = u1; vtx_write[0].uv.y = v1;
+            vtx_write[1].pos.x = x2; vtx_write[1].pos.y = y1; vtx_write[1].col = col; vtx_write[1].uv.x = u2; vtx_write[1].uv.y = v1;
+            vtx_write[2].pos.x = x2; vtx_write[2].pos.y = y2; vtx_write[2].col = col; vtx_write[2].uv.x = u2; vtx_write[2].uv.y = v2;
+            vtx_write[3].pos.x = x1; vtx_write[3].pos.y = y2; vtx_write[3].col = col; vtx_write[3].uv.x = u1; vtx_write[3].uv.y = v2;
         }
-
+        vtx_write += 4;
+        vtx_current_idx += 4;
+        idx_write += 6;
         x += char_width;
     }
 
@@ -2808,7 +3412,7 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
     draw_list->CmdBuffer[draw_list->CmdBuffer.Size-1].ElemCount -= (idx_expected_size - draw_list->IdxBuffer.Size);
     draw_list->_VtxWritePtr = vtx_write;
     draw_list->_IdxWritePtr = idx_write;
-    draw_list->_VtxCurrentIdx = (unsigned int)draw_list->VtxBuffer.Size;
+    draw_list->_VtxCurrentIdx = vtx_current_idx;
 }
 
 //-----------------------------------------------------------------------------
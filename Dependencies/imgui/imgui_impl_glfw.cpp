@@ -14,6 +14,7 @@
 
 // CHANGELOG
 // (minor and older changes stripped away, please see git history for details)
+//  2026-10-17: Misc: Trace zone (imgui_impl_trace.h) around ImGui_ImplGlfw_NewFrame().
 //  2018-08-01: Inputs: Workaround for Emscripten which doesn't seem to handle focus related calls.
 //  2018-06-29: Inputs: Added support for the ImGuiMouseCursor_Hand cursor.
 //  2018-06-08: Misc: Extracted imgui_impl_glfw.cpp/.h away from the old combined GLFW+OpenGL/Vulkan examples.
@@ -30,6 +31,7 @@
 
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
+#include "imgui_impl_trace.h"
 
 // GLFW
 #include <GLFW/glfw3.h>
@@ -243,6 +245,7 @@ static void ImGui_ImplGlfw_UpdateMouseCursor()
 
 void ImGui_ImplGlfw_NewFrame()
 {
+    IMGUI_TRACE_FUNCTION();
     ImGuiIO& io = ImGui::GetIO();
     IM_ASSERT(io.Fonts->IsBuilt());     // Font atlas needs to be built, call renderer _NewFrame() function e.g. ImGui_ImplOpenGL3_NewFrame() 
 
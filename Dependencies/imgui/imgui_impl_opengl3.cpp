@@ -4,6 +4,7 @@
 
 // Implemented features:
 //  [X] Renderer: User texture binding. Use 'GLuint' OpenGL texture identifier as void*/ImTextureID. Read the FAQ about ImTextureID in imgui.cpp.
+//  [X] Renderer: Large meshes support (64K+ vertices) with 16-bit indices.
 
 // You can copy and use unmodified imgui_impl_* files in your project. See main.cpp for an example of using this.
 // If you are new to dear imgui, read examples/README.txt and read the documentation at the top of imgui.cpp.
@@ -11,6 +12,12 @@
 
 // CHANGELOG
 // (minor and older changes stripped away, please see git history for details)
+//  2026-10-17: OpenGL: Added support for large meshes (64K+ vertices) with 16-bit indices, enable ImGuiBackendFlags_RendererHasVtxOffset flag. Streaming mode adds ImDrawCmd::VtxOffset to the base vertex, the other mode re-points the vertex attributes.
+//  2026-10-17: OpenGL: Trace zones (imgui_impl_trace.h) around NewFrame, draw data diffing, stream uploads and RenderDrawData.
+//  2026-10-17: OpenGL: Added ImGui_ImplOpenGL3_HasDrawDataChanged() to detect unchanged frames. Streaming uploads skip lists the ring region already holds.
+//  2026-10-17: OpenGL: Added ImGui_ImplOpenGL3_SetShadowedState(): skip the GL state backup/restore and filter redundant state changes through a shadow cache.
+//  2026-10-17: OpenGL: Streaming mode draws through glMultiDrawElementsBaseVertex, merging commands with identical texture/clip rect across lists. Added ImGui_ImplOpenGL3_GetRenderStats().
+//  2026-10-17: OpenGL: Added optional streaming buffer mode: persistent VAO, fenced ring of VBO/IBO regions, one upload per frame. See ImGui_ImplOpenGL3_SetStreamingBuffers().
 //  2018-08-29: OpenGL: Added support for more OpenGL loaders: glew and glad, with comments indicative that any loader can be used.
 //  2018-08-09: OpenGL: Default to OpenGL ES 3 on iOS and Android. GLSL version default to "#version 300 ES".
 //  2018-07-30: OpenGL: Support for GLSL 300 ES and 410 core. Fixes for Emscripten compilation.
@@ -53,6 +60,7 @@
 
 #include "imgui.h"
 #include "imgui_impl_opengl3.h"
+#include "imgui_impl_trace.h"
 #include <stdio.h>
 #if defined(_MSC_VER) && _MSC_VER <= 1500 // MSVC 2008 or earlier
 #include <stddef.h>     // intptr_t
@@ -102,9 +110,157 @@ static int          g_AttribLocationTex = 0, g_AttribLocationProjMtx = 0;
 static int          g_AttribLocationPosition = 0, g_AttribLocationUV = 0, g_AttribLocationColor = 0;
 static unsigned int g_VboHandle = 0, g_ElementsHandle = 0;
 
+// Streaming buffer data
+// The VBO/IBO are split into IMGUI_IMPL_OPENGL3_STREAM_FRAMES regions, each frame writes into the next region and
+// fences it. A region is only reused once its fence signaled, otherwise the storage is reallocated instead of waiting.
+#define IMGUI_IMPL_OPENGL3_STREAM_FRAMES 3
+static bool         g_StreamingRequested = false;           // Set by ImGui_ImplOpenGL3_SetStreamingBuffers()
+static bool         g_StreamingApplied = false;             // Value of g_StreamingRequested when the streaming objects were last created
+static bool         g_StreamingActive = false;              // Requested and supported by the context (GL 3.2 sync objects)
+static bool         g_StreamingPersistent = false;          // GL 4.4 / ARB_buffer_storage: persistently mapped, coherent storage
+static GLuint       g_StreamVao = 0;
+static GLsizeiptr   g_StreamVtxRegionSize = 0, g_StreamIdxRegionSize = 0;
+static char*        g_StreamVtxMapped = NULL;
+static char*        g_StreamIdxMapped = NULL;
+static GLsync       g_StreamFences[IMGUI_IMPL_OPENGL3_STREAM_FRAMES] = {};
+static int          g_StreamFrame = 0;
+static ImVector<GLsizei>        g_BatchCounts;
+static ImVector<const GLvoid*>  g_BatchOffsets;
+static ImVector<GLint>          g_BatchBaseVertices;
+static ImGui_ImplOpenGL3_RenderStats g_RenderStats;
+
+// Draw data diffing
+// ImGui_ImplOpenGL3_HasDrawDataChanged() hashes every command list. The streaming upload compares the buffer hashes with what each
+// ring region last received, so lists that are unchanged and at the same offset as IMGUI_IMPL_OPENGL3_STREAM_FRAMES frames ago are skipped.
+struct ImGui_ImplOpenGL3_ListHash
+{
+    ImU64       Buffers;        // Vertex and index data
+    ImU64       Commands;       // Draw commands (clip rectangles, textures, callbacks)
+};
+struct ImGui_ImplOpenGL3_RegionList
+{
+    ImU64       Buffers;
+    GLintptr    VtxOffset, IdxOffset;
+};
+static ImVector<ImGui_ImplOpenGL3_ListHash>     g_ListHashes;
+static ImVector<ImGui_ImplOpenGL3_ListHash>     g_PrevListHashes;
+static int                                      g_ListHashesFrame = -1;     // ImGui frame count g_ListHashes were computed for
+static ImVec4                                   g_PrevDisplayRect = ImVec4(0.0f, 0.0f, 0.0f, 0.0f);
+static ImVector<ImGui_ImplOpenGL3_RegionList>   g_StreamRegionLists[IMGUI_IMPL_OPENGL3_STREAM_FRAMES];
+
+// Shadowed state
+// When the application owns GL state (see ImGui_ImplOpenGL3_SetShadowedState()) nothing is queried or restored, state changes go through
+// the ImGui_ImplOpenGL3_Cached* helpers below which skip calls matching the last known value. Each value has a bit in 'Known'.
+enum ImGui_ImplOpenGL3_StateBits_
+{
+    ImGui_ImplOpenGL3_StateBits_Program         = 1 << 0,
+    ImGui_ImplOpenGL3_StateBits_Texture         = 1 << 1,
+    ImGui_ImplOpenGL3_StateBits_ActiveTexture   = 1 << 2,
+    ImGui_ImplOpenGL3_StateBits_VertexArray     = 1 << 3,
+    ImGui_ImplOpenGL3_StateBits_ArrayBuffer     = 1 << 4,
+    ImGui_ImplOpenGL3_StateBits_Blend           = 1 << 5,
+    ImGui_ImplOpenGL3_StateBits_BlendFunc       = 1 << 6,
+    ImGui_ImplOpenGL3_StateBits_CullFace        = 1 << 7,
+    ImGui_ImplOpenGL3_StateBits_DepthTest       = 1 << 8,
+    ImGui_ImplOpenGL3_StateBits_ScissorTest     = 1 << 9,
+    ImGui_ImplOpenGL3_StateBits_Scissor         = 1 << 10,
+    ImGui_ImplOpenGL3_StateBits_Viewport        = 1 << 11
+};
+
+struct ImGui_ImplOpenGL3_StateCache
+{
+    int         Known;
+    GLuint      Program, Texture, VertexArray, ArrayBuffer;
+    GLenum      ActiveTexture;
+    bool        Blend, CullFace, DepthTest, ScissorTest;
+    GLint       Scissor[4], Viewport[4];
+
+    ImGui_ImplOpenGL3_StateCache() { memset(this, 0, sizeof(*this)); }
+};
+static bool                         g_StateShadowed = false;
+static ImGui_ImplOpenGL3_StateCache g_StateCache;
+
+// Returns true when the cached value for 'bit' is known to be current, otherwise marks it known so the caller can issue the call.
+static inline bool ImGui_ImplOpenGL3_StateIsCurrent(int bit, bool equal)
+{
+    if (g_StateShadowed && (g_StateCache.Known & bit) && equal)
+        return true;
+    g_StateCache.Known |= bit;
+    return false;
+}
+
+static void ImGui_ImplOpenGL3_CachedUseProgram(GLuint program)
+{
+    if (ImGui_ImplOpenGL3_StateIsCurrent(ImGui_ImplOpenGL3_StateBits_Program, g_StateCache.Program == program)) return;
+    g_StateCache.Program = program;
+    glUseProgram(program);
+}
+
+static void ImGui_ImplOpenGL3_CachedActiveTexture(GLenum texture)
+{
+    if (ImGui_ImplOpenGL3_StateIsCurrent(ImGui_ImplOpenGL3_StateBits_ActiveTexture, g_StateCache.ActiveTexture == texture)) return;
+    g_StateCache.ActiveTexture = texture;
+    glActiveTexture(texture);
+}
+
+static void ImGui_ImplOpenGL3_CachedBindTexture(GLuint texture)
+{
+    if (ImGui_ImplOpenGL3_StateIsCurrent(ImGui_ImplOpenGL3_StateBits_Texture, g_StateCache.Texture == texture)) return;
+    g_StateCache.Texture = texture;
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+static void ImGui_ImplOpenGL3_CachedBindVertexArray(GLuint vertex_array)
+{
+    if (ImGui_ImplOpenGL3_StateIsCurrent(ImGui_ImplOpenGL3_StateBits_VertexArray, g_StateCache.VertexArray == vertex_array)) return;
+    g_StateCache.VertexArray = vertex_array;
+    glBindVertexArray(vertex_array);
+}
+
+static void ImGui_ImplOpenGL3_CachedBindArrayBuffer(GLuint buffer)
+{
+    if (ImGui_ImplOpenGL3_StateIsCurrent(ImGui_ImplOpenGL3_StateBits_ArrayBuffer, g_StateCache.ArrayBuffer == buffer)) return;
+    g_StateCache.ArrayBuffer = buffer;
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+}
+
+static void ImGui_ImplOpenGL3_CachedEnable(GLenum cap, bool* cached, int bit, bool enabled)
+{
+    if (ImGui_ImplOpenGL3_StateIsCurrent(bit, *cached == enabled)) return;
+    *cached = enabled;
+    if (enabled) glEnable(cap); else glDisable(cap);
+}
+
+static void ImGui_ImplOpenGL3_CachedScissor(GLint x, GLint y, GLint w, GLint h)
+{
+    const GLint* c = g_StateCache.Scissor;
+    if (ImGui_ImplOpenGL3_StateIsCurrent(ImGui_ImplOpenGL3_StateBits_Scissor, c[0] == x && c[1] == y && c[2] == w && c[3] == h)) return;
+    g_StateCache.Scissor[0] = x; g_StateCache.Scissor[1] = y; g_StateCache.Scissor[2] = w; g_StateCache.Scissor[3] = h;
+    glScissor(x, y, (GLsizei)w, (GLsizei)h);
+}
+
+static void ImGui_ImplOpenGL3_CachedViewport(GLint x, GLint y, GLint w, GLint h)
+{
+    const GLint* c = g_StateCache.Viewport;
+    if (ImGui_ImplOpenGL3_StateIsCurrent(ImGui_ImplOpenGL3_StateBits_Viewport, c[0] == x && c[1] == y && c[2] == w && c[3] == h)) return;
+    g_StateCache.Viewport[0] = x; g_StateCache.Viewport[1] = y; g_StateCache.Viewport[2] = w; g_StateCache.Viewport[3] = h;
+    glViewport(x, y, (GLsizei)w, (GLsizei)h);
+}
+
+// The blend equation/function pair is only ever set to the same values by this backend, a single bit is enough.
+static void ImGui_ImplOpenGL3_CachedBlendFunc()
+{
+    if (ImGui_ImplOpenGL3_StateIsCurrent(ImGui_ImplOpenGL3_StateBits_BlendFunc, true)) return;
+    glBlendEquation(GL_FUNC_ADD);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
 // Functions
 bool    ImGui_ImplOpenGL3_Init(const char* glsl_version)
 {
+    ImGuiIO& io = ImGui::GetIO();
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;  // We can honor the ImDrawCmd::VtxOffset field, allowing for large meshes.
+
     // Store GLSL version string so we can refer to it later in case we recreate shaders. Note: GLSL version is NOT the same as GL version. Leave this to NULL if unsure.
 #ifdef USE_GL_ES3
     if (glsl_version == NULL)
@@ -124,10 +280,504 @@ void    ImGui_ImplOpenGL3_Shutdown()
     ImGui_ImplOpenGL3_DestroyDeviceObjects();
 }
 
+static void ImGui_ImplOpenGL3_CreateStreamingObjects();
+static void ImGui_ImplOpenGL3_DestroyStreamingObjects();
+
 void    ImGui_ImplOpenGL3_NewFrame()
 {
+    IMGUI_TRACE_FUNCTION();
     if (!g_FontTexture)
         ImGui_ImplOpenGL3_CreateDeviceObjects();
+
+    // Streaming setting changed since the device objects were created: rebuild only the streaming objects.
+    // This is done here rather than in ImGui_ImplOpenGL3_SetStreamingBuffers() so it never happens in the middle of a frame.
+    if (g_StreamingApplied != g_StreamingRequested)
+    {
+        GLint last_array_buffer, last_vertex_array;
+        glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &last_array_buffer);
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &last_vertex_array);
+        ImGui_ImplOpenGL3_DestroyStreamingObjects();
+        if (!g_VboHandle) glGenBuffers(1, &g_VboHandle);
+        if (!g_ElementsHandle) glGenBuffers(1, &g_ElementsHandle);
+        ImGui_ImplOpenGL3_CreateStreamingObjects();
+        glBindBuffer(GL_ARRAY_BUFFER, last_array_buffer);
+        glBindVertexArray(last_vertex_array);
+        g_StateCache.Known = 0;
+    }
+}
+
+void    ImGui_ImplOpenGL3_SetStreamingBuffers(bool enabled)
+{
+    // Applied on the next ImGui_ImplOpenGL3_NewFrame() (or ImGui_ImplOpenGL3_CreateDeviceObjects() if they don't exist yet).
+    g_StreamingRequested = enabled;
+}
+
+bool    ImGui_ImplOpenGL3_IsStreamingBuffersActive()
+{
+    return g_StreamingActive;
+}
+
+const ImGui_ImplOpenGL3_RenderStats* ImGui_ImplOpenGL3_GetRenderStats()
+{
+    return &g_RenderStats;
+}
+
+// 64-bit multiplicative hash over 8 byte words, collisions would make a frame or a list upload go missing so 32 bits aren't enough.
+static ImU64 ImGui_ImplOpenGL3_HashBytes(const void* data, size_t size, ImU64 seed)
+{
+    const ImU64 prime = 0x100000001B3ULL;
+    ImU64 hash = seed ^ 0xCBF29CE484222325ULL ^ (ImU64)size;
+    const unsigned char* p = (const unsigned char*)data;
+    for (; size >= 8; size -= 8, p += 8)
+    {
+        ImU64 word;
+        memcpy(&word, p, 8);
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 29;
+    }
+    for (; size > 0; size--, p++)
+        hash = (hash ^ *p) * prime;
+    return hash;
+}
+
+bool    ImGui_ImplOpenGL3_HasDrawDataChanged(ImDrawData* draw_data)
+{
+    IMGUI_TRACE_FUNCTION();
+    g_PrevListHashes.swap(g_ListHashes);
+    g_ListHashes.resize(draw_data->CmdListsCount);
+    g_ListHashesFrame = ImGui::GetFrameCount();
+
+    ImGuiIO& io = ImGui::GetIO();
+    ImVec4 display_rect(draw_data->DisplayPos.x, draw_data->DisplayPos.y, draw_data->DisplaySize.x * io.DisplayFramebufferScale.x, draw_data->DisplaySize.y * io.DisplayFramebufferScale.y);
+    bool changed = g_ListHashes.Size != g_PrevListHashes.Size || memcmp(&display_rect, &g_PrevDisplayRect, sizeof(display_rect)) != 0;
+    g_PrevDisplayRect = display_rect;
+
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        ImGui_ImplOpenGL3_ListHash& list_hash = g_ListHashes[n];
+        list_hash.Buffers = ImGui_ImplOpenGL3_HashBytes(cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert), 0);
+        list_hash.Buffers = ImGui_ImplOpenGL3_HashBytes(cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx), list_hash.Buffers);
+
+        // Hash the fields rather than the whole ImDrawCmd so struct padding doesn't count.
+        ImU64 cmd_hash = 0;
+        for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+        {
+            const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+            cmd_hash = ImGui_ImplOpenGL3_HashBytes(&pcmd->ElemCount, sizeof(pcmd->ElemCount), cmd_hash);
+            cmd_hash = ImGui_ImplOpenGL3_HashBytes(&pcmd->ClipRect, sizeof(pcmd->ClipRect), cmd_hash);
+            cmd_hash = ImGui_ImplOpenGL3_HashBytes(&pcmd->TextureId, sizeof(pcmd->TextureId), cmd_hash);
+            cmd_hash = ImGui_ImplOpenGL3_HashBytes(&pcmd->UserCallback, sizeof(pcmd->UserCallback), cmd_hash);
+            cmd_hash = ImGui_ImplOpenGL3_HashBytes(&pcmd->UserCallbackData, sizeof(pcmd->UserCallbackData), cmd_hash);
+            cmd_hash = ImGui_ImplOpenGL3_HashBytes(&pcmd->VtxOffset, sizeof(pcmd->VtxOffset), cmd_hash);
+        }
+        list_hash.Commands = cmd_hash;
+
+        if (!changed && (list_hash.Buffers != g_PrevListHashes[n].Buffers || list_hash.Commands != g_PrevListHashes[n].Commands))
+            changed = true;
+    }
+    return changed;
+}
+
+void    ImGui_ImplOpenGL3_SetShadowedState(bool enabled)
+{
+    g_StateShadowed = enabled;
+    g_StateCache.Known = 0;
+}
+
+void    ImGui_ImplOpenGL3_InvalidateShadowedState()
+{
+    g_StateCache.Known = 0;
+}
+
+static bool ImGui_ImplOpenGL3_HasExtension(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++)
+    {
+        const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (extension && strcmp(extension, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+static void ImGui_ImplOpenGL3_DeleteStreamFences()
+{
+    for (int i = 0; i < IMGUI_IMPL_OPENGL3_STREAM_FRAMES; i++)
+    {
+        if (g_StreamFences[i])
+            glDeleteSync(g_StreamFences[i]);
+        g_StreamFences[i] = 0;
+    }
+}
+
+// (Re)allocate the storage of one streaming buffer. The old storage stays alive in the driver until the GPU is done with it, so this never waits.
+static char* ImGui_ImplOpenGL3_AllocateStreamBuffer(GLuint* handle, GLenum target, GLsizeiptr size)
+{
+    if (g_StreamingPersistent)
+    {
+        // Immutable storage can't be respecified, so persistent buffers are orphaned by replacing the buffer object.
+        if (*handle)
+        {
+            glBindBuffer(target, *handle);
+            glUnmapBuffer(target);
+            glDeleteBuffers(1, handle);
+            if (target == GL_ARRAY_BUFFER)
+                g_StateCache.Known &= ~ImGui_ImplOpenGL3_StateBits_ArrayBuffer; // Deleting the bound buffer resets the binding
+        }
+        glGenBuffers(1, handle);
+        if (target == GL_ARRAY_BUFFER)
+            ImGui_ImplOpenGL3_CachedBindArrayBuffer(*handle);
+        else
+            glBindBuffer(target, *handle);
+        glBufferStorage(target, size, NULL, BufferStorageMask::GL_MAP_WRITE_BIT | BufferStorageMask::GL_MAP_PERSISTENT_BIT | BufferStorageMask::GL_MAP_COHERENT_BIT);
+        return (char*)glMapBufferRange(target, 0, size, BufferAccessMask::GL_MAP_WRITE_BIT | BufferAccessMask::GL_MAP_PERSISTENT_BIT | BufferAccessMask::GL_MAP_COHERENT_BIT);
+    }
+    if (target == GL_ARRAY_BUFFER)
+        ImGui_ImplOpenGL3_CachedBindArrayBuffer(*handle);
+    else
+        glBindBuffer(target, *handle);
+    glBufferData(target, size, NULL, GL_STREAM_DRAW);
+    return NULL;
+}
+
+// Size both buffers so that each of the IMGUI_IMPL_OPENGL3_STREAM_FRAMES regions holds at least the given amount of data.
+static void ImGui_ImplOpenGL3_ReallocateStreamBuffers(GLsizeiptr vtx_region_size, GLsizeiptr idx_region_size)
+{
+    // Keep regions 256 bytes aligned so that every region start is a valid attribute/index offset.
+    g_StreamVtxRegionSize = (vtx_region_size + 255) & ~(GLsizeiptr)255;
+    g_StreamIdxRegionSize = (idx_region_size + 255) & ~(GLsizeiptr)255;
+
+    // The VAO references the element buffer, bind it so a replaced IBO handle gets recorded.
+    ImGui_ImplOpenGL3_CachedBindVertexArray(g_StreamVao);
+    g_StreamVtxMapped = ImGui_ImplOpenGL3_AllocateStreamBuffer(&g_VboHandle, GL_ARRAY_BUFFER, g_StreamVtxRegionSize * IMGUI_IMPL_OPENGL3_STREAM_FRAMES);
+    g_StreamIdxMapped = ImGui_ImplOpenGL3_AllocateStreamBuffer(&g_ElementsHandle, GL_ELEMENT_ARRAY_BUFFER, g_StreamIdxRegionSize * IMGUI_IMPL_OPENGL3_STREAM_FRAMES);
+
+    // Fences refer to the previous storage, every region of the new storage is free (and holds nothing).
+    ImGui_ImplOpenGL3_DeleteStreamFences();
+    for (int i = 0; i < IMGUI_IMPL_OPENGL3_STREAM_FRAMES; i++)
+        g_StreamRegionLists[i].resize(0);
+}
+
+static void ImGui_ImplOpenGL3_CreateStreamingObjects()
+{
+    g_StreamingActive = false;
+    g_StreamingPersistent = false;
+    g_StreamingApplied = g_StreamingRequested;
+    if (!g_StreamingRequested)
+        return;
+
+    // Fences and base vertex draws need GL 3.2 (or ARB_sync + ARB_draw_elements_base_vertex), persistent mapping needs GL 4.4 (or ARB_buffer_storage).
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    int version = major * 10 + minor;
+    if (version < 32 && !(ImGui_ImplOpenGL3_HasExtension("GL_ARB_sync") && ImGui_ImplOpenGL3_HasExtension("GL_ARB_draw_elements_base_vertex")))
+        return;
+    g_StreamingPersistent = version >= 44 || ImGui_ImplOpenGL3_HasExtension("GL_ARB_buffer_storage");
+    g_StreamingActive = true;
+
+    glGenVertexArrays(1, &g_StreamVao);
+    glBindVertexArray(g_StreamVao);
+    glEnableVertexAttribArray(g_AttribLocationPosition);
+    glEnableVertexAttribArray(g_AttribLocationUV);
+    glEnableVertexAttribArray(g_AttribLocationColor);
+    ImGui_ImplOpenGL3_ReallocateStreamBuffers(sizeof(ImDrawVert) * 8192, sizeof(ImDrawIdx) * 16384);
+    g_StreamFrame = 0;
+}
+
+static void ImGui_ImplOpenGL3_DestroyStreamingObjects()
+{
+    ImGui_ImplOpenGL3_DeleteStreamFences();
+    if (g_StreamingPersistent)
+    {
+        // Immutable storage can't go back to glBufferData() uploads, release the buffers with the mapping (deleting a buffer unmaps it).
+        if (g_VboHandle) glDeleteBuffers(1, &g_VboHandle);
+        if (g_ElementsHandle) glDeleteBuffers(1, &g_ElementsHandle);
+        g_VboHandle = g_ElementsHandle = 0;
+        g_StreamVtxMapped = g_StreamIdxMapped = NULL;
+    }
+    if (g_StreamVao) glDeleteVertexArrays(1, &g_StreamVao);
+    g_StreamVao = 0;
+    g_StreamVtxRegionSize = g_StreamIdxRegionSize = 0;
+    g_StreamingActive = g_StreamingPersistent = false;
+}
+
+// Copy every command list of the frame into the next free region of the streaming buffers and return the region's byte offsets.
+static void ImGui_ImplOpenGL3_UploadStreamRegion(ImDrawData* draw_data, GLintptr* out_vtx_offset, GLintptr* out_idx_offset)
+{
+    IMGUI_TRACE_FUNCTION();
+    GLsizeiptr vtx_size = (GLsizeiptr)draw_data->TotalVtxCount * sizeof(ImDrawVert);
+    GLsizeiptr idx_size = (GLsizeiptr)draw_data->TotalIdxCount * sizeof(ImDrawIdx);
+    int region = g_StreamFrame % IMGUI_IMPL_OPENGL3_STREAM_FRAMES;
+
+    if (vtx_size > g_StreamVtxRegionSize || idx_size > g_StreamIdxRegionSize)
+    {
+        // Grow with some slack so a slowly growing UI doesn't reallocate every frame.
+        GLsizeiptr vtx_region_size = vtx_size + vtx_size / 2;
+        GLsizeiptr idx_region_size = idx_size + idx_size / 2;
+        ImGui_ImplOpenGL3_ReallocateStreamBuffers(vtx_region_size > g_StreamVtxRegionSize ? vtx_region_size : g_StreamVtxRegionSize, idx_region_size > g_StreamIdxRegionSize ? idx_region_size : g_StreamIdxRegionSize);
+    }
+    else if (g_StreamFences[region] && glClientWaitSync(g_StreamFences[region], SyncObjectMask::GL_NONE_BIT, 0) == GL_TIMEOUT_EXPIRED)
+    {
+        // The GPU is still reading this region: orphan the storage rather than stall.
+        ImGui_ImplOpenGL3_ReallocateStreamBuffers(g_StreamVtxRegionSize, g_StreamIdxRegionSize);
+    }
+    if (g_StreamFences[region])
+    {
+        glDeleteSync(g_StreamFences[region]);
+        g_StreamFences[region] = 0;
+    }
+
+    GLintptr vtx_offset = (GLintptr)region * g_StreamVtxRegionSize;
+    GLintptr idx_offset = (GLintptr)region * g_StreamIdxRegionSize;
+    ImGui_ImplOpenGL3_CachedBindArrayBuffer(g_VboHandle);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ElementsHandle);
+
+    // Find the lists this region already holds: same content at the same offset. Only possible when the
+    // application hashed this frame with ImGui_ImplOpenGL3_HasDrawDataChanged().
+    ImVector<ImGui_ImplOpenGL3_RegionList>& region_lists = g_StreamRegionLists[region];
+    const bool have_hashes = g_ListHashesFrame == ImGui::GetFrameCount() && g_ListHashes.Size == draw_data->CmdListsCount;
+    int reused_lists = 0;
+    {
+        GLintptr list_vtx_offset = 0, list_idx_offset = 0;
+        for (int n = 0; n < draw_data->CmdListsCount; n++)
+        {
+            const ImDrawList* cmd_list = draw_data->CmdLists[n];
+            if (have_hashes && n < region_lists.Size && region_lists[n].Buffers == g_ListHashes[n].Buffers && region_lists[n].VtxOffset == list_vtx_offset && region_lists[n].IdxOffset == list_idx_offset)
+                reused_lists++;
+            list_vtx_offset += (GLintptr)cmd_list->VtxBuffer.Size * sizeof(ImDrawVert);
+            list_idx_offset += (GLintptr)cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx);
+        }
+    }
+
+    char* vtx_dst = NULL;
+    char* idx_dst = NULL;
+    if (g_StreamingPersistent)
+    {
+        vtx_dst = g_StreamVtxMapped + vtx_offset;
+        idx_dst = g_StreamIdxMapped + idx_offset;
+    }
+    else if (reused_lists == 0)
+    {
+        // The fence already guarantees the GPU is done with this region, let the driver skip its own synchronization.
+        const BufferAccessMask access = BufferAccessMask::GL_MAP_WRITE_BIT | BufferAccessMask::GL_MAP_INVALIDATE_RANGE_BIT | BufferAccessMask::GL_MAP_UNSYNCHRONIZED_BIT;
+        vtx_dst = vtx_size > 0 ? (char*)glMapBufferRange(GL_ARRAY_BUFFER, vtx_offset, vtx_size, access) : NULL;
+        idx_dst = idx_size > 0 ? (char*)glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, idx_offset, idx_size, access) : NULL;
+    }
+    // else: part of the region must be preserved, so it can't be mapped with invalidation. Changed lists go through glBufferSubData().
+
+    region_lists.resize(draw_data->CmdListsCount);
+    GLintptr list_vtx_offset = 0, list_idx_offset = 0;
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        GLsizeiptr list_vtx_size = (GLsizeiptr)cmd_list->VtxBuffer.Size * sizeof(ImDrawVert);
+        GLsizeiptr list_idx_size = (GLsizeiptr)cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx);
+        ImGui_ImplOpenGL3_RegionList& region_list = region_lists[n];
+        bool reuse = reused_lists > 0 && region_list.Buffers == g_ListHashes[n].Buffers && region_list.VtxOffset == list_vtx_offset && region_list.IdxOffset == list_idx_offset;
+        if (!reuse)
+        {
+            if (g_StreamingPersistent || reused_lists == 0)
+            {
+                if (vtx_dst) memcpy(vtx_dst + list_vtx_offset, cmd_list->VtxBuffer.Data, (size_t)list_vtx_size);
+                if (idx_dst) memcpy(idx_dst + list_idx_offset, cmd_list->IdxBuffer.Data, (size_t)list_idx_size);
+            }
+            else
+            {
+                glBufferSubData(GL_ARRAY_BUFFER, vtx_offset + list_vtx_offset, list_vtx_size, cmd_list->VtxBuffer.Data);
+                glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, idx_offset + list_idx_offset, list_idx_size, cmd_list->IdxBuffer.Data);
+            }
+            g_RenderStats.UploadedBytes += (int)(list_vtx_size + list_idx_size);
+        }
+
+        // Without a hash we can't tell next time whether the content matches, record an offset that never does.
+        region_list.Buffers = have_hashes ? g_ListHashes[n].Buffers : 0;
+        region_list.VtxOffset = have_hashes ? list_vtx_offset : -1;
+        region_list.IdxOffset = list_idx_offset;
+        list_vtx_offset += list_vtx_size;
+        list_idx_offset += list_idx_size;
+    }
+
+    if (!g_StreamingPersistent && reused_lists == 0)
+    {
+        if (vtx_size > 0) glUnmapBuffer(GL_ARRAY_BUFFER);
+        if (idx_size > 0) glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+    }
+
+    *out_vtx_offset = vtx_offset;
+    *out_idx_offset = idx_offset;
+}
+
+// Fence the region written by ImGui_ImplOpenGL3_UploadStreamRegion() once all draws reading it are submitted.
+static void ImGui_ImplOpenGL3_FenceStreamRegion()
+{
+    int region = g_StreamFrame % IMGUI_IMPL_OPENGL3_STREAM_FRAMES;
+    g_StreamFences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, UnusedMask::GL_NONE_BIT);
+    g_StreamFrame++;
+}
+
+// Pending batch: a run of index ranges sharing texture and scissor state, submitted with a single draw call.
+static void ImGui_ImplOpenGL3_FlushBatch()
+{
+    if (g_BatchCounts.Size == 0)
+        return;
+    const GLenum idx_type = sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    if (g_BatchCounts.Size == 1)
+        glDrawElementsBaseVertex(GL_TRIANGLES, g_BatchCounts[0], idx_type, g_BatchOffsets[0], g_BatchBaseVertices[0]);
+    else
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, g_BatchCounts.Data, idx_type, g_BatchOffsets.Data, g_BatchCounts.Size, g_BatchBaseVertices.Data);
+    g_RenderStats.DrawCalls++;
+    g_BatchCounts.resize(0);
+    g_BatchOffsets.resize(0);
+    g_BatchBaseVertices.resize(0);
+}
+
+// Point the vertex attributes at ImDrawVert data starting 'vtx_offset' bytes into the bound GL_ARRAY_BUFFER.
+static void ImGui_ImplOpenGL3_SetupVertexAttribs(GLintptr vtx_offset)
+{
+    const char* vtx_base = (const char*)0 + vtx_offset;
+    glVertexAttribPointer(g_AttribLocationPosition, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (const GLvoid*)(vtx_base + IM_OFFSETOF(ImDrawVert, pos)));
+    glVertexAttribPointer(g_AttribLocationUV, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (const GLvoid*)(vtx_base + IM_OFFSETOF(ImDrawVert, uv)));
+    glVertexAttribPointer(g_AttribLocationColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (const GLvoid*)(vtx_base + IM_OFFSETOF(ImDrawVert, col)));
+}
+
+// Draw a frame uploaded by ImGui_ImplOpenGL3_UploadStreamRegion().
+// Every list is addressed through a base vertex into the shared region, so consecutive commands with the same texture and
+// clip rectangle collapse into one draw call even when they come from different command lists.
+static void ImGui_ImplOpenGL3_RenderBatched(ImDrawData* draw_data, int fb_width, int fb_height, GLintptr vtx_offset, GLintptr idx_offset)
+{
+    // Attributes point at the start of the region once per frame, each command then only needs its base vertex.
+    ImGui_ImplOpenGL3_SetupVertexAttribs(vtx_offset);
+
+    ImVec2 pos = draw_data->DisplayPos;
+    bool state_valid = false;
+    GLuint current_texture = 0;
+    int current_scissor[4] = { 0, 0, 0, 0 };
+    GLint list_base_vertex = 0;
+    const char* idx_buffer_offset = (const char*)0 + idx_offset;
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+        {
+            const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+            if (pcmd->UserCallback)
+            {
+                // User callback (registered via ImDrawList::AddCallback)
+                // Submit everything before it, and don't trust our state tracking afterwards since the callback may change it.
+                ImGui_ImplOpenGL3_FlushBatch();
+                pcmd->UserCallback(cmd_list, pcmd);
+                state_valid = false;
+                g_StateCache.Known = 0;
+            }
+            else
+            {
+                g_RenderStats.CmdCount++;
+                ImVec4 clip_rect = ImVec4(pcmd->ClipRect.x - pos.x, pcmd->ClipRect.y - pos.y, pcmd->ClipRect.z - pos.x, pcmd->ClipRect.w - pos.y);
+                if (clip_rect.x < fb_width && clip_rect.y < fb_height && clip_rect.z >= 0.0f && clip_rect.w >= 0.0f && pcmd->ElemCount > 0)
+                {
+                    GLuint texture = (GLuint)(intptr_t)pcmd->TextureId;
+                    int scissor[4] = { (int)clip_rect.x, (int)(fb_height - clip_rect.w), (int)(clip_rect.z - clip_rect.x), (int)(clip_rect.w - clip_rect.y) };
+                    if (!state_valid || texture != current_texture || memcmp(scissor, current_scissor, sizeof(scissor)) != 0)
+                    {
+                        ImGui_ImplOpenGL3_FlushBatch();
+                        if (!state_valid || texture != current_texture)
+                            ImGui_ImplOpenGL3_CachedBindTexture(texture);
+                        if (!state_valid || memcmp(scissor, current_scissor, sizeof(scissor)) != 0)
+                            ImGui_ImplOpenGL3_CachedScissor(scissor[0], scissor[1], scissor[2], scissor[3]);
+                        current_texture = texture;
+                        memcpy(current_scissor, scissor, sizeof(scissor));
+                        state_valid = true;
+                    }
+
+                    // Extend the previous range when this command directly follows it with the same base vertex, otherwise start a new one.
+                    const GLint base_vertex = list_base_vertex + (GLint)pcmd->VtxOffset;
+                    int last = g_BatchCounts.Size - 1;
+                    if (last >= 0 && g_BatchBaseVertices[last] == base_vertex && (const char*)g_BatchOffsets[last] + g_BatchCounts[last] * sizeof(ImDrawIdx) == idx_buffer_offset)
+                    {
+                        g_BatchCounts[last] += (GLsizei)pcmd->ElemCount;
+                    }
+                    else
+                    {
+                        g_BatchCounts.push_back((GLsizei)pcmd->ElemCount);
+                        g_BatchOffsets.push_back(idx_buffer_offset);
+                        g_BatchBaseVertices.push_back(base_vertex);
+                    }
+                }
+            }
+            idx_buffer_offset += pcmd->ElemCount * sizeof(ImDrawIdx);
+        }
+        list_base_vertex += cmd_list->VtxBuffer.Size;
+    }
+    ImGui_ImplOpenGL3_FlushBatch();
+}
+
+// GL state touched by ImGui_ImplOpenGL3_RenderDrawData(), saved and restored around it unless the state is shadowed.
+struct ImGui_ImplOpenGL3_BackupState
+{
+    GLenum      ActiveTexture;
+    GLint       Program, Texture, Sampler, ArrayBuffer, VertexArray;
+    GLint       PolygonMode[2], Viewport[4], ScissorBox[4];
+    GLenum      BlendSrcRgb, BlendDstRgb, BlendSrcAlpha, BlendDstAlpha, BlendEquationRgb, BlendEquationAlpha;
+    bool        EnableBlend, EnableCullFace, EnableDepthTest, EnableScissorTest;
+
+    ImGui_ImplOpenGL3_BackupState() { memset(this, 0, sizeof(*this)); }
+};
+
+static void ImGui_ImplOpenGL3_BackupGLState(ImGui_ImplOpenGL3_BackupState* b)
+{
+    glGetIntegerv(GL_ACTIVE_TEXTURE, (GLint*)&b->ActiveTexture);
+    glGetIntegerv(GL_CURRENT_PROGRAM, &b->Program);
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &b->Texture);
+#ifdef GL_SAMPLER_BINDING
+    glGetIntegerv(GL_SAMPLER_BINDING, &b->Sampler);
+#endif
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &b->ArrayBuffer);
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &b->VertexArray);
+#ifdef GL_POLYGON_MODE
+    glGetIntegerv(GL_POLYGON_MODE, b->PolygonMode);
+#endif
+    glGetIntegerv(GL_VIEWPORT, b->Viewport);
+    glGetIntegerv(GL_SCISSOR_BOX, b->ScissorBox);
+    glGetIntegerv(GL_BLEND_SRC_RGB, (GLint*)&b->BlendSrcRgb);
+    glGetIntegerv(GL_BLEND_DST_RGB, (GLint*)&b->BlendDstRgb);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, (GLint*)&b->BlendSrcAlpha);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, (GLint*)&b->BlendDstAlpha);
+    glGetIntegerv(GL_BLEND_EQUATION_RGB, (GLint*)&b->BlendEquationRgb);
+    glGetIntegerv(GL_BLEND_EQUATION_ALPHA, (GLint*)&b->BlendEquationAlpha);
+    b->EnableBlend = glIsEnabled(GL_BLEND) ? true : false;
+    b->EnableCullFace = glIsEnabled(GL_CULL_FACE) ? true : false;
+    b->EnableDepthTest = glIsEnabled(GL_DEPTH_TEST) ? true : false;
+    b->EnableScissorTest = glIsEnabled(GL_SCISSOR_TEST) ? true : false;
+}
+
+static void ImGui_ImplOpenGL3_RestoreGLState(const ImGui_ImplOpenGL3_BackupState* b)
+{
+    glUseProgram(b->Program);
+    glBindTexture(GL_TEXTURE_2D, b->Texture);
+#ifdef GL_SAMPLER_BINDING
+    glBindSampler(0, b->Sampler);
+#endif
+    glActiveTexture(b->ActiveTexture);
+    glBindVertexArray(b->VertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, b->ArrayBuffer);
+    glBlendEquationSeparate(b->BlendEquationRgb, b->BlendEquationAlpha);
+    glBlendFuncSeparate(b->BlendSrcRgb, b->BlendDstRgb, b->BlendSrcAlpha, b->BlendDstAlpha);
+    if (b->EnableBlend) glEnable(GL_BLEND); else glDisable(GL_BLEND);
+    if (b->EnableCullFace) glEnable(GL_CULL_FACE); else glDisable(GL_CULL_FACE);
+    if (b->EnableDepthTest) glEnable(GL_DEPTH_TEST); else glDisable(GL_DEPTH_TEST);
+    if (b->EnableScissorTest) glEnable(GL_SCISSOR_TEST); else glDisable(GL_SCISSOR_TEST);
+#ifdef GL_POLYGON_MODE
+    glPolygonMode(GL_FRONT_AND_BACK, (GLenum)b->PolygonMode[0]);
+#endif
+    glViewport(b->Viewport[0], b->Viewport[1], (GLsizei)b->Viewport[2], (GLsizei)b->Viewport[3]);
+    glScissor(b->ScissorBox[0], b->ScissorBox[1], (GLsizei)b->ScissorBox[2], (GLsizei)b->ScissorBox[3]);
+
+    // Everything we set was just overwritten.
+    g_StateCache.Known = 0;
 }
 
 // OpenGL3 Render function.
@@ -135,6 +785,7 @@ void    ImGui_ImplOpenGL3_NewFrame()
 // Note that this implementation is little overcomplicated because we are saving/setting up/restoring every OpenGL state explicitly, in order to be able to run within any OpenGL engine that doesn't do so.
 void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
 {
+    IMGUI_TRACE_FUNCTION();
     // Avoid rendering when minimized, scale coordinates for retina displays (screen coordinates != framebuffer coordinates)
     ImGuiIO& io = ImGui::GetIO();
     int fb_width = (int)(draw_data->DisplaySize.x * io.DisplayFramebufferScale.x);
@@ -144,45 +795,25 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
     draw_data->ScaleClipRects(io.DisplayFramebufferScale);
 
     // Backup GL state
-    GLenum last_active_texture; glGetIntegerv(GL_ACTIVE_TEXTURE, (GLint*)&last_active_texture);
-    glActiveTexture(GL_TEXTURE0);
-    GLint last_program; glGetIntegerv(GL_CURRENT_PROGRAM, &last_program);
-    GLint last_texture; glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
-#ifdef GL_SAMPLER_BINDING
-    GLint last_sampler; glGetIntegerv(GL_SAMPLER_BINDING, &last_sampler);
-#endif
-    GLint last_array_buffer; glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &last_array_buffer);
-    GLint last_vertex_array; glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &last_vertex_array);
-#ifdef GL_POLYGON_MODE
-    GLint last_polygon_mode[2]; glGetIntegerv(GL_POLYGON_MODE, last_polygon_mode);
-#endif
-    GLint last_viewport[4]; glGetIntegerv(GL_VIEWPORT, last_viewport);
-    GLint last_scissor_box[4]; glGetIntegerv(GL_SCISSOR_BOX, last_scissor_box);
-    GLenum last_blend_src_rgb; glGetIntegerv(GL_BLEND_SRC_RGB, (GLint*)&last_blend_src_rgb);
-    GLenum last_blend_dst_rgb; glGetIntegerv(GL_BLEND_DST_RGB, (GLint*)&last_blend_dst_rgb);
-    GLenum last_blend_src_alpha; glGetIntegerv(GL_BLEND_SRC_ALPHA, (GLint*)&last_blend_src_alpha);
-    GLenum last_blend_dst_alpha; glGetIntegerv(GL_BLEND_DST_ALPHA, (GLint*)&last_blend_dst_alpha);
-    GLenum last_blend_equation_rgb; glGetIntegerv(GL_BLEND_EQUATION_RGB, (GLint*)&last_blend_equation_rgb);
-    GLenum last_blend_equation_alpha; glGetIntegerv(GL_BLEND_EQUATION_ALPHA, (GLint*)&last_blend_equation_alpha);
-    GLboolean last_enable_blend = glIsEnabled(GL_BLEND);
-    GLboolean last_enable_cull_face = glIsEnabled(GL_CULL_FACE);
-    GLboolean last_enable_depth_test = glIsEnabled(GL_DEPTH_TEST);
-    GLboolean last_enable_scissor_test = glIsEnabled(GL_SCISSOR_TEST);
+    // (skipped when the application owns GL state: queries may force a sync with threaded drivers, and we track what we set ourselves)
+    ImGui_ImplOpenGL3_BackupState backup;
+    if (!g_StateShadowed)
+        ImGui_ImplOpenGL3_BackupGLState(&backup);
+    ImGui_ImplOpenGL3_CachedActiveTexture(GL_TEXTURE0);
 
     // Setup render state: alpha-blending enabled, no face culling, no depth testing, scissor enabled, polygon fill
-    glEnable(GL_BLEND);
-    glBlendEquation(GL_FUNC_ADD);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_CULL_FACE);
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_SCISSOR_TEST);
+    ImGui_ImplOpenGL3_CachedEnable(GL_BLEND, &g_StateCache.Blend, ImGui_ImplOpenGL3_StateBits_Blend, true);
+    ImGui_ImplOpenGL3_CachedBlendFunc();
+    ImGui_ImplOpenGL3_CachedEnable(GL_CULL_FACE, &g_StateCache.CullFace, ImGui_ImplOpenGL3_StateBits_CullFace, false);
+    ImGui_ImplOpenGL3_CachedEnable(GL_DEPTH_TEST, &g_StateCache.DepthTest, ImGui_ImplOpenGL3_StateBits_DepthTest, false);
+    ImGui_ImplOpenGL3_CachedEnable(GL_SCISSOR_TEST, &g_StateCache.ScissorTest, ImGui_ImplOpenGL3_StateBits_ScissorTest, true);
 #ifdef GL_POLYGON_MODE
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 #endif
 
     // Setup viewport, orthographic projection matrix
     // Our visible imgui space lies from draw_data->DisplayPps (top left) to draw_data->DisplayPos+data_data->DisplaySize (bottom right). DisplayMin is typically (0,0) for single viewport apps.
-    glViewport(0, 0, (GLsizei)fb_width, (GLsizei)fb_height);
+    ImGui_ImplOpenGL3_CachedViewport(0, 0, fb_width, fb_height);
     float L = draw_data->DisplayPos.x;
     float R = draw_data->DisplayPos.x + draw_data->DisplaySize.x;
     float T = draw_data->DisplayPos.y;
@@ -194,84 +825,90 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
         { 0.0f,         0.0f,        -1.0f,   0.0f },
         { (R+L)/(L-R),  (T+B)/(B-T),  0.0f,   1.0f },
     };
-    glUseProgram(g_ShaderHandle);
+    ImGui_ImplOpenGL3_CachedUseProgram(g_ShaderHandle);
     glUniform1i(g_AttribLocationTex, 0);
     glUniformMatrix4fv(g_AttribLocationProjMtx, 1, GL_FALSE, &ortho_projection[0][0]);
 #ifdef GL_SAMPLER_BINDING
     glBindSampler(0, 0); // We use combined texture/sampler state. Applications using GL 3.3 may set that otherwise.
 #endif
-    // Recreate the VAO every time
-    // (This is to easily allow multiple GL contexts. VAO are not shared among GL contexts, and we don't track creation/deletion of windows so we don't have an obvious key to use to cache them.)
-    GLuint vao_handle = 0;
-    glGenVertexArrays(1, &vao_handle);
-    glBindVertexArray(vao_handle);
-    glBindBuffer(GL_ARRAY_BUFFER, g_VboHandle);
-    glEnableVertexAttribArray(g_AttribLocationPosition);
-    glEnableVertexAttribArray(g_AttribLocationUV);
-    glEnableVertexAttribArray(g_AttribLocationColor);
-    glVertexAttribPointer(g_AttribLocationPosition, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, pos));
-    glVertexAttribPointer(g_AttribLocationUV, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, uv));
-    glVertexAttribPointer(g_AttribLocationColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, col));
-
-    // Draw
-    ImVec2 pos = draw_data->DisplayPos;
-    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    g_RenderStats.CmdCount = g_RenderStats.DrawCalls = g_RenderStats.UploadedBytes = 0;
+    if (g_StreamingActive)
     {
-        const ImDrawList* cmd_list = draw_data->CmdLists[n];
-        const ImDrawIdx* idx_buffer_offset = 0;
+        // Streaming: the VAO lives as long as the device objects, the whole frame is uploaded at once and drawn in batches.
+        ImGui_ImplOpenGL3_CachedBindVertexArray(g_StreamVao);
+        GLintptr stream_vtx_offset = 0, stream_idx_offset = 0;
+        ImGui_ImplOpenGL3_UploadStreamRegion(draw_data, &stream_vtx_offset, &stream_idx_offset);
+        ImGui_ImplOpenGL3_RenderBatched(draw_data, fb_width, fb_height, stream_vtx_offset, stream_idx_offset);
+        ImGui_ImplOpenGL3_FenceStreamRegion();
+    }
+    else
+    {
+        // Recreate the VAO every time
+        // (This is to easily allow multiple GL contexts. VAO are not shared among GL contexts, and we don't track creation/deletion of windows so we don't have an obvious key to use to cache them.)
+        GLuint vao_handle = 0;
+        glGenVertexArrays(1, &vao_handle);
+        ImGui_ImplOpenGL3_CachedBindVertexArray(vao_handle);
+        ImGui_ImplOpenGL3_CachedBindArrayBuffer(g_VboHandle);
+        glEnableVertexAttribArray(g_AttribLocationPosition);
+        glEnableVertexAttribArray(g_AttribLocationUV);
+        glEnableVertexAttribArray(g_AttribLocationColor);
+        ImGui_ImplOpenGL3_SetupVertexAttribs(0);
+        unsigned int current_vtx_offset = 0;
 
-        glBindBuffer(GL_ARRAY_BUFFER, g_VboHandle);
-        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)cmd_list->VtxBuffer.Size * sizeof(ImDrawVert), (const GLvoid*)cmd_list->VtxBuffer.Data, GL_STREAM_DRAW);
+        // Draw
+        ImVec2 pos = draw_data->DisplayPos;
+        for (int n = 0; n < draw_data->CmdListsCount; n++)
+        {
+            const ImDrawList* cmd_list = draw_data->CmdLists[n];
+            const ImDrawIdx* idx_buffer_offset = 0;
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ElementsHandle);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx), (const GLvoid*)cmd_list->IdxBuffer.Data, GL_STREAM_DRAW);
+            ImGui_ImplOpenGL3_CachedBindArrayBuffer(g_VboHandle);
+            glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)cmd_list->VtxBuffer.Size * sizeof(ImDrawVert), (const GLvoid*)cmd_list->VtxBuffer.Data, GL_STREAM_DRAW);
 
-        for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
-        {
-            const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
-            if (pcmd->UserCallback)
-            {
-                // User callback (registered via ImDrawList::AddCallback)
-                pcmd->UserCallback(cmd_list, pcmd);
-            }
-            else
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ElementsHandle);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx), (const GLvoid*)cmd_list->IdxBuffer.Data, GL_STREAM_DRAW);
+            g_RenderStats.UploadedBytes += cmd_list->VtxBuffer.Size * (int)sizeof(ImDrawVert) + cmd_list->IdxBuffer.Size * (int)sizeof(ImDrawIdx);
+
+            for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
             {
-                ImVec4 clip_rect = ImVec4(pcmd->ClipRect.x - pos.x, pcmd->ClipRect.y - pos.y, pcmd->ClipRect.z - pos.x, pcmd->ClipRect.w - pos.y);
-                if (clip_rect.x < fb_width && clip_rect.y < fb_height && clip_rect.z >= 0.0f && clip_rect.w >= 0.0f)
+                const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+                if (pcmd->UserCallback)
+                {
+                    // User callback (registered via ImDrawList::AddCallback)
+                    pcmd->UserCallback(cmd_list, pcmd);
+                    g_StateCache.Known = 0;
+                }
+                else
                 {
-                    // Apply scissor/clipping rectangle
-                    glScissor((int)clip_rect.x, (int)(fb_height - clip_rect.w), (int)(clip_rect.z - clip_rect.x), (int)(clip_rect.w - clip_rect.y));
+                    g_RenderStats.CmdCount++;
+                    ImVec4 clip_rect = ImVec4(pcmd->ClipRect.x - pos.x, pcmd->ClipRect.y - pos.y, pcmd->ClipRect.z - pos.x, pcmd->ClipRect.w - pos.y);
+                    if (clip_rect.x < fb_width && clip_rect.y < fb_height && clip_rect.z >= 0.0f && clip_rect.w >= 0.0f)
+                    {
+                        // Apply scissor/clipping rectangle
+                        ImGui_ImplOpenGL3_CachedScissor((int)clip_rect.x, (int)(fb_height - clip_rect.w), (int)(clip_rect.z - clip_rect.x), (int)(clip_rect.w - clip_rect.y));
 
-                    // Bind texture, Draw
-                    glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->TextureId);
-                    glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, idx_buffer_offset);
+                        // Bind texture, Draw
+                        // This path doesn't rely on base vertex draws (GL 3.2), a command's VtxOffset moves the attribute pointers instead.
+                        ImGui_ImplOpenGL3_CachedBindTexture((GLuint)(intptr_t)pcmd->TextureId);
+                        if (pcmd->VtxOffset != current_vtx_offset)
+                        {
+                            ImGui_ImplOpenGL3_SetupVertexAttribs((GLintptr)pcmd->VtxOffset * sizeof(ImDrawVert));
+                            current_vtx_offset = pcmd->VtxOffset;
+                        }
+                        glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, idx_buffer_offset);
+                        g_RenderStats.DrawCalls++;
+                    }
                 }
+                idx_buffer_offset += pcmd->ElemCount;
             }
-            idx_buffer_offset += pcmd->ElemCount;
         }
+        glDeleteVertexArrays(1, &vao_handle);
+        g_StateCache.VertexArray = 0; // Deleting the bound VAO resets the binding
     }
-    glDeleteVertexArrays(1, &vao_handle);
 
     // Restore modified GL state
-    glUseProgram(last_program);
-    glBindTexture(GL_TEXTURE_2D, last_texture);
-#ifdef GL_SAMPLER_BINDING
-    glBindSampler(0, last_sampler);
-#endif
-    glActiveTexture(last_active_texture);
-    glBindVertexArray(last_vertex_array);
-    glBindBuffer(GL_ARRAY_BUFFER, last_array_buffer);
-    glBlendEquationSeparate(last_blend_equation_rgb, last_blend_equation_alpha);
-    glBlendFuncSeparate(last_blend_src_rgb, last_blend_dst_rgb, last_blend_src_alpha, last_blend_dst_alpha);
-    if (last_enable_blend) glEnable(GL_BLEND); else glDisable(GL_BLEND);
-    if (last_enable_cull_face) glEnable(GL_CULL_FACE); else glDisable(GL_CULL_FACE);
-    if (last_enable_depth_test) glEnable(GL_DEPTH_TEST); else glDisable(GL_DEPTH_TEST);
-    if (last_enable_scissor_test) glEnable(GL_SCISSOR_TEST); else glDisable(GL_SCISSOR_TEST);
-#ifdef GL_POLYGON_MODE
-    glPolygonMode(GL_FRONT_AND_BACK, (GLenum)last_polygon_mode[0]);
-#endif
-    glViewport(last_viewport[0], last_viewport[1], (GLsizei)last_viewport[2], (GLsizei)last_viewport[3]);
-    glScissor(last_scissor_box[0], last_scissor_box[1], (GLsizei)last_scissor_box[2], (GLsizei)last_scissor_box[3]);
+    if (!g_StateShadowed)
+        ImGui_ImplOpenGL3_RestoreGLState(&backup);
 }
 
 bool ImGui_ImplOpenGL3_CreateFontsTexture()
@@ -512,6 +1149,7 @@ bool    ImGui_ImplOpenGL3_CreateDeviceObjects()
     // Create buffers
     glGenBuffers(1, &g_VboHandle);
     glGenBuffers(1, &g_ElementsHandle);
+    ImGui_ImplOpenGL3_CreateStreamingObjects();
 
     ImGui_ImplOpenGL3_CreateFontsTexture();
 
@@ -519,12 +1157,14 @@ bool    ImGui_ImplOpenGL3_CreateDeviceObjects()
     glBindTexture(GL_TEXTURE_2D, last_texture);
     glBindBuffer(GL_ARRAY_BUFFER, last_array_buffer);
     glBindVertexArray(last_vertex_array);
+    g_StateCache.Known = 0;
 
     return true;
 }
 
 void    ImGui_ImplOpenGL3_DestroyDeviceObjects()
 {
+    ImGui_ImplOpenGL3_DestroyStreamingObjects();
     if (g_VboHandle) glDeleteBuffers(1, &g_VboHandle);
     if (g_ElementsHandle) glDeleteBuffers(1, &g_ElementsHandle);
     g_VboHandle = g_ElementsHandle = 0;
@@ -541,4 +1181,5 @@ void    ImGui_ImplOpenGL3_DestroyDeviceObjects()
     g_ShaderHandle = 0;
 
     ImGui_ImplOpenGL3_DestroyFontsTexture();
+    g_StateCache.Known = 0;
 }
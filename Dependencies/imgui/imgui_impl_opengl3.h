@@ -34,6 +34,39 @@ IMGUI_IMPL_API void     ImGui_ImplOpenGL3_Shutdown();
 IMGUI_IMPL_API void     ImGui_ImplOpenGL3_NewFrame();
 IMGUI_IMPL_API void     ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data);
 
+// Streaming buffers (off by default)
+// Keep a VAO alive with the device objects and upload all command lists of a frame into one fenced region of a ring-buffered VBO/IBO,
+// persistently mapped on GL 4.4 / ARB_buffer_storage, mapped unsynchronized otherwise. Needs GL 3.2 / ARB_sync, silently stays off without it.
+// Device objects are then tied to the GL context that created them: don't enable this when rendering the same backend from several contexts.
+// Changes take effect on the next ImGui_ImplOpenGL3_NewFrame().
+IMGUI_IMPL_API void     ImGui_ImplOpenGL3_SetStreamingBuffers(bool enabled);
+IMGUI_IMPL_API bool     ImGui_ImplOpenGL3_IsStreamingBuffersActive();
+
+// Shadowed state (off by default)
+// For applications that own the GL state: RenderDrawData() stops querying and restoring GL state (~20 glGet* per frame, which may force a
+// pipeline sync on threaded drivers) and skips state changes matching the values it last set. The application must call
+// ImGui_ImplOpenGL3_InvalidateShadowedState() once it changed any GL state itself, and must not rely on its own state surviving RenderDrawData().
+IMGUI_IMPL_API void     ImGui_ImplOpenGL3_SetShadowedState(bool enabled);
+IMGUI_IMPL_API void     ImGui_ImplOpenGL3_InvalidateShadowedState();
+
+// Draw data diffing
+// Hashes each command list of the frame and compares with the previous call. Returns false when the frame would render exactly like the
+// previous one, letting the application skip rendering and presenting it. Call before ImGui_ImplOpenGL3_RenderDrawData(): with streaming
+// buffers active, the hashes let it re-upload only the lists that changed.
+IMGUI_IMPL_API bool     ImGui_ImplOpenGL3_HasDrawDataChanged(ImDrawData* draw_data);
+
+// Counters for the last ImGui_ImplOpenGL3_RenderDrawData() call.
+// With streaming buffers active, commands sharing texture and clip rectangle are merged, so DrawCalls follows state changes rather than command/window count.
+struct ImGui_ImplOpenGL3_RenderStats
+{
+    int     CmdCount;       // Draw commands processed (user callbacks excluded)
+    int     DrawCalls;      // glDraw* calls issued
+    int     UploadedBytes;  // Vertex and index bytes sent to the GPU
+
+    ImGui_ImplOpenGL3_RenderStats() { CmdCount = DrawCalls = UploadedBytes = 0; }
+};
+IMGUI_IMPL_API const ImGui_ImplOpenGL3_RenderStats* ImGui_ImplOpenGL3_GetRenderStats();
+
 // Called by Init/NewFrame/Shutdown
 IMGUI_IMPL_API bool     ImGui_ImplOpenGL3_CreateFontsTexture();
 IMGUI_IMPL_API void     ImGui_ImplOpenGL3_DestroyFontsTexture();
@@ -0,0 +1,247 @@
+// Scoped zone tracing, exported as Chrome Trace Event JSON. See imgui_impl_trace.h.
+
+// CHANGELOG
+//  2026-10-17: Initial version: per-thread lock-free rings, background Chrome Trace Event JSON writer.
+
+#include "imgui_impl_trace.h"
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define IMGUI_IMPL_TRACE_RDTSC
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define IMGUI_IMPL_TRACE_RDTSC
+#endif
+
+static_assert((IMGUI_IMPL_TRACE_RING_SIZE & (IMGUI_IMPL_TRACE_RING_SIZE - 1)) == 0, "IMGUI_IMPL_TRACE_RING_SIZE must be a power of two.");
+
+struct ImGui_ImplTrace_Event
+{
+    const char*         Name;
+    unsigned long long  Start;
+    unsigned long long  End;
+};
+
+// Single producer (the owning thread), single reader (the writer thread). The producer never waits: once the ring is full it
+// overwrites the oldest zone, the reader detects zones overwritten while it copied them by re-reading Head afterwards.
+struct ImGui_ImplTrace_ThreadRing
+{
+    ImGui_ImplTrace_Event               Events[IMGUI_IMPL_TRACE_RING_SIZE];
+    std::atomic<unsigned long long>     Head;           // Number of zones ever recorded
+    std::string                         Name;           // Guarded by g_RingsMutex
+    int                                 Id;
+};
+
+// Data
+static std::atomic<bool>                        g_Enabled(false);
+static std::mutex                               g_RingsMutex;
+static std::vector<ImGui_ImplTrace_ThreadRing*> g_Rings;            // Never freed: threads may exit before the trace gets written
+static std::thread                              g_Writer;
+static std::atomic<bool>                        g_Writing(false);
+static thread_local ImGui_ImplTrace_ThreadRing* g_ThreadRing = NULL;
+
+// Zones are timestamped in ticks: the TSC on x86 (steady_clock costs two to five times as much on some systems, more under virtualization),
+// steady_clock nanoseconds elsewhere. Ticks are converted to nanoseconds against steady_clock when writing the trace.
+static inline unsigned long long ImGui_ImplTrace_SteadyNow()
+{
+    return (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#ifdef IMGUI_IMPL_TRACE_RDTSC
+static inline unsigned long long ImGui_ImplTrace_Now() { return (unsigned long long)__rdtsc(); }
+#else
+static inline unsigned long long ImGui_ImplTrace_Now() { return ImGui_ImplTrace_SteadyNow(); }
+#endif
+
+static unsigned long long g_CalibrationTicks = 0;                   // Set by ImGui_ImplTrace_SetEnabled()
+static unsigned long long g_CalibrationNs = 0;
+
+static ImGui_ImplTrace_ThreadRing* ImGui_ImplTrace_CreateThreadRing()
+{
+    ImGui_ImplTrace_ThreadRing* ring = new ImGui_ImplTrace_ThreadRing();
+    ring->Head.store(0, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(g_RingsMutex);
+    ring->Id = (int)g_Rings.size() + 1;
+    if (g_Rings.empty())
+        ring->Name = "Main";
+    else
+        ring->Name = "Thread " + std::to_string(ring->Id);
+    g_Rings.push_back(ring);
+    return ring;
+}
+
+static inline ImGui_ImplTrace_ThreadRing* ImGui_ImplTrace_GetThreadRing()
+{
+    if (g_ThreadRing == NULL)
+        g_ThreadRing = ImGui_ImplTrace_CreateThreadRing();
+    return g_ThreadRing;
+}
+
+void ImGui_ImplTrace_SetEnabled(bool enabled)
+{
+    if (enabled && g_CalibrationNs == 0)
+    {
+        g_CalibrationTicks = ImGui_ImplTrace_Now();
+        g_CalibrationNs = ImGui_ImplTrace_SteadyNow();
+    }
+    g_Enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool ImGui_ImplTrace_IsEnabled()
+{
+    return g_Enabled.load(std::memory_order_relaxed);
+}
+
+void ImGui_ImplTrace_SetThreadName(const char* name)
+{
+    ImGui_ImplTrace_ThreadRing* ring = ImGui_ImplTrace_GetThreadRing();
+    std::lock_guard<std::mutex> lock(g_RingsMutex);
+    ring->Name = name;
+}
+
+// The ring is looked up once (a thread local access), the destructor only reads the clock and writes the zone.
+ImGui_ImplTrace_Zone::ImGui_ImplTrace_Zone(const char* name)
+{
+    Name = name;
+    if (g_Enabled.load(std::memory_order_relaxed))
+    {
+        Ring = ImGui_ImplTrace_GetThreadRing();
+        Start = ImGui_ImplTrace_Now();
+    }
+    else
+    {
+        Ring = NULL;
+    }
+}
+
+ImGui_ImplTrace_Zone::~ImGui_ImplTrace_Zone()
+{
+    ImGui_ImplTrace_ThreadRing* ring = Ring;
+    if (ring == NULL)
+        return;
+
+    // The zone is complete before it is written: one copy of the whole record, then publish it.
+    const ImGui_ImplTrace_Event event = { Name, Start, ImGui_ImplTrace_Now() };
+    const unsigned long long head = ring->Head.load(std::memory_order_relaxed);
+    ring->Events[head & (IMGUI_IMPL_TRACE_RING_SIZE - 1)] = event;
+    ring->Head.store(head + 1, std::memory_order_release);
+}
+
+static void ImGui_ImplTrace_WriteString(FILE* f, const char* s)
+{
+    fputc('"', f);
+    for (; *s; s++)
+    {
+        if (*s == '"' || *s == '\\')
+            fputc('\\', f);
+        if ((unsigned char)*s >= 0x20)
+            fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+static void ImGui_ImplTrace_Write(std::string filename)
+{
+    struct RingInfo { ImGui_ImplTrace_ThreadRing* Ring; std::string Name; int Id; };
+    std::vector<RingInfo> rings;
+    {
+        std::lock_guard<std::mutex> lock(g_RingsMutex);
+        for (ImGui_ImplTrace_ThreadRing* ring : g_Rings)
+            rings.push_back({ ring, ring->Name, ring->Id });
+    }
+
+    // Copy every ring first, so the file covers roughly the same time span on all threads.
+    std::vector<std::vector<ImGui_ImplTrace_Event>> events(rings.size());
+    unsigned long long base = ~0ull;
+    for (size_t i = 0; i < rings.size(); i++)
+    {
+        ImGui_ImplTrace_ThreadRing* ring = rings[i].Ring;
+        const unsigned long long size = IMGUI_IMPL_TRACE_RING_SIZE;
+        unsigned long long head = ring->Head.load(std::memory_order_acquire);
+        unsigned long long first = head > size ? head - size : 0;
+
+        std::vector<ImGui_ImplTrace_Event>& copy = events[i];
+        copy.resize((size_t)(head - first));
+        for (unsigned long long n = first; n < head; n++)
+            copy[(size_t)(n - first)] = ring->Events[n & (size - 1)];
+
+        // The producer kept going while we copied: zones up to (new head - size) were overwritten, or are being written to.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        unsigned long long newHead = ring->Head.load(std::memory_order_relaxed);
+        if (newHead >= size && newHead - size + 1 > first)
+        {
+            size_t overwritten = (size_t)(newHead - size + 1 - first);
+            copy.erase(copy.begin(), copy.begin() + (overwritten < copy.size() ? overwritten : copy.size()));
+        }
+
+        // Zones are in order of completion, an enclosing zone may have started before the first one.
+        for (const ImGui_ImplTrace_Event& event : copy)
+            if (event.Start < base)
+                base = event.Start;
+    }
+
+    // Ticks per nanosecond since tracing was first enabled, the longer the program ran the more accurate.
+    double ns_per_tick = 1.0;
+    unsigned long long now_ticks = ImGui_ImplTrace_Now(), now_ns = ImGui_ImplTrace_SteadyNow();
+    if (now_ticks > g_CalibrationTicks && now_ns > g_CalibrationNs)
+        ns_per_tick = (double)(now_ns - g_CalibrationNs) / (double)(now_ticks - g_CalibrationTicks);
+
+    FILE* f = fopen(filename.c_str(), "wb");
+    if (f == NULL)
+    {
+        fprintf(stderr, "ImGui_ImplTrace: failed to open %s for writing.\n", filename.c_str());
+        g_Writing.store(false);
+        return;
+    }
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", f);
+    bool first_event = true;
+    for (size_t i = 0; i < rings.size(); i++)
+    {
+        fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", first_event ? "" : ",\n", rings[i].Id);
+        ImGui_ImplTrace_WriteString(f, rings[i].Name.c_str());
+        fputs("}}", f);
+        first_event = false;
+
+        // Timestamps are in microseconds, keep the nanoseconds as decimals.
+        for (const ImGui_ImplTrace_Event& event : events[i])
+        {
+            fputs(",\n{\"name\":", f);
+            ImGui_ImplTrace_WriteString(f, event.Name);
+            fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", rings[i].Id, (double)(event.Start - base) * ns_per_tick / 1000.0, (double)(event.End - event.Start) * ns_per_tick / 1000.0);
+        }
+    }
+    fputs("\n]}\n", f);
+    fclose(f);
+
+    g_Writing.store(false);
+}
+
+bool ImGui_ImplTrace_WriteFile(const char* filename)
+{
+    if (g_Writing.exchange(true))
+        return false;
+
+    if (g_Writer.joinable())
+        g_Writer.join();
+    g_Writer = std::thread(ImGui_ImplTrace_Write, std::string(filename));
+    return true;
+}
+
+bool ImGui_ImplTrace_IsWriting()
+{
+    return g_Writing.load();
+}
+
+void ImGui_ImplTrace_Shutdown()
+{
+    if (g_Writer.joinable())
+        g_Writer.join();
+}
@@ -0,0 +1,52 @@
+// Scoped zone tracing for the application and the ImGui backends, exported as Chrome Trace Event JSON.
+// Open the files in chrome://tracing or https://ui.perfetto.dev (which reads the JSON format as well).
+
+// Each thread records completed zones into its own fixed size ring buffer, lock-free: a zone costs two clock reads,
+// one thread local lookup and one record write, so tracing can stay enabled in production. A disabled zone only does a
+// relaxed load. The rings keep the most recent zones of each thread (flight recorder style), ImGui_ImplTrace_WriteFile()
+// copies them from a background thread without stopping the producers. Run the "trace" benchmark for the cost on your machine.
+
+// Zone names are stored by pointer: they must outlive the trace, use string literals (or __FUNCTION__).
+
+#pragma once
+
+#include "imgui.h"
+
+// Capacity of each thread's ring, in zones. Must be a power of two.
+#ifndef IMGUI_IMPL_TRACE_RING_SIZE
+#define IMGUI_IMPL_TRACE_RING_SIZE  (1 << 16)
+#endif
+
+IMGUI_IMPL_API void     ImGui_ImplTrace_SetEnabled(bool enabled);
+IMGUI_IMPL_API bool     ImGui_ImplTrace_IsEnabled();
+
+// Names the calling thread in the trace (the first thread to record a zone is "Main" unless named).
+IMGUI_IMPL_API void     ImGui_ImplTrace_SetThreadName(const char* name);
+
+// Writes the zones currently in the rings to 'filename' from a background thread. Returns false if a previous write is still running.
+IMGUI_IMPL_API bool     ImGui_ImplTrace_WriteFile(const char* filename);
+IMGUI_IMPL_API bool     ImGui_ImplTrace_IsWriting();
+
+// Waits for a pending write. Call before exiting.
+IMGUI_IMPL_API void     ImGui_ImplTrace_Shutdown();
+
+// Records the lifetime of the object as a zone of the calling thread.
+struct ImGui_ImplTrace_ThreadRing;
+struct IMGUI_IMPL_API ImGui_ImplTrace_Zone
+{
+    ImGui_ImplTrace_ThreadRing* Ring;                   // Ring of the calling thread, NULL when tracing was disabled at the start of the zone
+    const char*                 Name;
+    unsigned long long          Start;
+
+    ImGui_ImplTrace_Zone(const char* name);
+    ~ImGui_ImplTrace_Zone();
+};
+
+#define IMGUI_TRACE_CONCAT_IMPL(_A, _B)     _A##_B
+#define IMGUI_TRACE_CONCAT(_A, _B)          IMGUI_TRACE_CONCAT_IMPL(_A, _B)
+#ifndef IMGUI_DISABLE_TRACE
+#define IMGUI_TRACE_ZONE(_NAME)             ImGui_ImplTrace_Zone IMGUI_TRACE_CONCAT(trace_zone_, __LINE__)(_NAME)
+#else
+#define IMGUI_TRACE_ZONE(_NAME)
+#endif
+#define IMGUI_TRACE_FUNCTION()              IMGUI_TRACE_ZONE(__FUNCTION__)
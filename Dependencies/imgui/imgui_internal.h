@@ -16,6 +16,24 @@
 #include <stdlib.h>     // NULL, malloc, free, qsort, atoi, atof
 #include <math.h>       // sqrtf, fabsf, fmodf, powf, floorf, ceilf, cosf, sinf
 #include <limits.h>     // INT_MIN, INT_MAX
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>     // _BitScanForward
+#endif
+
+// SIMD code paths, selected at compile time (define IMGUI_DISABLE_SIMD to only use the scalar code)
+#ifndef IMGUI_DISABLE_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMGUI_ENABLE_SSE2
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#define IMGUI_ENABLE_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define IMGUI_ENABLE_NEON
+#include <arm_neon.h>
+#endif
+#endif
 
 #ifdef _MSC_VER
 #pragma warning (push)
@@ -87,6 +105,7 @@ namespace ImGuiStb
 #ifndef GImGui
 extern IMGUI_API ImGuiContext* GImGui;  // Current implicit ImGui context pointer
 #endif
+extern IMGUI_API int GImFontLookupGeneration;   // Incremented whenever glyph advances may have changed (invalidates ImGuiTextLayoutCache)
 
 //-----------------------------------------------------------------------------
 // Helpers
@@ -116,6 +135,7 @@ IMGUI_API int           ImTextStrFromUtf8(ImWchar* buf, int buf_size, const char
 IMGUI_API int           ImTextCountCharsFromUtf8(const char* in_text, const char* in_text_end);                            // return number of UTF-8 code-points (NOT bytes count)
 IMGUI_API int           ImTextCountUtf8BytesFromChar(const char* in_text, const char* in_text_end);                        // return number of bytes to express one char in UTF-8
 IMGUI_API int           ImTextCountUtf8BytesFromStr(const ImWchar* in_text, const ImWchar* in_text_end);                   // return number of bytes to express string in UTF-8
+IMGUI_API int           ImTextCountPrintableAscii(const char* in_text, const char* in_text_end);                           // return number of leading 0x20..0x7F bytes, which need neither UTF-8 decoding nor control character handling
 
 // Helpers: Misc
 IMGUI_API ImU32         ImHash(const void* data, int data_size, ImU32 seed = 0);    // Pass data_size==0 for zero-terminated strings
@@ -125,6 +145,12 @@ static inline bool      ImCharIsBlankA(char c)          { return c == ' ' || c =
 static inline bool      ImCharIsBlankW(unsigned int c)  { return c == ' ' || c == '\t' || c == 0x3000; }
 static inline bool      ImIsPowerOfTwo(int v)           { return v != 0 && (v & (v - 1)) == 0; }
 static inline int       ImUpperPowerOfTwo(int v)        { v--; v |= v >> 1; v |= v >> 2; v |= v >> 4; v |= v >> 8; v |= v >> 16; v++; return v; }
+#if defined(_MSC_VER) && !defined(__clang__)
+static inline int       ImCountTrailingZeros(unsigned int v)    { unsigned long n; _BitScanForward(&n, v); return (int)n; }    // v must not be 0
+#else
+static inline int       ImCountTrailingZeros(unsigned int v)    { return __builtin_ctz(v); }                                   // v must not be 0
+#endif
+static inline int       ImCountTrailingZeros64(unsigned long long v) { return (v & 0xFFFFFFFFu) ? ImCountTrailingZeros((unsigned int)v) : 32 + ImCountTrailingZeros((unsigned int)(v >> 32)); }
 #define ImQsort         qsort
 
 // Helpers: Geometry
@@ -449,13 +475,21 @@ struct IMGUI_API ImGuiMenuColumns
 };
 
 // Internal state of the currently focused/edited text input box
+// The text is kept in gap buffers, in wchar (for stb_textedit) and UTF-8 (to write back to the user buffer), with the gap at the last edit:
+// an edit only moves the text between the previous edit and this one. Line starts are kept on each side of the gap the same way,
+// so the line of a position is found with a binary search instead of counting from the start of the text.
 struct IMGUI_API ImGuiInputTextState
 {
     ImGuiID                 ID;                     // widget id owning the text state
-    ImVector<ImWchar>       TextW;                  // edit buffer, we need to persist but can't guarantee the persistence of the user-provided buffer. so we copy into own buffer.
+    ImVector<ImWchar>       TextW;                  // edit buffer, we need to persist but can't guarantee the persistence of the user-provided buffer. so we copy into own buffer. TextW[0..GapPosW) then the text after the gap at the end. size=capacity.
+    ImVector<char>          TextA;                  // UTF-8 copy of TextW, TextA[0..GapPosA) then the text after the gap at the end. size=capacity.
     ImVector<char>          InitialText;            // backup of end-user buffer at the time of focus (in UTF-8, unaltered)
     ImVector<char>          TempBuffer;             // temporary buffer for callback and other other operations. size=capacity.
     int                     CurLenA, CurLenW;       // we need to maintain our buffer length in both UTF-8 and wchar format.
+    int                     GapPosA, GapPosW;       // position of the gap, in both UTF-8 and wchar format
+    ImVector<int>           LinesBeforeGap;         // start of every line but the first up to the gap, ascending
+    ImVector<int>           LinesAfterGap;          // start of every line after the gap as a distance from the end of the text, ascending (so the line closest to the gap is last)
+    int                     UserBufDirtyA;          // UTF-8 offset from which the end-user buffer is out of date, -1 when up to date
     int                     BufCapacityA;           // end-user buffer capacity
     float                   ScrollX;
     ImGuiStb::STB_TexteditState StbState;
@@ -475,6 +509,19 @@ struct IMGUI_API ImGuiInputTextState
     void                ClearSelection()            { StbState.select_start = StbState.select_end = StbState.cursor; }
     void                SelectAll()                 { StbState.select_start = 0; StbState.cursor = StbState.select_end = CurLenW; StbState.has_preferred_x = false; }
     void                OnKeyPressed(int key);      // Cannot be inline because we call in code in stb_textedit.h implementation
+
+    // Text access. After writing CurLenW characters to TextW[0..CurLenW) directly, call OnTextReplaced().
+    ImWchar             GetCharW(int idx) const     { return TextW.Data[idx < GapPosW ? idx : idx + TextW.Size - CurLenW]; }
+    int                 GetLineCount() const        { return 1 + LinesBeforeGap.Size + LinesAfterGap.Size; }
+    int                 GetLineStart(int line) const { return line == 0 ? 0 : line <= LinesBeforeGap.Size ? LinesBeforeGap[line - 1] : CurLenW - LinesAfterGap[LinesAfterGap.Size - (line - LinesBeforeGap.Size)]; }
+    int                 GetLineIndex(int idx) const;
+    int                 GetPosA(int idx) const;                             // UTF-8 offset of character 'idx'
+    bool                CopyTextA(char* dst, int begin_a, int end_a) const; // copy bytes [begin_a, end_a) of the UTF-8 text to dst+begin_a, return false if they were already there
+    int                 GetTextUtf8(char* dst, int dst_size, int begin, int end) const; // convert characters [begin, end) to UTF-8, zero-terminated
+    void                OnTextReplaced();
+    void                MoveGap(int idx);
+    void                DeleteChars(int pos, int n);
+    void                InsertChars(int pos, const ImWchar* new_text, int new_text_len, int new_text_len_utf8);
 };
 
 // Windows data saved in imgui.ini file
@@ -554,6 +601,13 @@ struct ImGuiColumnsSet
     }
 };
 
+// Segment count of circles and arcs drawn without a specific number of segments (AddCircle(), AddCircleFilled(), PathArcTo(), rounded corners).
+// The smallest count keeping the segments within _MAXERROR pixels of the true circle, rounded up to a multiple of 4 so quarter arcs land on table entries.
+#define IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MIN                     12
+#define IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MAX                     512
+#define IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_CALC(_RAD,_MAXERROR)    ImClamp((((int)ImCeil(IM_PI / ImAcos(1.0f - ImMin((_MAXERROR), (_RAD)) / (_RAD))) + 3) & ~3), IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MIN, IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MAX)
+#define IM_DRAWLIST_CIRCLE_TABLE_SEGMENT_MAX                    256     // Automatic counts up to this one have a unit circle table (~66 KB), larger ones (radius of thousands of pixels) are computed
+
 // Data shared between all ImDrawList instances
 struct IMGUI_API ImDrawListSharedData
 {
@@ -561,13 +615,23 @@ struct IMGUI_API ImDrawListSharedData
     ImFont*         Font;                       // Current/default font (optional, for simplified AddText overload)
     float           FontSize;                   // Current/default font size (optional, for simplified AddText overload)
     float           CurveTessellationTol;
+    float           CircleSegmentMaxError;      // Number of pixels circles may deviate from the true circle, see SetCircleSegmentMaxError()
     ImVec4          ClipRectFullscreen;         // Value for PushClipRectFullscreen()
 
     // Const data
     // FIXME: Bake rounded corners fill/borders in atlas
     ImVec2          CircleVtx12[12];
+    unsigned short  CircleSegmentCounts[64];    // Precomputed segment count for radius 0..63 (rounded up), larger ones are calculated with IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_CALC()
+
+    // Unit circle tables of the automatic segment counts (multiples of 4 from IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MIN to IM_DRAWLIST_CIRCLE_TABLE_SEGMENT_MAX), built once by the constructor and read only after that.
+    // Entry i of the N segments table is (cos(2*PI*i/N), sin(2*PI*i/N)).
+    ImVector<ImVec2> CircleVtxTables;
+    int             CircleVtxTableOffsets[IM_DRAWLIST_CIRCLE_TABLE_SEGMENT_MAX / 4 + 1]; // Offset of the table of N segments in CircleVtxTables at [N/4]
 
     ImDrawListSharedData();
+    void            SetCircleSegmentMaxError(float max_error);
+    int             CalcCircleSegmentCount(float radius) const      { radius = ImFabs(radius); return (radius < (float)(IM_ARRAYSIZE(CircleSegmentCounts) - 1)) ? CircleSegmentCounts[(int)ImCeil(radius)] : IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_CALC(radius, CircleSegmentMaxError); }
+    const ImVec2*   GetCircleVtx(int num_segments) const            { return ((num_segments & 3) == 0 && num_segments >= IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MIN && num_segments <= IM_DRAWLIST_CIRCLE_TABLE_SEGMENT_MAX) ? CircleVtxTables.Data + CircleVtxTableOffsets[num_segments >> 2] : NULL; } // NULL when there is no table for this count
 };
 
 struct ImDrawDataBuilder
@@ -579,6 +643,45 @@ struct ImDrawDataBuilder
     IMGUI_API void FlattenIntoSingleLayer();
 };
 
+// Cache of CalcTextSize() results. Entries are evicted least recently used first, but never in the frame they were used in.
+#ifndef IMGUI_TEXT_LAYOUT_CACHE_SIZE
+#define IMGUI_TEXT_LAYOUT_CACHE_SIZE        2048    // Number of measured strings kept. 0 disables the cache.
+#endif
+#ifndef IMGUI_TEXT_LAYOUT_CACHE_MIN_LENGTH
+#define IMGUI_TEXT_LAYOUT_CACHE_MIN_LENGTH  16      // Shorter strings are measured faster than they are hashed, unless they are word-wrapped.
+#endif
+
+struct ImGuiTextLayout
+{
+    ImGuiID         Key;                // Hash of the text, seeded with Font, FontSize and WrapWidth
+    ImFont*         Font;
+    float           FontSize;
+    float           WrapWidth;
+    int             TextLength;
+    ImVec2          Size;               // CalcTextSize() result
+    ImVector<int>   LineBreaks;         // Word-wrapping end of each line, as offsets in the text. Reused by RenderTextWrapped().
+    int             LastFrameUsed;
+    int             LruPrev, LruNext;   // Neighbor entries in the recently used list, -1 at the ends
+};
+
+struct IMGUI_API ImGuiTextLayoutCache
+{
+    ImVector<ImGuiTextLayout>   Entries;            // Allocated on first use and never resized, entries own their LineBreaks
+    ImVector<int>               Slots;              // Open addressing with linear probing: index into Entries or -1. Size is a power of two.
+    int                         Count;              // Entries in use, Entries[0..Count-1]
+    int                         LruHead, LruTail;   // Most and least recently used entries
+    int                         FontGeneration;     // GImFontLookupGeneration the entries were measured with
+    int                         FrameHits, FrameMisses;
+    int                         LastFrameHits, LastFrameMisses;
+
+    ImGuiTextLayoutCache()      { Count = 0; LruHead = LruTail = -1; FontGeneration = 0; FrameHits = FrameMisses = LastFrameHits = LastFrameMisses = 0; }
+    ~ImGuiTextLayoutCache()     { ClearFreeMemory(); }
+    void                        Clear();
+    void                        ClearFreeMemory();
+    ImGuiTextLayout*            Find(ImGuiID key, ImFont* font, float font_size, float wrap_width, int text_length, int frame_count);
+    ImGuiTextLayout*            Add(ImGuiID key, ImFont* font, float font_size, float wrap_width, int text_length, int frame_count); // NULL if every entry was used this frame
+};
+
 struct ImGuiNavMoveResult
 {
     ImGuiID       ID;           // Best candidate
@@ -644,15 +747,18 @@ struct ImGuiContext
     float                   FontSize;                           // (Shortcut) == FontBaseSize * g.CurrentWindow->FontWindowScale == window->FontSize(). Text height for current window.
     float                   FontBaseSize;                       // (Shortcut) == IO.FontGlobalScale * Font->Scale * Font->FontSize. Base text height.
     ImDrawListSharedData    DrawListSharedData;
+    ImGuiTextLayoutCache    TextLayoutCache;                    // CalcTextSize() results, with their word-wrapping line breaks
 
     double                  Time;
     int                     FrameCount;
     int                     FrameCountEnded;
     int                     FrameCountRendered;
-    ImVector<ImGuiWindow*>  Windows;
+    ImVector<ImGuiWindow*>  Windows;                            // Windows, sorted in display order, back to front
     ImVector<ImGuiWindow*>  WindowsSortBuffer;
+    bool                    WindowsIdxDirty;                    // Windows were moved since ImGuiWindow::WindowsIdx were last updated
+    ImVector<ImGuiWindow*>  WindowsNavFocusable;                // Windows that were nav focusable when WindowsIdx were last updated, in the same order as Windows (for CTRL+TAB)
     ImVector<ImGuiWindow*>  CurrentWindowStack;
-    ImGuiStorage            WindowsById;
+    ImGuiStorage            WindowsById;                        // Hash indexed
     int                     WindowsActiveCount;
     ImGuiWindow*            CurrentWindow;                      // Being drawn into
     ImGuiWindow*            HoveredWindow;                      // Will catch mouse inputs
@@ -771,6 +877,7 @@ struct ImGuiContext
     ImGuiTextBuffer                SettingsIniData;             // In memory .ini settings
     ImVector<ImGuiSettingsHandler> SettingsHandlers;            // List of .ini settings handlers
     ImVector<ImGuiWindowSettings>  SettingsWindows;             // ImGuiWindow .ini settings entries (parsed from the last loaded .ini file and maintained on saving)
+    ImGuiStorage                   SettingsWindowsIdx;          // Map window ID to index into SettingsWindows[], hash indexed
 
     // Logging
     bool                    LogEnabled;
@@ -800,6 +907,8 @@ struct ImGuiContext
         Time = 0.0f;
         FrameCount = 0;
         FrameCountEnded = FrameCountRendered = -1;
+        WindowsIdxDirty = false;
+        WindowsById.SetHashIndexed(true);
         WindowsActiveCount = 0;
         CurrentWindow = NULL;
         HoveredWindow = NULL;
@@ -879,6 +988,7 @@ struct ImGuiContext
 
         SettingsLoaded = false;
         SettingsDirtyTimer = 0.0f;
+        SettingsWindowsIdx.SetHashIndexed(true);
 
         LogEnabled = false;
         LogFile = NULL;
@@ -1045,6 +1155,7 @@ struct IMGUI_API ImGuiWindow
     ImVector<ImGuiColumnsSet> ColumnsStorage;
     float                   FontWindowScale;                    // User scale multiplier per-window
     int                     SettingsIdx;                        // Index into SettingsWindow[] (indices are always valid as we only grow the array from the back)
+    int                     WindowsIdx;                         // Index into g.Windows[], only a sort key (increasing along g.Windows[]) while g.WindowsIdxDirty is set
 
     ImDrawList*             DrawList;                           // == &DrawListInst (for backward compatibility reason with code using imgui_internal.h we keep this a pointer)
     ImDrawList              DrawListInst;
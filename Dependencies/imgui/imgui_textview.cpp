@@ -0,0 +1,303 @@
+// imgui_textview.cpp
+// Read-only viewer for very large, growing texts. See imgui_textview.h.
+
+#include "imgui.h"
+#include "imgui_textview.h"
+#include "imgui_internal.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+ImGuiTextDocument::ImGuiTextDocument()
+{
+    LineCount = 0;
+    TextSize = 0;
+    MappedData = NULL;
+    MappedSize = 0;
+}
+
+ImGuiTextDocument::~ImGuiTextDocument()
+{
+    Clear();
+}
+
+static void FreeChunk(ImGuiTextDocument::Chunk* chunk)
+{
+    if (chunk->Capacity > 0)
+        ImGui::MemFree(chunk->Data);
+    IM_DELETE(chunk);
+}
+
+void ImGuiTextDocument::Clear()
+{
+    for (int n = 0; n < Chunks.Size; n++)
+        FreeChunk(Chunks[n]);
+    Chunks.clear();
+    Unmap();
+    LineCount = 0;
+    TextSize = 0;
+}
+
+void ImGuiTextDocument::Unmap()
+{
+    if (MappedData == NULL)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(MappedData);
+#else
+    munmap(MappedData, MappedSize);
+#endif
+    MappedData = NULL;
+    MappedSize = 0;
+}
+
+ImGuiTextDocument::Chunk* ImGuiTextDocument::AddChunk(unsigned int capacity)
+{
+    Chunk* chunk = IM_NEW(Chunk)();
+    chunk->Data = capacity > 0 ? (char*)ImGui::MemAlloc(capacity) : NULL;
+    chunk->Size = chunk->IndexedSize = 0;
+    chunk->Capacity = capacity;
+    chunk->FirstLine = LineCount;
+    Chunks.push_back(chunk);
+    return chunk;
+}
+
+// Records the lines starting in [IndexedSize, end).
+void ImGuiTextDocument::IndexChunk(Chunk* chunk, unsigned int end)
+{
+    const char* data = chunk->Data;
+    const char* p = data + chunk->IndexedSize;
+    const char* p_end = data + end;
+    while ((p = (const char*)memchr(p, '\n', (size_t)(p_end - p))) != NULL)
+    {
+        p++;
+        chunk->LineStarts.push_back((unsigned int)(p - data));
+        LineCount++;
+    }
+    chunk->IndexedSize = end;
+}
+
+bool ImGuiTextDocument::Index(size_t max_bytes)
+{
+    if (IsIndexed())
+        return true;
+    Chunk* chunk = Chunks[0];
+    size_t end = chunk->IndexedSize + ImMin(max_bytes, (size_t)(chunk->Size - chunk->IndexedSize));
+    IndexChunk(chunk, (unsigned int)end);
+    return IsIndexed();
+}
+
+void ImGuiTextDocument::Append(const char* text, const char* text_end)
+{
+    if (text_end == NULL)
+        text_end = text + strlen(text);
+    if (text == text_end)
+        return;
+
+    // The last line may move to another chunk, every line before it must be known.
+    Index((size_t)-1);
+    TextSize += (size_t)(text_end - text);
+
+    while (text < text_end)
+    {
+        Chunk* chunk = Chunks.Size > 0 ? Chunks.back() : NULL;
+        if (chunk == NULL || chunk->Size >= chunk->Capacity)
+        {
+            // Start a new chunk and move the unfinished last line into it, so it stays contiguous. A line longer than
+            // half a chunk gets a chunk twice its size: moving it again only happens after it doubled.
+            Chunk* prev = chunk;
+            unsigned int tail = prev ? prev->LineStarts.back() : 0;
+            unsigned int tail_size = prev ? prev->Size - tail : 0;
+            size_t capacity = ImMax((size_t)IMGUI_TEXT_DOCUMENT_CHUNK_SIZE, (size_t)tail_size * 2);
+            IM_ASSERT(capacity <= 0xFFFFFFFFu && "Lines must be shorter than 2 GB.");
+            if (prev)
+            {
+                prev->LineStarts.pop_back();
+                prev->Size = prev->IndexedSize = tail;
+                LineCount--;
+            }
+            chunk = AddChunk((unsigned int)capacity);
+            chunk->LineStarts.push_back(0);
+            LineCount++;
+            if (prev)
+            {
+                memcpy(chunk->Data, prev->Data + tail, tail_size);
+                chunk->Size = chunk->IndexedSize = tail_size;
+                if (prev->LineStarts.Size == 0)
+                {
+                    // The line was all the previous chunk held.
+                    Chunks.erase(Chunks.Data + Chunks.Size - 2);
+                    if (prev->Data == MappedData)
+                        Unmap();
+                    FreeChunk(prev);
+                }
+            }
+        }
+
+        unsigned int copy_size = (unsigned int)ImMin((size_t)(text_end - text), (size_t)(chunk->Capacity - chunk->Size));
+        memcpy(chunk->Data + chunk->Size, text, copy_size);
+        chunk->Size += copy_size;
+        IndexChunk(chunk, chunk->Size);
+        text += copy_size;
+    }
+}
+
+void ImGuiTextDocument::Appendf(const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    va_list args_copy;
+    va_copy(args_copy, args);
+
+    char buf[1024];
+    int len = vsnprintf(buf, IM_ARRAYSIZE(buf), fmt, args);
+    if (len >= IM_ARRAYSIZE(buf))
+    {
+        char* heap_buf = (char*)ImGui::MemAlloc((size_t)len + 1);
+        vsnprintf(heap_buf, (size_t)len + 1, fmt, args_copy);
+        Append(heap_buf, heap_buf + len);
+        ImGui::MemFree(heap_buf);
+    }
+    else if (len > 0)
+    {
+        Append(buf, buf + len);
+    }
+
+    va_end(args_copy);
+    va_end(args);
+}
+
+bool ImGuiTextDocument::MapFile(const char* filename)
+{
+    Clear();
+
+    void* data = NULL;
+    size_t size = 0;
+#ifdef _WIN32
+    int filename_wsize = MultiByteToWideChar(CP_UTF8, 0, filename, -1, NULL, 0);
+    ImVector<wchar_t> filename_w;
+    filename_w.resize(filename_wsize > 0 ? filename_wsize : 1);
+    filename_w[0] = 0;
+    MultiByteToWideChar(CP_UTF8, 0, filename, -1, filename_w.Data, filename_w.Size);
+    HANDLE file = CreateFileW(filename_w.Data, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart >= 0xFFFFFFFF)
+    {
+        CloseHandle(file);
+        return false;
+    }
+    size = (size_t)file_size.QuadPart;
+    if (size > 0)
+    {
+        // The view keeps the file mapped after both handles are closed.
+        HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL)
+        {
+            data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (unsigned long long)st.st_size >= 0xFFFFFFFFull)
+    {
+        close(fd);
+        return false;
+    }
+    size = (size_t)st.st_size;
+    if (size > 0)
+    {
+        data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+            data = NULL;
+    }
+    close(fd);
+#endif
+    if (size == 0)
+        return true;
+    if (data == NULL)
+        return false;
+
+    MappedData = data;
+    MappedSize = size;
+    Chunk* chunk = AddChunk(0);
+    chunk->Data = (char*)data;
+    chunk->Size = (unsigned int)size;
+    chunk->LineStarts.push_back(0);
+    LineCount = 1;
+    TextSize = size;
+    return true;
+}
+
+const char* ImGuiTextDocument::GetLine(int line, const char** out_line_end) const
+{
+    IM_ASSERT(line >= 0 && line < LineCount);
+
+    // Last chunk starting at or before the line.
+    int lo = 0, hi = Chunks.Size - 1;
+    while (lo < hi)
+    {
+        int mid = (lo + hi + 1) / 2;
+        if (Chunks[mid]->FirstLine <= line)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+
+    const Chunk* chunk = Chunks[lo];
+    int n = line - chunk->FirstLine;
+    if (n + 1 < chunk->LineStarts.Size)
+        *out_line_end = chunk->Data + chunk->LineStarts[n + 1] - 1;
+    else if (lo + 1 < Chunks.Size)
+        *out_line_end = chunk->Data + chunk->Size - 1;
+    else
+        *out_line_end = chunk->Data + chunk->IndexedSize;
+    return chunk->Data + chunk->LineStarts[n];
+}
+
+void ImGui::TextView(const char* str_id, ImGuiTextDocument* doc, const ImVec2& size)
+{
+    doc->Index(IMGUI_TEXT_DOCUMENT_INDEX_BUDGET);
+
+    BeginChild(str_id, size, false, ImGuiWindowFlags_HorizontalScrollbar);
+
+    // The scroll range is last frame's: if we were at the bottom then, keep following the lines appended since.
+    // Otherwise leave the scroll alone, appending never moves the lines already shown.
+    const bool follow_tail = GetScrollY() >= GetScrollMaxY();
+
+    // Lines back to back, at a fixed height the clipper can seek to without measuring anything.
+    PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(GetStyle().ItemSpacing.x, 0.0f));
+    ImGuiListClipper clipper(doc->GetLineCount(), GetTextLineHeight());
+    while (clipper.Step())
+        for (int line_no = clipper.DisplayStart; line_no < clipper.DisplayEnd; line_no++)
+        {
+            const char* line_end;
+            const char* line = doc->GetLine(line_no, &line_end);
+            TextUnformatted(line, line_end);
+        }
+    PopStyleVar();
+
+    if (follow_tail)
+        SetScrollHere(1.0f);
+    EndChild();
+}
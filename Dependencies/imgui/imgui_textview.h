@@ -0,0 +1,76 @@
+// imgui_textview.h
+// Read-only viewer for very large, growing texts (log consoles of hundreds of MB, memory-mapped files).
+
+// ImGuiTextDocument stores text in append-only chunks and indexes the start of every line as the text comes in, so
+// appending never rescans what is already there and any line is found in O(log chunks). ImGui::TextView() uses the
+// index with ImGuiListClipper: a frame costs O(visible lines), whatever the size of the document.
+// Lines never straddle two chunks, a line can be handed to ImGui as a single contiguous range.
+
+// Changelog:
+// - v0.10: Initial version. ImGuiTextDocument (chunked append-only storage, incremental line index, memory-mapped files), TextView().
+
+#pragma once
+
+#include "imgui.h"
+
+// Size of the chunks text is appended to, in bytes. Longer lines get a chunk of their own.
+#ifndef IMGUI_TEXT_DOCUMENT_CHUNK_SIZE
+#define IMGUI_TEXT_DOCUMENT_CHUNK_SIZE          (4 << 20)
+#endif
+
+// Amount of a memory-mapped file indexed by each TextView() call, in bytes. Spreads the indexing of a large file over several frames.
+#ifndef IMGUI_TEXT_DOCUMENT_INDEX_BUDGET
+#define IMGUI_TEXT_DOCUMENT_INDEX_BUDGET        (16 << 20)
+#endif
+
+struct ImGuiTextDocument
+{
+    struct Chunk
+    {
+        char*                   Data;
+        unsigned int            Size;           // Bytes of text in Data
+        unsigned int            Capacity;       // 0 for the memory-mapped chunk
+        unsigned int            IndexedSize;    // Bytes of text scanned for new lines, Size except while a mapped file is being indexed
+        int                     FirstLine;      // Document line number of LineStarts[0]
+        ImVector<unsigned int>  LineStarts;     // Offset in Data of each line starting in this chunk
+    };
+
+    ImVector<Chunk*>            Chunks;
+    int                         LineCount;
+    size_t                      TextSize;
+    void*                       MappedData;     // Start of the memory-mapped file, Chunks[0]->Data while mapped
+    size_t                      MappedSize;
+
+    ImGuiTextDocument();
+    ~ImGuiTextDocument();
+
+    IMGUI_API void              Clear();
+    IMGUI_API void              Append(const char* text, const char* text_end = NULL);
+    IMGUI_API void              Appendf(const char* fmt, ...) IM_FMTARGS(2);
+
+    // Replaces the content with a read-only mapping of the file, text appended afterwards goes into regular chunks.
+    // Files of 4 GB or more are refused. The line index is built by Index(), lines become visible as it progresses.
+    IMGUI_API bool              MapFile(const char* filename);
+
+    // Scans up to 'max_bytes' of the mapped file for new lines, returns true once the whole document is indexed.
+    IMGUI_API bool              Index(size_t max_bytes);
+    bool                        IsIndexed() const       { return Chunks.Size == 0 || Chunks[0]->IndexedSize == Chunks[0]->Size; }
+
+    int                         GetLineCount() const    { return LineCount; }
+    size_t                      GetTextSize() const     { return TextSize; }
+
+    // Returns the start of 'line', and its end (excluding the new line character) in 'out_line_end'.
+    IMGUI_API const char*       GetLine(int line, const char** out_line_end) const;
+
+private:
+    Chunk*                      AddChunk(unsigned int capacity);
+    void                        IndexChunk(Chunk* chunk, unsigned int end);
+    void                        Unmap();
+};
+
+namespace ImGui
+{
+    // Shows 'doc' in a scrolling child window, drawing only the visible lines. While scrolled to the bottom the view
+    // follows the text being appended, otherwise it stays where it is.
+    IMGUI_API void  TextView(const char* str_id, ImGuiTextDocument* doc, const ImVec2& size = ImVec2(0, 0));
+}
@@ -94,7 +94,7 @@ static bool             DataTypeApplyOpFromText(const char* buf, const char* ini
 // For InputTextEx()
 static bool             InputTextFilterCharacter(unsigned int* p_char, ImGuiInputTextFlags flags, ImGuiInputTextCallback callback, void* user_data);
 static int              InputTextCalcTextLenAndLineCount(const char* text_begin, const char** out_text_end);
-static ImVec2           InputTextCalcTextSizeW(const ImWchar* text_begin, const ImWchar* text_end, const ImWchar** remaining = NULL, ImVec2* out_offset = NULL, bool stop_on_new_line = false);
+static float            InputTextCalcLineWidthW(const ImGuiInputTextState* obj, int begin, int end);
 
 //-------------------------------------------------------------------------
 // [SECTION] Widgets: Text, etc.
@@ -153,7 +153,7 @@ void ImGui::TextUnformatted(const char* text, const char* text_end)
                     int lines_skipped = 0;
                     while (line < text_end && lines_skipped < lines_skippable)
                     {
-                        const char* line_end = strchr(line, '\n');
+                        const char* line_end = (const char*)memchr(line, '\n', (size_t)(text_end - line));
                         if (!line_end)
                             line_end = text_end;
                         line = line_end + 1;
@@ -169,7 +169,7 @@ void ImGui::TextUnformatted(const char* text, const char* text_end)
                 ImRect line_rect(pos, pos + ImVec2(FLT_MAX, line_height));
                 while (line < text_end)
                 {
-                    const char* line_end = strchr(line, '\n');
+                    const char* line_end = (const char*)memchr(line, '\n', (size_t)(text_end - line));
                     if (IsClippedEx(line_rect, 0, false))
                         break;
 
@@ -188,7 +188,7 @@ void ImGui::TextUnformatted(const char* text, const char* text_end)
                 int lines_skipped = 0;
                 while (line < text_end)
                 {
-                    const char* line_end = strchr(line, '\n');
+                    const char* line_end = (const char*)memchr(line, '\n', (size_t)(text_end - line));
                     if (!line_end)
                         line_end = text_end;
                     line = line_end + 1;
@@ -2807,59 +2807,28 @@ bool ImGui::InputTextMultiline(const char* label, char* buf, size_t buf_size, co
 static int InputTextCalcTextLenAndLineCount(const char* text_begin, const char** out_text_end)
 {
     int line_count = 0;
-    const char* s = text_begin;
-    while (char c = *s++) // We are only matching for \n so we can ignore UTF-8 decoding
-        if (c == '\n')
-            line_count++;
-    s--;
-    if (s[0] != '\n' && s[0] != '\r')
+    const char* text_end = text_begin + strlen(text_begin);
+    for (const char* s = text_begin; (s = (const char*)memchr(s, '\n', (size_t)(text_end - s))) != NULL; s++) // We are only matching for \n so we can ignore UTF-8 decoding
         line_count++;
-    *out_text_end = s;
+    line_count++;
+    *out_text_end = text_end;
     return line_count;
 }
 
-static ImVec2 InputTextCalcTextSizeW(const ImWchar* text_begin, const ImWchar* text_end, const ImWchar** remaining, ImVec2* out_offset, bool stop_on_new_line)
+// Width of characters [begin, end) of a line, new line characters are skipped
+static float InputTextCalcLineWidthW(const ImGuiInputTextState* obj, int begin, int end)
 {
     ImFont* font = GImGui->Font;
-    const float line_height = GImGui->FontSize;
-    const float scale = line_height / font->FontSize;
-
-    ImVec2 text_size = ImVec2(0,0);
+    const float scale = GImGui->FontSize / font->FontSize;
     float line_width = 0.0f;
-
-    const ImWchar* s = text_begin;
-    while (s < text_end)
+    for (int i = begin; i < end; i++)
     {
-        unsigned int c = (unsigned int)(*s++);
-        if (c == '\n')
-        {
-            text_size.x = ImMax(text_size.x, line_width);
-            text_size.y += line_height;
-            line_width = 0.0f;
-            if (stop_on_new_line)
-                break;
+        unsigned int c = (unsigned int)obj->GetCharW(i);
+        if (c == '\n' || c == '\r')
             continue;
-        }
-        if (c == '\r')
-            continue;
-
-        const float char_width = font->GetCharAdvance((unsigned short)c) * scale;
-        line_width += char_width;
+        line_width += font->GetCharAdvance((unsigned short)c) * scale;
     }
-
-    if (text_size.x < line_width)
-        text_size.x = line_width;
-
-    if (out_offset)
-        *out_offset = ImVec2(line_width, text_size.y + line_height);  // offset allow for the possibility of sitting after a trailing \n
-
-    if (line_width > 0 || text_size.y == 0.0f)                        // whereas size.y will ignore the trailing \n
-        text_size.y += line_height;
-
-    if (remaining)
-        *remaining = s;
-
-    return text_size;
+    return line_width;
 }
 
 // Wrapper for stb_textedit.h to edit text (our wrapper is for: statically sized buffer, single-line, wchar characters. InputText converts between UTF-8 and wchar)
@@ -2867,28 +2836,49 @@ namespace ImGuiStb
 {
 
 static int     STB_TEXTEDIT_STRINGLEN(const STB_TEXTEDIT_STRING* obj)                             { return obj->CurLenW; }
-static ImWchar STB_TEXTEDIT_GETCHAR(const STB_TEXTEDIT_STRING* obj, int idx)                      { return obj->TextW[idx]; }
-static float   STB_TEXTEDIT_GETWIDTH(STB_TEXTEDIT_STRING* obj, int line_start_idx, int char_idx)  { ImWchar c = obj->TextW[line_start_idx+char_idx]; if (c == '\n') return STB_TEXTEDIT_GETWIDTH_NEWLINE; return GImGui->Font->GetCharAdvance(c) * (GImGui->FontSize / GImGui->Font->FontSize); }
+static ImWchar STB_TEXTEDIT_GETCHAR(const STB_TEXTEDIT_STRING* obj, int idx)                      { return obj->GetCharW(idx); }
+static float   STB_TEXTEDIT_GETWIDTH(STB_TEXTEDIT_STRING* obj, int line_start_idx, int char_idx)  { ImWchar c = obj->GetCharW(line_start_idx+char_idx); if (c == '\n') return STB_TEXTEDIT_GETWIDTH_NEWLINE; return GImGui->Font->GetCharAdvance(c) * (GImGui->FontSize / GImGui->Font->FontSize); }
 static int     STB_TEXTEDIT_KEYTOTEXT(int key)                                                    { return key >= 0x10000 ? 0 : key; }
 static ImWchar STB_TEXTEDIT_NEWLINE = '\n';
+
+// Rows are the lines of the text, all FontSize high: the line index gives their extent without scanning for '\n'.
 static void    STB_TEXTEDIT_LAYOUTROW(StbTexteditRow* r, STB_TEXTEDIT_STRING* obj, int line_start_idx)
 {
-    const ImWchar* text = obj->TextW.Data;
-    const ImWchar* text_remaining = NULL;
-    const ImVec2 size = InputTextCalcTextSizeW(text + line_start_idx, text + obj->CurLenW, &text_remaining, NULL, true);
+    const int line = obj->GetLineIndex(line_start_idx);
+    const int line_end = (line + 1 < obj->GetLineCount()) ? obj->GetLineStart(line + 1) : obj->CurLenW;
     r->x0 = 0.0f;
-    r->x1 = size.x;
-    r->baseline_y_delta = size.y;
+    r->x1 = InputTextCalcLineWidthW(obj, line_start_idx, line_end);
+    r->baseline_y_delta = GImGui->FontSize;
     r->ymin = 0.0f;
-    r->ymax = size.y;
-    r->num_chars = (int)(text_remaining - (text + line_start_idx));
+    r->ymax = GImGui->FontSize;
+    r->num_chars = line_end - line_start_idx;
+}
+
+// Let stb_textedit.h start its row searches from the line of the cursor (or under the mouse) instead of the first line
+static int     STB_TEXTEDIT_FINDROWCHAR_IMPL(STB_TEXTEDIT_STRING* obj, int idx, int* prev_row_start, float* row_y)
+{
+    const int line = obj->GetLineIndex(idx);
+    *prev_row_start = obj->GetLineStart(line > 0 ? line - 1 : 0);
+    *row_y = line * GImGui->FontSize;
+    return obj->GetLineStart(line);
+}
+static int     STB_TEXTEDIT_FINDROWY_IMPL(STB_TEXTEDIT_STRING* obj, float y, float* row_y)
+{
+    // One line early, so rounding never puts us past the row straddling 'y'
+    const float line_height = GImGui->FontSize;
+    int line = (line_height > 0.0f && y > 0.0f) ? (int)(y / line_height) - 1 : 0;
+    line = ImClamp(line, 0, obj->GetLineCount() - 1);
+    *row_y = line * line_height;
+    return obj->GetLineStart(line);
 }
+#define STB_TEXTEDIT_FINDROWCHAR    STB_TEXTEDIT_FINDROWCHAR_IMPL
+#define STB_TEXTEDIT_FINDROWY       STB_TEXTEDIT_FINDROWY_IMPL
 
 static bool is_separator(unsigned int c)                                        { return ImCharIsBlankW(c) || c==',' || c==';' || c=='(' || c==')' || c=='{' || c=='}' || c=='[' || c==']' || c=='|'; }
-static int  is_word_boundary_from_right(STB_TEXTEDIT_STRING* obj, int idx)      { return idx > 0 ? (is_separator( obj->TextW[idx-1] ) && !is_separator( obj->TextW[idx] ) ) : 1; }
+static int  is_word_boundary_from_right(STB_TEXTEDIT_STRING* obj, int idx)      { return idx > 0 ? (is_separator( obj->GetCharW(idx-1) ) && !is_separator( obj->GetCharW(idx) ) ) : 1; }
 static int  STB_TEXTEDIT_MOVEWORDLEFT_IMPL(STB_TEXTEDIT_STRING* obj, int idx)   { idx--; while (idx >= 0 && !is_word_boundary_from_right(obj, idx)) idx--; return idx < 0 ? 0 : idx; }
 #ifdef __APPLE__    // FIXME: Move setting to IO structure
-static int  is_word_boundary_from_left(STB_TEXTEDIT_STRING* obj, int idx)       { return idx > 0 ? (!is_separator( obj->TextW[idx-1] ) && is_separator( obj->TextW[idx] ) ) : 1; }
+static int  is_word_boundary_from_left(STB_TEXTEDIT_STRING* obj, int idx)       { return idx > 0 ? (!is_separator( obj->GetCharW(idx-1) ) && is_separator( obj->GetCharW(idx) ) ) : 1; }
 static int  STB_TEXTEDIT_MOVEWORDRIGHT_IMPL(STB_TEXTEDIT_STRING* obj, int idx)  { idx++; int len = obj->CurLenW; while (idx < len && !is_word_boundary_from_left(obj, idx)) idx++; return idx > len ? len : idx; }
 #else
 static int  STB_TEXTEDIT_MOVEWORDRIGHT_IMPL(STB_TEXTEDIT_STRING* obj, int idx)  { idx++; int len = obj->CurLenW; while (idx < len && !is_word_boundary_from_right(obj, idx)) idx++; return idx > len ? len : idx; }
@@ -2898,17 +2888,7 @@ static int  STB_TEXTEDIT_MOVEWORDRIGHT_IMPL(STB_TEXTEDIT_STRING* obj, int idx)
 
 static void STB_TEXTEDIT_DELETECHARS(STB_TEXTEDIT_STRING* obj, int pos, int n)
 {
-    ImWchar* dst = obj->TextW.Data + pos;
-
-    // We maintain our buffer length in both UTF-8 and wchar formats
-    obj->CurLenA -= ImTextCountUtf8BytesFromStr(dst, dst + n);
-    obj->CurLenW -= n;
-
-    // Offset remaining text
-    const ImWchar* src = obj->TextW.Data + pos + n;
-    while (ImWchar c = *src++)
-        *dst++ = c;
-    *dst = '\0';
+    obj->DeleteChars(pos, n);
 }
 
 static bool STB_TEXTEDIT_INSERTCHARS(STB_TEXTEDIT_STRING* obj, int pos, const ImWchar* new_text, int new_text_len)
@@ -2921,24 +2901,11 @@ static bool STB_TEXTEDIT_INSERTCHARS(STB_TEXTEDIT_STRING* obj, int pos, const Im
     if (!is_resizable && (new_text_len_utf8 + obj->CurLenA + 1 > obj->BufCapacityA))
         return false;
 
-    // Grow internal buffer if needed
-    if (new_text_len + text_len + 1 > obj->TextW.Size)
-    {
-        if (!is_resizable)
-            return false;
-        IM_ASSERT(text_len < obj->TextW.Size);
-        obj->TextW.resize(text_len + ImClamp(new_text_len * 4, 32, ImMax(256, new_text_len)) + 1);
-    }
-
-    ImWchar* text = obj->TextW.Data;
-    if (pos != text_len)
-        memmove(text + pos + new_text_len, text + pos, (size_t)(text_len - pos) * sizeof(ImWchar));
-    memcpy(text + pos, new_text, (size_t)new_text_len * sizeof(ImWchar));
-
-    obj->CurLenW += new_text_len;
-    obj->CurLenA += new_text_len_utf8;
-    obj->TextW[obj->CurLenW] = '\0';
+    // Internal buffer grows if needed
+    if (new_text_len + text_len + 1 > obj->TextW.Size && !is_resizable)
+        return false;
 
+    obj->InsertChars(pos, new_text, new_text_len, new_text_len_utf8);
     return true;
 }
 
@@ -2971,6 +2938,167 @@ void ImGuiInputTextState::OnKeyPressed(int key)
     CursorAnimReset();
 }
 
+// Number of lines starting at or before character 'idx', minus one
+int ImGuiInputTextState::GetLineIndex(int idx) const
+{
+    const int* lines = LinesBeforeGap.Data;
+    int lo = 0, hi = LinesBeforeGap.Size;
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (lines[mid] <= idx) lo = mid + 1; else hi = mid;
+    }
+    if (lo < LinesBeforeGap.Size)
+        return lo;
+
+    // After the gap: the lines starting at or before 'idx' are those at least CurLenW-idx from the end
+    const int dist = CurLenW - idx;
+    int lo_after = 0, hi_after = LinesAfterGap.Size;
+    lines = LinesAfterGap.Data;
+    while (lo_after < hi_after)
+    {
+        int mid = (lo_after + hi_after) / 2;
+        if (lines[mid] < dist) lo_after = mid + 1; else hi_after = mid;
+    }
+    return lo + (LinesAfterGap.Size - lo_after);
+}
+
+int ImGuiInputTextState::GetPosA(int idx) const
+{
+    if (idx <= GapPosW)
+        return GapPosA - ImTextCountUtf8BytesFromStr(TextW.Data + idx, TextW.Data + GapPosW);
+    const ImWchar* after_gap = TextW.Data + TextW.Size - CurLenW + GapPosW;
+    return GapPosA + ImTextCountUtf8BytesFromStr(after_gap, after_gap + idx - GapPosW);
+}
+
+bool ImGuiInputTextState::CopyTextA(char* dst, int begin_a, int end_a) const
+{
+    bool changed = false;
+    const int gap_size_a = TextA.Size - CurLenA;
+    for (int seg = 0; seg < 2; seg++)
+    {
+        const int seg_begin = seg == 0 ? begin_a : ImMax(begin_a, GapPosA);
+        const int seg_end = seg == 0 ? ImMin(end_a, GapPosA) : end_a;
+        if (seg_begin >= seg_end)
+            continue;
+        const char* src = TextA.Data + seg_begin + (seg == 0 ? 0 : gap_size_a);
+        if (memcmp(dst + seg_begin, src, (size_t)(seg_end - seg_begin)) != 0)
+        {
+            memcpy(dst + seg_begin, src, (size_t)(seg_end - seg_begin));
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+int ImGuiInputTextState::GetTextUtf8(char* dst, int dst_size, int begin, int end) const
+{
+    const ImWchar* after_gap = TextW.Data + TextW.Size - CurLenW;
+    int len = 0;
+    if (begin < GapPosW)
+        len += ImTextStrToUtf8(dst, dst_size, TextW.Data + begin, TextW.Data + ImMin(end, GapPosW));
+    if (end > GapPosW)
+        len += ImTextStrToUtf8(dst + len, dst_size - len, after_gap + ImMax(begin, GapPosW), after_gap + end);
+    dst[len] = 0;
+    return len;
+}
+
+// Called after the whole text was written to TextW[0..CurLenW): puts the gap at the end and rebuilds the UTF-8 copy and the line index.
+void ImGuiInputTextState::OnTextReplaced()
+{
+    const ImWchar* text = TextW.Data;
+    GapPosW = CurLenW;
+    TextA.resize(ImTextCountUtf8BytesFromStr(text, text + CurLenW) + 1);
+    CurLenA = GapPosA = ImTextStrToUtf8(TextA.Data, TextA.Size, text, text + CurLenW);
+    LinesBeforeGap.resize(0);
+    LinesAfterGap.resize(0);
+    for (int i = 0; i < CurLenW; i++)
+        if (text[i] == '\n')
+            LinesBeforeGap.push_back(i + 1);
+}
+
+// Moves the gap to character 'idx': costs the distance between the previous edit and this one, not the size of the text.
+void ImGuiInputTextState::MoveGap(int idx)
+{
+    IM_ASSERT(idx >= 0 && idx <= CurLenW);
+    ImWchar* text_w = TextW.Data;
+    char* text_a = TextA.Data;
+    const int gap_size_w = TextW.Size - CurLenW;
+    const int gap_size_a = TextA.Size - CurLenA;
+    if (idx < GapPosW)
+    {
+        const int n = GapPosW - idx;
+        const int n_a = ImTextCountUtf8BytesFromStr(text_w + idx, text_w + GapPosW);
+        memmove(text_w + idx + gap_size_w, text_w + idx, (size_t)n * sizeof(ImWchar));
+        memmove(text_a + GapPosA - n_a + gap_size_a, text_a + GapPosA - n_a, (size_t)n_a);
+        GapPosA -= n_a;
+        while (LinesBeforeGap.Size > 0 && LinesBeforeGap.back() > idx)
+        {
+            LinesAfterGap.push_back(CurLenW - LinesBeforeGap.back());
+            LinesBeforeGap.pop_back();
+        }
+    }
+    else if (idx > GapPosW)
+    {
+        const int n = idx - GapPosW;
+        const int n_a = ImTextCountUtf8BytesFromStr(text_w + GapPosW + gap_size_w, text_w + idx + gap_size_w);
+        memmove(text_w + GapPosW, text_w + GapPosW + gap_size_w, (size_t)n * sizeof(ImWchar));
+        memmove(text_a + GapPosA, text_a + GapPosA + gap_size_a, (size_t)n_a);
+        GapPosA += n_a;
+        while (LinesAfterGap.Size > 0 && CurLenW - LinesAfterGap.back() <= idx)
+        {
+            LinesBeforeGap.push_back(CurLenW - LinesAfterGap.back());
+            LinesAfterGap.pop_back();
+        }
+    }
+    GapPosW = idx;
+}
+
+void ImGuiInputTextState::DeleteChars(int pos, int n)
+{
+    MoveGap(pos);
+    const ImWchar* after_gap = TextW.Data + TextW.Size - CurLenW + pos;
+    const int n_a = ImTextCountUtf8BytesFromStr(after_gap, after_gap + n);
+    while (LinesAfterGap.Size > 0 && CurLenW - LinesAfterGap.back() <= pos + n)
+        LinesAfterGap.pop_back();
+
+    // We maintain our buffer length in both UTF-8 and wchar formats
+    CurLenW -= n;
+    CurLenA -= n_a;
+    UserBufDirtyA = (UserBufDirtyA < 0) ? GapPosA : ImMin(UserBufDirtyA, GapPosA);
+}
+
+// Grows 'buf' so its gap holds at least 'gap_size' elements, keeping the text after the gap at the end
+template<typename T>
+static void InputTextGrowGapBuffer(ImVector<T>& buf, int text_len, int gap_pos, int gap_size)
+{
+    if (buf.Size - text_len >= gap_size)
+        return;
+    const int after_gap_len = text_len - gap_pos;
+    const int old_size = buf.Size;
+    buf.resize(text_len + gap_size + ImMax(256, text_len / 2));
+    memmove(buf.Data + buf.Size - after_gap_len, buf.Data + old_size - after_gap_len, (size_t)after_gap_len * sizeof(T));
+}
+
+void ImGuiInputTextState::InsertChars(int pos, const ImWchar* new_text, int new_text_len, int new_text_len_utf8)
+{
+    MoveGap(pos);
+    InputTextGrowGapBuffer(TextW, CurLenW, GapPosW, new_text_len + 1);
+    InputTextGrowGapBuffer(TextA, CurLenA, GapPosA, new_text_len_utf8 + 1); // +1 for the terminator ImTextStrToUtf8() writes
+
+    memcpy(TextW.Data + GapPosW, new_text, (size_t)new_text_len * sizeof(ImWchar));
+    ImTextStrToUtf8(TextA.Data + GapPosA, new_text_len_utf8 + 1, new_text, new_text + new_text_len);
+    for (int i = 0; i < new_text_len; i++)
+        if (new_text[i] == '\n')
+            LinesBeforeGap.push_back(GapPosW + i + 1);
+
+    UserBufDirtyA = (UserBufDirtyA < 0) ? GapPosA : ImMin(UserBufDirtyA, GapPosA);
+    GapPosW += new_text_len;
+    GapPosA += new_text_len_utf8;
+    CurLenW += new_text_len;
+    CurLenA += new_text_len_utf8;
+}
+
 ImGuiInputTextCallbackData::ImGuiInputTextCallbackData()
 {
     memset(this, 0, sizeof(*this));
@@ -3192,7 +3320,8 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
             memcpy(edit_state.InitialText.Data, buf, init_buf_len + 1);
             const char* buf_end = NULL;
             edit_state.CurLenW = ImTextStrFromUtf8(edit_state.TextW.Data, buf_size, buf, NULL, &buf_end);
-            edit_state.CurLenA = (int)(buf_end - buf); // We can't get the result from ImStrncpy() above because it is not UTF-8 aware. Here we'll cut off malformed UTF-8.
+            edit_state.OnTextReplaced();
+            edit_state.UserBufDirtyA = 0; // Written back on the first frame only if the conversion altered it (malformed UTF-8, characters outside of the BMP)
             edit_state.CursorAnimReset();
 
             // Preserve cursor position and undo/redo stack if we come back to same widget
@@ -3239,9 +3368,9 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
         {
             // When read-only we always use the live data passed to the function
             edit_state.TextW.resize(buf_size+1);
-            const char* buf_end = NULL;
-            edit_state.CurLenW = ImTextStrFromUtf8(edit_state.TextW.Data, edit_state.TextW.Size, buf, NULL, &buf_end);
-            edit_state.CurLenA = (int)(buf_end - buf);
+            edit_state.CurLenW = ImTextStrFromUtf8(edit_state.TextW.Data, edit_state.TextW.Size, buf, NULL);
+            edit_state.OnTextReplaced();
+            edit_state.UserBufDirtyA = -1;
             edit_state.CursorClamp();
         }
 
@@ -3385,7 +3514,7 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
                 const int ib = edit_state.HasSelection() ? ImMin(edit_state.StbState.select_start, edit_state.StbState.select_end) : 0;
                 const int ie = edit_state.HasSelection() ? ImMax(edit_state.StbState.select_start, edit_state.StbState.select_end) : edit_state.CurLenW;
                 edit_state.TempBuffer.resize((ie-ib) * 4 + 1);
-                ImTextStrToUtf8(edit_state.TempBuffer.Data, edit_state.TempBuffer.Size, edit_state.TextW.Data+ib, edit_state.TextW.Data+ie);
+                edit_state.GetTextUtf8(edit_state.TempBuffer.Data, edit_state.TempBuffer.Size, ib, ie);
                 SetClipboardText(edit_state.TempBuffer.Data);
             }
             if (is_cut)
@@ -3446,13 +3575,7 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
         {
             // Apply new value immediately - copy modified buffer back
             // Note that as soon as the input box is active, the in-widget value gets priority over any underlying modification of the input buffer
-            // FIXME: We actually always render 'buf' when calling DrawList->AddText, making the comment above incorrect.
-            // FIXME-OPT: CPU waste to do this every time the widget is active, should mark dirty state from the stb_textedit callbacks.
-            if (is_editable)
-            {
-                edit_state.TempBuffer.resize(edit_state.TextW.Size * 4 + 1);
-                ImTextStrToUtf8(edit_state.TempBuffer.Data, edit_state.TempBuffer.Size, edit_state.TextW.Data, NULL);
-            }
+            // Only the bytes from the first edit since the last copy (UserBufDirtyA) are copied, unless the application wrote to 'buf' in the meantime.
 
             // User callback
             if ((flags & (ImGuiInputTextFlags_CallbackCompletion | ImGuiInputTextFlags_CallbackHistory | ImGuiInputTextFlags_CallbackAlways)) != 0)
@@ -3482,6 +3605,10 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
 
                 if (event_flag)
                 {
+                    edit_state.TempBuffer.resize(ImMax(edit_state.BufCapacityA, edit_state.CurLenA + 1));
+                    edit_state.CopyTextA(edit_state.TempBuffer.Data, 0, edit_state.CurLenA);
+                    edit_state.TempBuffer[edit_state.CurLenA] = 0;
+
                     ImGuiInputTextCallbackData callback_data;
                     memset(&callback_data, 0, sizeof(ImGuiInputTextCallbackData));
                     callback_data.EventFlag = event_flag;
@@ -3495,10 +3622,9 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
                     callback_data.BufDirty = false;
 
                     // We have to convert from wchar-positions to UTF-8-positions, which can be pretty slow (an incentive to ditch the ImWchar buffer, see https://github.com/nothings/stb/issues/188)
-                    ImWchar* text = edit_state.TextW.Data;
-                    const int utf8_cursor_pos = callback_data.CursorPos = ImTextCountUtf8BytesFromStr(text, text + edit_state.StbState.cursor);
-                    const int utf8_selection_start = callback_data.SelectionStart = ImTextCountUtf8BytesFromStr(text, text + edit_state.StbState.select_start);
-                    const int utf8_selection_end = callback_data.SelectionEnd = ImTextCountUtf8BytesFromStr(text, text + edit_state.StbState.select_end);
+                    const int utf8_cursor_pos = callback_data.CursorPos = edit_state.GetPosA(edit_state.StbState.cursor);
+                    const int utf8_selection_start = callback_data.SelectionStart = edit_state.GetPosA(edit_state.StbState.select_start);
+                    const int utf8_selection_end = callback_data.SelectionEnd = edit_state.GetPosA(edit_state.StbState.select_end);
 
                     // Call user code
                     callback(&callback_data);
@@ -3513,19 +3639,20 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
                     if (callback_data.BufDirty)
                     {
                         IM_ASSERT(callback_data.BufTextLen == (int)strlen(callback_data.Buf)); // You need to maintain BufTextLen if you change the text!
-                        if (callback_data.BufTextLen > backup_current_text_length && is_resizable)
-                            edit_state.TextW.resize(edit_state.TextW.Size + (callback_data.BufTextLen - backup_current_text_length));
+                        if (callback_data.BufTextLen + 1 > edit_state.TextW.Size)
+                            edit_state.TextW.resize(callback_data.BufTextLen + 1);
                         edit_state.CurLenW = ImTextStrFromUtf8(edit_state.TextW.Data, edit_state.TextW.Size, callback_data.Buf, NULL);
-                        edit_state.CurLenA = callback_data.BufTextLen;  // Assume correct length and valid UTF-8 from user, saves us an extra strlen()
+                        edit_state.OnTextReplaced();
+                        edit_state.UserBufDirtyA = 0;
                         edit_state.CursorAnimReset();
                     }
                 }
             }
 
             // Will copy result string if modified
-            if (is_editable && strcmp(edit_state.TempBuffer.Data, buf) != 0)
+            if (is_editable && edit_state.UserBufDirtyA >= 0)
             {
-                apply_new_text = edit_state.TempBuffer.Data;
+                apply_new_text = edit_state.TextA.Data;
                 apply_new_text_length = edit_state.CurLenA;
             }
         }
@@ -3533,6 +3660,7 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
         // Copy result to user buffer
         if (apply_new_text)
         {
+            const char* backup_buf = buf;
             IM_ASSERT(apply_new_text_length >= 0);
             if (backup_current_text_length != apply_new_text_length && is_resizable)
             {
@@ -3551,8 +3679,24 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
             }
 
             // If the underlying buffer resize was denied or not carried to the next frame, apply_new_text_length+1 may be >= buf_size.
-            ImStrncpy(buf, edit_state.TempBuffer.Data, ImMin(apply_new_text_length + 1, buf_size));
-            value_changed = true;
+            const int copy_len = ImMin(apply_new_text_length, buf_size - 1);
+            if (apply_new_text != edit_state.TextA.Data)
+            {
+                ImStrncpy(buf, apply_new_text, copy_len + 1);
+                value_changed = true;
+            }
+            else
+            {
+                // A resize callback may have moved the buffer elsewhere, in which case nothing of it is known.
+                // The application may also have written to 'buf' while we were active: the prefix is compared (and copied over if it differs) rather than assumed.
+                const int copy_from = (buf != backup_buf) ? 0 : ImMin(edit_state.UserBufDirtyA, copy_len);
+                bool prefix_changed = copy_from > 0 && edit_state.CopyTextA(buf, 0, copy_from);
+                if (edit_state.CopyTextA(buf, copy_from, copy_len) || prefix_changed || buf[copy_len] != 0 || copy_len != backup_current_text_length)
+                    value_changed = true;
+                buf[copy_len] = 0;
+                if (copy_len == edit_state.CurLenA)
+                    edit_state.UserBufDirtyA = -1;
+            }
         }
 
         // Clear temporary user storage
@@ -3567,7 +3711,8 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
 
     // Render
     // Select which buffer we are going to display. When ImGuiInputTextFlags_NoLiveEdit is set 'buf' might still be the old value. We set buf to NULL to prevent accidental usage from now on.
-    const char* buf_display = (g.ActiveId == id && is_editable) ? edit_state.TempBuffer.Data : buf; buf = NULL;
+    // While active we display the edited text from 'edit_state' (buf_display is only used by the inactive path and logging).
+    const char* buf_display = buf; buf = NULL;
 
     // Set upper limit of single-line InputTextEx() at 2 million characters strings. The current pathological worst case is a long line
     // without any carriage return, which would makes ImFont::RenderText() reserve too many vertices and probably crash. Avoid it altogether.
@@ -3588,51 +3733,26 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
     {
         edit_state.CursorAnim += io.DeltaTime;
 
-        // This is going to be messy. We need to:
-        // - Display the text (this alone can be more easily clipped)
+        // We need to:
+        // - Display the text
         // - Handle scrolling, highlight selection, display cursor (those all requires some form of 1d->2d cursor position calculation)
         // - Measure text height (for scrollbar)
-        // We are attempting to do most of that in **one main pass** to minimize the computation cost (non-negligible for large amount of text) + 2nd pass for selection rendering (we could merge them by an extra refactoring effort)
+        // Lines are all FontSize high and the line index gives the line of any character, so all of this only looks at the visible lines and at the lines of 'cursor' and 'select_start'.
         // FIXME: This should occur on buf_display but we'd need to maintain cursor/select_start/select_end for UTF-8.
-        const ImWchar* text_begin = edit_state.TextW.Data;
+        const int line_count = edit_state.GetLineCount();
         ImVec2 cursor_offset, select_start_offset;
 
         {
-            // Count lines + find lines numbers straddling 'cursor' and 'select_start' position.
-            const ImWchar* searches_input_ptr[2];
-            searches_input_ptr[0] = text_begin + edit_state.StbState.cursor;
-            searches_input_ptr[1] = NULL;
-            int searches_remaining = 1;
-            int searches_result_line_number[2] = { -1, -999 };
-            if (edit_state.StbState.select_start != edit_state.StbState.select_end)
-            {
-                searches_input_ptr[1] = text_begin + ImMin(edit_state.StbState.select_start, edit_state.StbState.select_end);
-                searches_result_line_number[1] = -1;
-                searches_remaining++;
-            }
-
-            // Iterate all lines to find our line numbers
-            // In multi-line mode, we never exit the loop until all lines are counted, so add one extra to the searches_remaining counter.
-            searches_remaining += is_multiline ? 1 : 0;
-            int line_count = 0;
-            for (const ImWchar* s = text_begin; *s != 0; s++)
-                if (*s == '\n')
-                {
-                    line_count++;
-                    if (searches_result_line_number[0] == -1 && s >= searches_input_ptr[0]) { searches_result_line_number[0] = line_count; if (--searches_remaining <= 0) break; }
-                    if (searches_result_line_number[1] == -1 && s >= searches_input_ptr[1]) { searches_result_line_number[1] = line_count; if (--searches_remaining <= 0) break; }
-                }
-            line_count++;
-            if (searches_result_line_number[0] == -1) searches_result_line_number[0] = line_count;
-            if (searches_result_line_number[1] == -1) searches_result_line_number[1] = line_count;
-
             // Calculate 2d position by finding the beginning of the line and measuring distance
-            cursor_offset.x = InputTextCalcTextSizeW(ImStrbolW(searches_input_ptr[0], text_begin), searches_input_ptr[0]).x;
-            cursor_offset.y = searches_result_line_number[0] * g.FontSize;
-            if (searches_result_line_number[1] >= 0)
+            const int cursor_line = edit_state.GetLineIndex(edit_state.StbState.cursor);
+            cursor_offset.x = InputTextCalcLineWidthW(&edit_state, edit_state.GetLineStart(cursor_line), edit_state.StbState.cursor);
+            cursor_offset.y = (cursor_line + 1) * g.FontSize;
+            if (edit_state.StbState.select_start != edit_state.StbState.select_end)
             {
-                select_start_offset.x = InputTextCalcTextSizeW(ImStrbolW(searches_input_ptr[1], text_begin), searches_input_ptr[1]).x;
-                select_start_offset.y = searches_result_line_number[1] * g.FontSize;
+                const int select_start = ImMin(edit_state.StbState.select_start, edit_state.StbState.select_end);
+                const int select_start_line = edit_state.GetLineIndex(select_start);
+                select_start_offset.x = InputTextCalcLineWidthW(&edit_state, edit_state.GetLineStart(select_start_line), select_start);
+                select_start_offset.y = (select_start_line + 1) * g.FontSize;
             }
 
             // Store text height (note that we haven't calculated text width at all, see GitHub issues #383, #1224)
@@ -3676,26 +3796,39 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
         // Draw selection
         if (edit_state.StbState.select_start != edit_state.StbState.select_end)
         {
-            const ImWchar* text_selected_begin = text_begin + ImMin(edit_state.StbState.select_start, edit_state.StbState.select_end);
-            const ImWchar* text_selected_end = text_begin + ImMax(edit_state.StbState.select_start, edit_state.StbState.select_end);
+            const int text_selected_begin = ImMin(edit_state.StbState.select_start, edit_state.StbState.select_end);
+            const int text_selected_end = ImMax(edit_state.StbState.select_start, edit_state.StbState.select_end);
 
             float bg_offy_up = is_multiline ? 0.0f : -1.0f;    // FIXME: those offsets should be part of the style? they don't play so well with multi-line selection.
             float bg_offy_dn = is_multiline ? 0.0f : 2.0f;
             ImU32 bg_color = GetColorU32(ImGuiCol_TextSelectedBg);
             ImVec2 rect_pos = render_pos + select_start_offset - render_scroll;
-            for (const ImWchar* p = text_selected_begin; p < text_selected_end; )
+            int line = edit_state.GetLineIndex(text_selected_begin);
+            const int line_last = edit_state.GetLineIndex(text_selected_end - 1);
+
+            // Jump over the selected lines above the clipping rectangle
+            if (rect_pos.y < clip_rect.y && line < line_last)
             {
-                if (rect_pos.y > clip_rect.w + g.FontSize)
-                    break;
-                if (rect_pos.y < clip_rect.y)
+                const float first_y = rect_pos.y;
+                int skip = ImMin((int)((clip_rect.y - first_y) / g.FontSize), line_last - line);
+                while (skip > 0 && first_y + skip * g.FontSize >= clip_rect.y)
+                    skip--;
+                if (skip > 0)
                 {
-                    while (p < text_selected_end)
-                        if (*p++ == '\n')
-                            break;
+                    line += skip;
+                    rect_pos = ImVec2(render_pos.x - render_scroll.x, first_y + skip * g.FontSize);
                 }
-                else
+            }
+
+            for (; line <= line_last; line++)
+            {
+                if (rect_pos.y > clip_rect.w + g.FontSize)
+                    break;
+                if (rect_pos.y >= clip_rect.y)
                 {
-                    ImVec2 rect_size = InputTextCalcTextSizeW(p, text_selected_end, &p, NULL, true);
+                    const int p = ImMax(edit_state.GetLineStart(line), text_selected_begin);
+                    const int p_end = (line + 1 < line_count) ? ImMin(edit_state.GetLineStart(line + 1), text_selected_end) : text_selected_end;
+                    ImVec2 rect_size(InputTextCalcLineWidthW(&edit_state, p, p_end), g.FontSize);
                     if (rect_size.x <= 0.0f) rect_size.x = (float)(int)(g.Font->GetCharAdvance((unsigned short)' ') * 0.50f); // So we can see selected empty lines
                     ImRect rect(rect_pos + ImVec2(0.0f, bg_offy_up - g.FontSize), rect_pos +ImVec2(rect_size.x, bg_offy_dn));
                     rect.ClipWith(clip_rect);
@@ -3707,9 +3840,29 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
             }
         }
 
+        // Draw the visible lines only (with one line of margin, ImFont::RenderText() does the fine culling), converted to UTF-8 in TempBuffer.
+        // The lines are placed at the same pixel as if the whole text was drawn from 'render_pos'.
         const int buf_display_len = edit_state.CurLenA;
-        if (is_multiline || buf_display_len < buf_display_max_length)
-            draw_window->DrawList->AddText(g.Font, g.FontSize, render_pos - render_scroll, GetColorU32(ImGuiCol_Text), buf_display, buf_display + buf_display_len, 0.0f, is_multiline ? NULL : &clip_rect);
+        if (g.ActiveId != id)
+        {
+            // Scrolling while inactive: the text is in 'buf'
+            draw_window->DrawList->AddText(g.Font, g.FontSize, render_pos - render_scroll, GetColorU32(ImGuiCol_Text), buf_display, NULL);
+        }
+        else if (is_multiline || buf_display_len < buf_display_max_length)
+        {
+            ImVec2 text_pos = render_pos - render_scroll;
+            text_pos.y = (float)(int)text_pos.y;
+            const ImVec2 draw_clip_min = draw_window->DrawList->GetClipRectMin();
+            const ImVec2 draw_clip_max = draw_window->DrawList->GetClipRectMax();
+            const int line_first = ImClamp((int)((draw_clip_min.y - text_pos.y) / g.FontSize) - 1, 0, line_count - 1);
+            const int line_end = ImClamp((int)((draw_clip_max.y - text_pos.y) / g.FontSize) + 2, line_first, line_count);
+            const int text_begin = edit_state.GetLineStart(line_first);
+            const int text_end = (line_end < line_count) ? edit_state.GetLineStart(line_end) : edit_state.CurLenW;
+            edit_state.TempBuffer.resize((text_end - text_begin) * 4 + 1);
+            const int text_len = edit_state.GetTextUtf8(edit_state.TempBuffer.Data, edit_state.TempBuffer.Size, text_begin, text_end);
+            text_pos.y += line_first * g.FontSize;
+            draw_window->DrawList->AddText(g.Font, g.FontSize, text_pos, GetColorU32(ImGuiCol_Text), edit_state.TempBuffer.Data, edit_state.TempBuffer.Data + text_len, 0.0f, is_multiline ? NULL : &clip_rect);
+        }
 
         // Draw blinking cursor
         bool cursor_is_visible = (!g.IO.ConfigInputTextCursorBlink) || (g.InputTextState.CursorAnim <= 0.0f) || ImFmod(g.InputTextState.CursorAnim, 1.20f) <= 0.80f;
@@ -3746,7 +3899,16 @@ bool ImGui::InputTextEx(const char* label, char* buf, int buf_size, const ImVec2
 
     // Log as text
     if (g.LogEnabled && !is_password)
+    {
+        if (g.ActiveId == id && is_editable)
+        {
+            edit_state.TempBuffer.resize(edit_state.CurLenA + 1);
+            edit_state.CopyTextA(edit_state.TempBuffer.Data, 0, edit_state.CurLenA);
+            edit_state.TempBuffer[edit_state.CurLenA] = 0;
+            buf_display = edit_state.TempBuffer.Data;
+        }
         LogRenderedText(&render_pos, buf_display, NULL);
+    }
 
     if (label_size.x > 0)
         RenderText(ImVec2(frame_bb.Max.x + style.ItemInnerSpacing.x, frame_bb.Min.y + style.FramePadding.y), label);
@@ -1,6 +1,9 @@
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
+#include "imgui_impl_trace.h"
+
+#include <thread>
 
 #include "ApplicationContext.hpp"
 
@@ -75,6 +78,92 @@ static void glfw_error_callback(int aError, const char* aDescription)
   fprintf(stderr, "Glfw Error %d: %s\n", aError, aDescription);
 }
 
+// Sleeps until the deadline. OS sleeps can overshoot by a scheduler quantum,
+// so we only sleep until we're close and spin the rest of the way.
+static void SleepUntil(SOIS::ApplicationContext::Clock::time_point aDeadline)
+{
+  using Clock = SOIS::ApplicationContext::Clock;
+  auto const spinThreshold = std::chrono::milliseconds(2);
+
+  auto now = Clock::now();
+  while (aDeadline - now > spinThreshold)
+  {
+    std::this_thread::sleep_for(aDeadline - now - spinThreshold);
+    now = Clock::now();
+  }
+
+  while (Clock::now() < aDeadline)
+  {
+    std::this_thread::yield();
+  }
+}
+
+// Our GLFW callbacks, they forward to the ImGui GLFW binding and let the
+// context know input arrived for idle rendering.
+static void MouseButtonCallback(GLFWwindow* aWindow, int aButton, int aAction, int aMods)
+{
+  ImGui_ImplGlfw_MouseButtonCallback(aWindow, aButton, aAction, aMods);
+  SOIS::ApplicationContext::OnWindowEvent(aWindow);
+}
+
+static void ScrollCallback(GLFWwindow* aWindow, double aXOffset, double aYOffset)
+{
+  ImGui_ImplGlfw_ScrollCallback(aWindow, aXOffset, aYOffset);
+  SOIS::ApplicationContext::OnWindowEvent(aWindow);
+}
+
+static void KeyCallback(GLFWwindow* aWindow, int aKey, int aScancode, int aAction, int aMods)
+{
+  ImGui_ImplGlfw_KeyCallback(aWindow, aKey, aScancode, aAction, aMods);
+  SOIS::ApplicationContext::OnWindowEvent(aWindow);
+
+  if (GLFW_KEY_F12 == aKey && GLFW_PRESS == aAction)
+  {
+    auto context = static_cast<SOIS::ApplicationContext*>(glfwGetWindowUserPointer(aWindow));
+    context->WriteTrace();
+  }
+}
+
+static void CharCallback(GLFWwindow* aWindow, unsigned int aCharacter)
+{
+  ImGui_ImplGlfw_CharCallback(aWindow, aCharacter);
+  SOIS::ApplicationContext::OnWindowEvent(aWindow);
+}
+
+static void CursorPosCallback(GLFWwindow* aWindow, double, double)
+{
+  SOIS::ApplicationContext::OnWindowEvent(aWindow);
+}
+
+static void CursorEnterCallback(GLFWwindow* aWindow, int)
+{
+  SOIS::ApplicationContext::OnWindowEvent(aWindow);
+}
+
+static void WindowFocusCallback(GLFWwindow* aWindow, int)
+{
+  SOIS::ApplicationContext::OnWindowEvent(aWindow);
+}
+
+static void WindowRefreshCallback(GLFWwindow* aWindow)
+{
+  SOIS::ApplicationContext::OnWindowEvent(aWindow);
+
+  // The window contents were damaged, we have to present even if nothing
+  // changed on our end.
+  auto context = static_cast<SOIS::ApplicationContext*>(glfwGetWindowUserPointer(aWindow));
+
+  if (nullptr != context)
+  {
+    context->Invalidate();
+  }
+}
+
+static void FramebufferSizeCallback(GLFWwindow* aWindow, int, int)
+{
+  SOIS::ApplicationContext::OnWindowEvent(aWindow);
+}
+
 namespace SOIS
 {
   void ApplicationInitialization()
@@ -87,49 +176,120 @@ namespace SOIS
     }
   }
 
-  ApplicationContext::ApplicationContext()
+  ApplicationContext::ApplicationContext(ContextSettings const& aSettings)
   {
     // Decide GL+GLSL versions
     #if __APPLE__
       // GL 3.2 + GLSL 150
       const char* glsl_version = "#version 150";
-      glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-      glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
-      glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);  // 3.2+ only
-      glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);            // Required on Mac
     #else
       // GL 3.0 + GLSL 130
       const char* glsl_version = "#version 130";
-      glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-      glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
-      //glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);  // 3.2+ only
-      //glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);            // 3.0+ only
     #endif
 
-    // Create window with graphics context
-    mWindow = glfwCreateWindow(1280, 720, "Dear ImGui GLFW+OpenGL3 Sample Application", NULL, NULL);
-
-    if (nullptr == mWindow)
+    if (aSettings.mHeadless)
     {
-      return;
+      // Create an offscreen context, and render into a framebuffer of the
+      // requested size instead of a window.
+      mOffscreen = std::make_unique<OffscreenSurface>();
+
+      if (false == mOffscreen->CreateContext())
+      {
+        fprintf(stderr, "Failed to create a headless OpenGL context.\n");
+        mOffscreen.reset();
+        mRunning = false;
+        return;
+      }
+
+      glbinding::initialize(OffscreenSurface::GetProcAddress);
+
+      if (false == mOffscreen->CreateFramebuffer(aSettings.mWidth, aSettings.mHeight))
+      {
+        fprintf(stderr, "Failed to create a %dx%d offscreen framebuffer.\n", aSettings.mWidth, aSettings.mHeight);
+        mOffscreen.reset();
+        mRunning = false;
+        return;
+      }
+    }
+    else
+    {
+      // Window hints only stick once GLFW is initialized (by
+      // ApplicationInitialization), headless contexts don't need them.
+      #if __APPLE__
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);  // 3.2+ only
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);            // Required on Mac
+      #else
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+        //glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);  // 3.2+ only
+        //glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);            // 3.0+ only
+      #endif
+
+      // Create window with graphics context
+      mWindow = glfwCreateWindow(aSettings.mWidth, aSettings.mHeight, "Dear ImGui GLFW+OpenGL3 Sample Application", NULL, NULL);
+
+      if (nullptr == mWindow)
+      {
+        return;
+      }
+
+      glfwMakeContextCurrent(mWindow);
+      SetFramePacing(FramePacing::VSync);
+
+      // Initialize OpenGL loader
+      glbinding::initialize(glfwGetProcAddress);
     }
-
-    glfwMakeContextCurrent(mWindow);
-    glfwSwapInterval(1); // Enable vsync
-
-    // Initialize OpenGL loader
-    glbinding::initialize(glfwGetProcAddress);
 
     gl::glEnable(gl::GL_DEBUG_OUTPUT);
     gl::glDebugMessageCallback(messageCallback, this);
 
-    // Setup Dear ImGui binding
+    // Setup Dear ImGui binding, with our allocator installed before ImGui
+    // allocates anything.
     IMGUI_CHECKVERSION();
+    FrameAllocator::Get().Install();
     ImGui::CreateContext();
 
-    ImGui_ImplGlfw_InitForOpenGL(mWindow, true);
+    if (nullptr != mWindow)
+    {
+      // We install our own callbacks (which forward to ImGui's) so we can tell
+      // when input arrived.
+      ImGui_ImplGlfw_InitForOpenGL(mWindow, false);
+      glfwSetWindowUserPointer(mWindow, this);
+      glfwSetMouseButtonCallback(mWindow, MouseButtonCallback);
+      glfwSetScrollCallback(mWindow, ScrollCallback);
+      glfwSetKeyCallback(mWindow, KeyCallback);
+      glfwSetCharCallback(mWindow, CharCallback);
+      glfwSetCursorPosCallback(mWindow, CursorPosCallback);
+      glfwSetCursorEnterCallback(mWindow, CursorEnterCallback);
+      glfwSetWindowFocusCallback(mWindow, WindowFocusCallback);
+      glfwSetWindowRefreshCallback(mWindow, WindowRefreshCallback);
+      glfwSetFramebufferSizeCallback(mWindow, FramebufferSizeCallback);
+    }
+    else
+    {
+      // Headless runs shouldn't depend on (or change) the saved window layout.
+      ImGui::GetIO().IniFilename = nullptr;
+    }
+
     ImGui_ImplOpenGL3_Init(glsl_version);
 
+    // We only ever render from this one context, so let the renderer keep its
+    // VAO around and stream each frame into a single fenced buffer region.
+    ImGui_ImplOpenGL3_SetStreamingBuffers(true);
+
+    // We own all of the GL state in this application, so the renderer doesn't
+    // need to query and restore it every frame. We just have to tell it when
+    // someone else touched the state, see EndFrame.
+    ImGui_ImplOpenGL3_SetShadowedState(true);
+
+    mProfiler.Initialize();
+
+    // Cheap enough to leave on, so there's always a trace of the last few
+    // seconds when something hitches.
+    ImGui_ImplTrace_SetEnabled(true);
+
     // Setup style
     ImGui::StyleColorsDark();
 
@@ -145,66 +305,418 @@ namespace SOIS
   ApplicationContext::~ApplicationContext()
   {
     // Cleanup
-    ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
-    ImGui::DestroyContext();
+    if (nullptr != ImGui::GetCurrentContext())
+    {
+      mCapture.Stop();
+      mProfiler.Shutdown();
+      ImGui_ImplTrace_Shutdown();
+      ImGui_ImplOpenGL3_Shutdown();
+
+      if (nullptr != mWindow)
+      {
+        ImGui_ImplGlfw_Shutdown();
+      }
+
+      ImGui::DestroyContext();
+    }
+
+    mOffscreen.reset();
+
+    if (nullptr != mWindow)
+    {
+      glfwDestroyWindow(mWindow);
+    }
 
-    glfwDestroyWindow(mWindow);
     glfwTerminate();
   }
 
+  bool ApplicationContext::ReadFramebuffer(std::vector<unsigned char>& aRgba, int& aWidth, int& aHeight)
+  {
+    if (nullptr == mOffscreen)
+    {
+      return false;
+    }
+
+    mOffscreen->Read(aRgba);
+    aWidth = mOffscreen->GetWidth();
+    aHeight = mOffscreen->GetHeight();
+    return true;
+  }
+
 
   void ApplicationContext::EndApplication()
   {
     mRunning = false;
   }
 
+  void ApplicationContext::SetTracing(bool aEnabled)
+  {
+    ImGui_ImplTrace_SetEnabled(aEnabled);
+  }
+
+  bool ApplicationContext::GetTracing() const
+  {
+    return ImGui_ImplTrace_IsEnabled();
+  }
+
+  bool ApplicationContext::WriteTrace(char const* aFile)
+  {
+    char defaultFile[32];
+    if (nullptr == aFile)
+    {
+      snprintf(defaultFile, sizeof(defaultFile), "trace_%d.json", mTracesWritten);
+      aFile = defaultFile;
+    }
+
+    if (false == ImGui_ImplTrace_WriteFile(aFile))
+    {
+      return false;
+    }
+
+    ++mTracesWritten;
+    return true;
+  }
+
   bool ApplicationContext::Update()
   {
     EndFrame();
+    mProfiler.EndFrame();
 
     if (false == mRunning ||
-        false != glfwWindowShouldClose(mWindow))
+        (nullptr != mWindow && false != glfwWindowShouldClose(mWindow)))
     {
       return false;
     }
 
+    WaitForNextFrame();
     BeginFrame();
 
     return true;
   }
 
-  void ApplicationContext::BeginFrame()
+  void ApplicationContext::SetFramePacing(FramePacing aPacing, double aTargetFps)
   {
-    // Poll and handle events (inputs, window resize, etc.)
-    // You can read the io.WantCaptureMouse, io.WantCaptureKeyboard flags to tell if dear imgui wants to use your inputs.
-    // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application.
-    // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application.
-    // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
-    glfwPollEvents();
+    mPacing = aPacing;
+    mTargetFps = aTargetFps > 1.0 ? aTargetFps : 1.0;
 
-    // Start the Dear ImGui frame
-    ImGui_ImplOpenGL3_NewFrame();
-    ImGui_ImplGlfw_NewFrame();
-    ImGui::NewFrame();
+    // Only the modes that wait on vertical blank keep a swap interval, the
+    // others do their own waiting (or none at all).
+    bool vsync = FramePacing::VSync == aPacing || FramePacing::LowLatency == aPacing;
+    if (nullptr != mWindow)
+    {
+      glfwMakeContextCurrent(mWindow);
+      glfwSwapInterval(vsync ? 1 : 0);
+    }
+
+    mLatency = LatencyReport{};
+    mWorkEstimate = 0.0;
+  }
+
+  void ApplicationContext::SetIdleRendering(bool aEnabled)
+  {
+    mIdleRendering = aEnabled;
+    mRedrawFrames = 0;
+  }
+
+  void ApplicationContext::Invalidate()
+  {
+    mInvalidated = true;
+    mForcePresent = true;
+
+    // Wakes up WaitForEvents. Headless frames never wait, and GLFW may not
+    // even be initialized (with EGL).
+    if (false == IsHeadless())
+    {
+      glfwPostEmptyEvent();
+    }
+  }
+
+  void ApplicationContext::SetSkipUnchangedFrames(bool aEnabled)
+  {
+    mSkipUnchangedFrames = aEnabled;
+    mForcePresent = true;
+  }
+
+  void ApplicationContext::OnWindowEvent(GLFWwindow* aWindow)
+  {
+    auto self = static_cast<ApplicationContext*>(glfwGetWindowUserPointer(aWindow));
+
+    if (nullptr != self)
+    {
+      self->mEventPending = true;
+    }
+  }
+
+  void ApplicationContext::WaitForEvents()
+  {
+    IMGUI_TRACE_ZONE("ApplicationContext::WaitForEvents");
+
+    if (false == mIdleRendering || mRedrawFrames > 0 || mEventPending)
+    {
+      // Poll and handle events (inputs, window resize, etc.)
+      // You can read the io.WantCaptureMouse, io.WantCaptureKeyboard flags to tell if dear imgui wants to use your inputs.
+      // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application.
+      // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application.
+      // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
+      glfwPollEvents();
+      mRedrawFrames = mRedrawFrames > 0 ? mRedrawFrames - 1 : 0;
+      return;
+    }
+
+    // Sleep in the OS until something we care about happens. GLFW also wakes
+    // us for events we don't track (window moves and such), so keep waiting
+    // until one of our callbacks fired.
+    while (false == mEventPending &&
+           false == mInvalidated &&
+           false == glfwWindowShouldClose(mWindow))
+    {
+      if (mIdleTimeout > 0.0)
+      {
+        // Something is animating slowly (the text cursor), one wait is all
+        // we do before redrawing.
+        glfwWaitEventsTimeout(mIdleTimeout);
+        break;
+      }
+
+      glfwWaitEvents();
+    }
+
+    mInvalidated = false;
+  }
+
+  void ApplicationContext::UpdateIdleState()
+  {
+    if (false == mIdleRendering)
+    {
+      return;
+    }
+
+    // ImGui may need a couple of frames to react to input: popups open the
+    // frame after a click, auto-resizing windows measure and then resize.
+    int const settleFrames = 3;
+
+    if (mEventPending)
+    {
+      mRedrawFrames = settleFrames;
+      mEventPending = false;
+    }
+
+    // Something is being dragged or held, keep rendering until it's let go.
+    ImGuiIO& io = ImGui::GetIO();
+    bool mouseDown = false;
+    for (bool down : io.MouseDown)
+    {
+      mouseDown = mouseDown || down;
+    }
+
+    if (mouseDown || (ImGui::IsAnyItemActive() && false == io.WantTextInput))
+    {
+      mRedrawFrames = mRedrawFrames > 1 ? mRedrawFrames : 1;
+    }
+
+    // A focused text field only needs redraws for its blinking cursor.
+    mIdleTimeout = io.WantTextInput ? 0.1 : 0.0;
+  }
+
+  double ApplicationContext::GetRefreshPeriod() const
+  {
+    GLFWmonitor* monitor = glfwGetPrimaryMonitor();
+    GLFWvidmode const* mode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+
+    if (nullptr == mode || mode->refreshRate <= 0)
+    {
+      return 1.0 / 60.0;
+    }
+
+    return 1.0 / mode->refreshRate;
+  }
+
+  void ApplicationContext::WaitForNextFrame()
+  {
+    IMGUI_TRACE_ZONE("ApplicationContext::WaitForNextFrame");
+    using Seconds = std::chrono::duration<double>;
 
-    // Clear the viewport to prepare for user rendering.
+    // Headless runs go as fast as they can.
+    if (IsHeadless())
+    {
+      return;
+    }
+
+    switch (mPacing)
+    {
+      case FramePacing::VSync:
+      case FramePacing::Uncapped:
+      {
+        // The swap already did all the waiting we want.
+        break;
+      }
+      case FramePacing::FpsCap:
+      {
+        auto period = std::chrono::duration_cast<Clock::duration>(Seconds(1.0 / mTargetFps));
+        SleepUntil(mFrameStart + period);
+        break;
+      }
+      case FramePacing::LowLatency:
+      {
+        // The swap returned around the last vertical blank, so the next one is
+        // a refresh period after it. Poll as late as we can while still
+        // leaving enough time to build and submit the frame, with some slack
+        // for the estimate being wrong.
+        double slack = 0.001 + mWorkEstimate * 0.25;
+        double wait = GetRefreshPeriod() - mWorkEstimate - slack;
+
+        if (wait > 0.0)
+        {
+          SleepUntil(mPresentTime + std::chrono::duration_cast<Clock::duration>(Seconds(wait)));
+        }
+        break;
+      }
+    }
+  }
+
+  void ApplicationContext::BeginFrame()
+  {
+    IMGUI_TRACE_ZONE("ApplicationContext::BeginFrame");
+    mFrameStart = Clock::now();
+    mProfiler.BeginFrame();
+    FrameAllocator::Get().BeginFrame();
     int display_w, display_h;
-    glfwMakeContextCurrent(mWindow);
-    glfwGetFramebufferSize(mWindow, &display_w, &display_h);
+
+    if (nullptr != mOffscreen)
+    {
+      // No platform binding, so feed ImGui a fixed size and time step.
+      mInputTime = mFrameStart;
+      display_w = mOffscreen->GetWidth();
+      display_h = mOffscreen->GetHeight();
+
+      ImGuiIO& io = ImGui::GetIO();
+      io.DisplaySize = ImVec2(static_cast<float>(display_w), static_cast<float>(display_h));
+      io.DisplayFramebufferScale = ImVec2(1.0f, 1.0f);
+      io.DeltaTime = 1.0f / 60.0f;
+
+      mProfiler.BeginPhase(FramePhase::NewFrame);
+      ImGui_ImplOpenGL3_NewFrame();
+      {
+        IMGUI_TRACE_ZONE("ImGui::NewFrame");
+        ImGui::NewFrame();
+      }
+      mProfiler.EndPhase(FramePhase::NewFrame);
+
+      mOffscreen->Bind();
+    }
+    else
+    {
+      // Poll (or, when idle rendering, wait for) events.
+      mProfiler.BeginPhase(FramePhase::PollEvents);
+      WaitForEvents();
+      mProfiler.EndPhase(FramePhase::PollEvents);
+      mInputTime = Clock::now();
+
+      // Start the Dear ImGui frame
+      mProfiler.BeginPhase(FramePhase::NewFrame);
+      ImGui_ImplOpenGL3_NewFrame();
+      ImGui_ImplGlfw_NewFrame();
+      {
+        IMGUI_TRACE_ZONE("ImGui::NewFrame");
+        ImGui::NewFrame();
+      }
+      mProfiler.EndPhase(FramePhase::NewFrame);
+
+      glfwMakeContextCurrent(mWindow);
+      glfwGetFramebufferSize(mWindow, &display_w, &display_h);
+    }
+
+    mFramebufferWidth = display_w;
+    mFramebufferHeight = display_h;
+
+    // Clear the viewport to prepare for user rendering. With shadowed state
+    // the renderer leaves the scissor test on after the last frame, which
+    // would clip the clear to its last clip rectangle. Turning it off here is
+    // fine as EndFrame invalidates the renderer's shadowed state anyway.
+    gl::glDisable(gl::GL_SCISSOR_TEST);
     gl::glViewport(0, 0, display_w, display_h);
     gl::glClearColor(mClearColor.x, mClearColor.y, mClearColor.z, mClearColor.w);
     gl::glClear(gl::GL_COLOR_BUFFER_BIT);
+
+    // Everything until the next Update() is the user's.
+    mProfiler.BeginPhase(FramePhase::UserUpdate);
   }
 
   void ApplicationContext::EndFrame()
   {
-    // Rendering Dear ImGui.
-    ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    IMGUI_TRACE_ZONE("ApplicationContext::EndFrame");
+
+    // Rendering Dear ImGui. User code may have changed any GL state since
+    // the last frame, so the renderer can't trust what it last set.
+    mProfiler.EndPhase(FramePhase::UserUpdate);
+    mProfiler.BeginPhase(FramePhase::Render);
+    {
+      IMGUI_TRACE_ZONE("ImGui::Render");
+      ImGui::Render();
+    }
+    mProfiler.EndPhase(FramePhase::Render);
+    UpdateIdleState();
+
+    // When nothing differs from what's on screen, skip rendering and the
+    // swap. We still wait out a refresh so we don't spin without vsync. A
+    // plain sleep: there's nothing new to show, so waking a little late
+    // costs nothing, unlike SleepUntil's spin through the last 2 ms.
+    ImDrawData* drawData = ImGui::GetDrawData();
+    if (mSkipUnchangedFrames)
+    {
+      bool changed = ImGui_ImplOpenGL3_HasDrawDataChanged(drawData);
+      changed = mForcePresent.exchange(false) || changed;
+      changed = changed || mPresentedClearColor != mClearColor;
+
+      if (false == changed)
+      {
+        ++mSkippedFrames;
+
+        if (nullptr != mWindow && (FramePacing::VSync == mPacing || FramePacing::LowLatency == mPacing))
+        {
+          std::this_thread::sleep_until(mFrameStart + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(GetRefreshPeriod())));
+        }
+
+        return;
+      }
+    }
+    mPresentedClearColor = mClearColor;
+
+    ImGui_ImplOpenGL3_InvalidateShadowedState();
+    mProfiler.BeginPhase(FramePhase::RenderDrawData);
+    ImGui_ImplOpenGL3_RenderDrawData(drawData);
+    mProfiler.EndPhase(FramePhase::RenderDrawData);
+
+    // Reads from the back buffer (or our framebuffer when headless), the
+    // pixels arrive a few frames later.
+    mCapture.Capture(mFramebufferWidth, mFramebufferHeight);
+
+    // Offscreen frames stay in the framebuffer until ReadFramebuffer.
+    if (nullptr != mOffscreen)
+    {
+      return;
+    }
 
     // Swap the buffers and prepare for next frame.
     glfwMakeContextCurrent(mWindow);
-    glfwSwapBuffers(mWindow);
+    auto submitTime = Clock::now();
+    mProfiler.BeginPhase(FramePhase::SwapBuffers);
+    {
+      IMGUI_TRACE_ZONE("glfwSwapBuffers");
+      glfwSwapBuffers(mWindow);
+    }
+    mProfiler.EndPhase(FramePhase::SwapBuffers);
+
+    // With a swap interval the swap returns once the frame is queued for the
+    // blank, that's as close to the actual present as we can measure here.
+    mPresentTime = Clock::now();
+    double latency = std::chrono::duration<double>(mPresentTime - mInputTime).count();
+    mLatency.mLastMs = static_cast<float>(latency * 1000.0);
+    mLatency.mAverageMs = (0.0f == mLatency.mAverageMs) ? mLatency.mLastMs : mLatency.mAverageMs + (mLatency.mLastMs - mLatency.mAverageMs) * 0.05f;
+
+    // The work estimate leaves out the swap, otherwise time spent blocking on
+    // the blank would make low latency pacing poll earlier and earlier.
+    double work = std::chrono::duration<double>(submitTime - mInputTime).count();
+    mWorkEstimate = (0.0 == mWorkEstimate) ? work : mWorkEstimate + (work - mWorkEstimate) * 0.1;
   }
 }
\ No newline at end of file
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
 #include "imgui.h"
 
 #include <GLFW/glfw3.h> // Include glfw3.h after our OpenGL definitions
@@ -9,21 +14,66 @@
 
 #include "glm/glm.hpp"
 
+#include "FrameAllocator.hpp"
+#include "FrameCapture.hpp"
+#include "FrameProfiler.hpp"
+#include "OffscreenSurface.hpp"
+
 namespace SOIS
 {
   // Call only once, loads OpenGL function pointers and other such work.
   void ApplicationInitialization();
 
+  // How the application paces its frames.
+  enum class FramePacing
+  {
+    // Swap on every vertical blank.
+    VSync,
+    // No swap interval and no waiting, render as fast as possible.
+    Uncapped,
+    // No swap interval, sleep (and spin the last stretch) to hold the target FPS.
+    FpsCap,
+    // Swap on vertical blank, but wait with polling input until just before
+    // the frame has to be built to make the next blank.
+    LowLatency
+  };
+
+  // Time from polling input to the swap returning, measured every frame.
+  struct LatencyReport
+  {
+    float mLastMs = 0.0f;
+    float mAverageMs = 0.0f;
+  };
+
+  // How the ApplicationContext should be created.
+  struct ContextSettings
+  {
+    // Render into an offscreen framebuffer instead of a window, for tests and
+    // benchmarks on machines without a display (or a GPU). There's no input,
+    // no pacing and each frame advances ImGui by a fixed 1/60th of a second.
+    bool mHeadless = false;
+    int mWidth = 1280;
+    int mHeight = 720;
+  };
+
   struct ApplicationContext
   {
   public:
-    GLFWwindow* mWindow;
+    using Clock = std::chrono::steady_clock;
+
+    GLFWwindow* mWindow = nullptr;
     glm::vec4 mClearColor;
-    bool mRunning;
+    bool mRunning = true;
 
-    ApplicationContext();
+    ApplicationContext(ContextSettings const& aSettings = ContextSettings{});
     ~ApplicationContext();
 
+    bool IsHeadless() const { return nullptr != mOffscreen; }
+
+    // Reads back the last rendered frame as RGBA, top row first. Only
+    // available when headless, call it after Update() returned false.
+    bool ReadFramebuffer(std::vector<unsigned char>& aRgba, int& aWidth, int& aHeight);
+
     // Call when the application should update. Check the return
     // value to see if the application should continue.
     bool Update();
@@ -31,8 +81,92 @@ namespace SOIS
     // Call when you want the application to end.
     void EndApplication();
 
+    // Selects the pacing mode, aTargetFps is only used by FramePacing::FpsCap.
+    void SetFramePacing(FramePacing aPacing, double aTargetFps = 60.0);
+    FramePacing GetFramePacing() const { return mPacing; }
+    double GetTargetFps() const { return mTargetFps; }
+
+    // Input-to-present latency of the current pacing mode.
+    LatencyReport const& GetLatency() const { return mLatency; }
+
+    // Idle rendering: Update() blocks until input arrives, a widget is being
+    // interacted with (dragging, text cursor blinking), or Invalidate() is
+    // called. Static UIs then cost next to nothing.
+    void SetIdleRendering(bool aEnabled);
+    bool GetIdleRendering() const { return mIdleRendering; }
+
+    // Requests a new frame while idle rendering, safe to call from any thread.
+    void Invalidate();
+
+    // Skips rendering and presenting frames whose ImGui output and clear
+    // color match the last presented frame. Anything else you draw must call
+    // Invalidate() when it changes, or it won't show up.
+    void SetSkipUnchangedFrames(bool aEnabled);
+    bool GetSkipUnchangedFrames() const { return mSkipUnchangedFrames; }
+    int GetSkippedFrameCount() const { return mSkippedFrames; }
+
+    // Frames are captured while this is started, see FrameCapture. Stop it
+    // (or let us stop it on destruction) to finish writing queued frames.
+    FrameCapture& GetCapture() { return mCapture; }
+
+    // Per phase CPU and GPU timings, disabled until you enable it.
+    FrameProfiler& GetProfiler() { return mProfiler; }
+
+    // Everything ImGui allocates goes through this, GetLastFrameStats() tells
+    // how much the last frame allocated (none of it from the system heap once
+    // the UI has settled). Scratch memory for the current frame comes from
+    // its AllocateTransient().
+    FrameAllocator& GetAllocator() { return FrameAllocator::Get(); }
+
+    // Zones marked with IMGUI_TRACE_ZONE (see imgui_impl_trace.h) are kept in
+    // per thread rings while tracing is enabled, which it is by default.
+    // WriteTrace saves them as a Chrome trace in the background, with no file
+    // given it picks trace_N.json in the working directory. F12 does the same.
+    void SetTracing(bool aEnabled);
+    bool GetTracing() const;
+    bool WriteTrace(char const* aFile = nullptr);
+
+    // Called by our GLFW callbacks whenever the window received input.
+    static void OnWindowEvent(GLFWwindow* aWindow);
+
   private:
     void BeginFrame();
     void EndFrame();
+    void WaitForNextFrame();
+    void WaitForEvents();
+    void UpdateIdleState();
+    double GetRefreshPeriod() const;
+
+    std::unique_ptr<OffscreenSurface> mOffscreen;
+    FrameCapture mCapture;
+    FrameProfiler mProfiler;
+    int mTracesWritten = 0;
+    int mFramebufferWidth = 0;
+    int mFramebufferHeight = 0;
+
+    FramePacing mPacing = FramePacing::VSync;
+    double mTargetFps = 60.0;
+    LatencyReport mLatency;
+    Clock::time_point mInputTime;
+    Clock::time_point mFrameStart;
+    Clock::time_point mPresentTime;
+    // Estimated time from polling input to submitting the swap, used to
+    // decide how late FramePacing::LowLatency can poll.
+    double mWorkEstimate = 0.0;
+
+    bool mIdleRendering = false;
+    // Set by our GLFW callbacks, cleared once a frame has seen the events.
+    bool mEventPending = false;
+    std::atomic<bool> mInvalidated{ false };
+    // Frames to render without waiting, so ImGui can settle after input
+    // (popups opening, auto-resizing windows) or keep up with a drag.
+    int mRedrawFrames = 0;
+    // How long to wait for events before redrawing anyway, 0 waits forever.
+    double mIdleTimeout = 0.0;
+
+    bool mSkipUnchangedFrames = false;
+    std::atomic<bool> mForcePresent{ false };
+    glm::vec4 mPresentedClearColor;
+    int mSkippedFrames = 0;
   };
 }
\ No newline at end of file
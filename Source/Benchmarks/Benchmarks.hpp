@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+namespace SOIS
+{
+  // Runs aBody aRuns times and returns the best time per operation, in
+  // nanoseconds, aBody doing aOperations operations per run. The best run
+  // is the one least disturbed by the rest of the machine.
+  template <typename tBody>
+  double MeasureNs(int aOperations, tBody&& aBody, int aRuns = 5)
+  {
+    double best = 0.0;
+
+    for (int run = 0; run < aRuns; ++run)
+    {
+      auto start = std::chrono::steady_clock::now();
+      aBody();
+      std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+      double perOperation = elapsed.count() / aOperations;
+      best = (0 == run) ? perOperation : std::min(best, perOperation);
+    }
+
+    return best;
+  }
+
+  // Deterministic pseudo random numbers (xorshift), so runs are comparable.
+  unsigned Random();
+
+  // Keeps the compiler from optimizing away the work producing aValue.
+  void Consume(unsigned aValue);
+
+  // Prints a "name  before  after" row of a comparison table, a negative
+  // value is printed as not measured.
+  void PrintHeader(char const* aTitle, char const* aBefore, char const* aAfter);
+  void PrintRow(char const* aName, double aBefore, double aAfter, char const* aUnit);
+
+  // Each benchmark checks the results it times, and returns false if they
+  // were wrong.
+  bool RunHashBenchmarks();
+  bool RunStorageBenchmarks();
+  bool RunTessellationBenchmarks();
+  bool RunBezierBenchmarks();
+  bool RunWindowBenchmarks();
+  bool RunTraceBenchmarks();
+}
@@ -0,0 +1,214 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "imgui.h"
+#include "imgui_internal.h"
+
+#include "Benchmarks.hpp"
+
+// PathBezierToCasteljau() and PathBezierCurveTo() as they were before
+// subdivision was made iterative and fixed segment counts were forward
+// differenced, unchanged but for being free functions.
+static void ReferencePathBezierToCasteljau(ImVector<ImVec2>* path, float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4, float tess_tol, int level)
+{
+    float dx = x4 - x1;
+    float dy = y4 - y1;
+    float d2 = ((x2 - x4) * dy - (y2 - y4) * dx);
+    float d3 = ((x3 - x4) * dy - (y3 - y4) * dx);
+    d2 = (d2 >= 0) ? d2 : -d2;
+    d3 = (d3 >= 0) ? d3 : -d3;
+    if ((d2+d3) * (d2+d3) < tess_tol * (dx*dx + dy*dy))
+    {
+        path->push_back(ImVec2(x4, y4));
+    }
+    else if (level < 10)
+    {
+        float x12 = (x1+x2)*0.5f,       y12 = (y1+y2)*0.5f;
+        float x23 = (x2+x3)*0.5f,       y23 = (y2+y3)*0.5f;
+        float x34 = (x3+x4)*0.5f,       y34 = (y3+y4)*0.5f;
+        float x123 = (x12+x23)*0.5f,    y123 = (y12+y23)*0.5f;
+        float x234 = (x23+x34)*0.5f,    y234 = (y23+y34)*0.5f;
+        float x1234 = (x123+x234)*0.5f, y1234 = (y123+y234)*0.5f;
+
+        ReferencePathBezierToCasteljau(path, x1,y1,        x12,y12,    x123,y123,  x1234,y1234, tess_tol, level+1);
+        ReferencePathBezierToCasteljau(path, x1234,y1234,  x234,y234,  x34,y34,    x4,y4,       tess_tol, level+1);
+    }
+}
+
+static void ReferencePathBezierCurveTo(ImVector<ImVec2>* path, const ImVec2& p2, const ImVec2& p3, const ImVec2& p4, int num_segments, float tess_tol)
+{
+    ImVec2 p1 = path->back();
+    if (num_segments == 0)
+    {
+        // Auto-tessellated
+        ReferencePathBezierToCasteljau(path, p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, p4.x, p4.y, tess_tol, 0);
+    }
+    else
+    {
+        float t_step = 1.0f / (float)num_segments;
+        for (int i_step = 1; i_step <= num_segments; i_step++)
+        {
+            float t = t_step * i_step;
+            float u = 1.0f - t;
+            float w1 = u*u*u;
+            float w2 = 3*u*u*t;
+            float w3 = 3*u*t*t;
+            float w4 = t*t*t;
+            path->push_back(ImVec2(w1*p1.x + w2*p2.x + w3*p3.x + w4*p4.x, w1*p1.y + w2*p2.y + w3*p3.y + w4*p4.y));
+        }
+    }
+}
+
+namespace SOIS
+{
+  struct Curve
+  {
+    ImVec2 mP1;
+    ImVec2 mP2;
+    ImVec2 mP3;
+    ImVec2 mP4;
+  };
+
+  static float RandomCoordinate(float aRange)
+  {
+    return (float)(Random() % 100000) * aRange / 100000.0f;
+  }
+
+  static Curve RandomCurve(float aRange)
+  {
+    return Curve{ ImVec2(RandomCoordinate(aRange), RandomCoordinate(aRange)),
+                  ImVec2(RandomCoordinate(aRange), RandomCoordinate(aRange)),
+                  ImVec2(RandomCoordinate(aRange), RandomCoordinate(aRange)),
+                  ImVec2(RandomCoordinate(aRange), RandomCoordinate(aRange)) };
+  }
+
+  static void ReferenceFlatten(ImVector<ImVec2>& aPath, Curve const& aCurve, int aSegments, float aTolerance)
+  {
+    aPath.resize(0);
+    aPath.push_back(aCurve.mP1);
+    ReferencePathBezierCurveTo(&aPath, aCurve.mP2, aCurve.mP3, aCurve.mP4, aSegments, aTolerance);
+  }
+
+  static void Flatten(ImDrawList& aDrawList, Curve const& aCurve, int aSegments)
+  {
+    aDrawList.PathClear();
+    aDrawList.PathLineTo(aCurve.mP1);
+    aDrawList.PathBezierCurveTo(aCurve.mP2, aCurve.mP3, aCurve.mP4, aSegments);
+  }
+
+  // Auto-tessellated curves must come out bit for bit the same, fixed
+  // segment counts within aMaxDistance (forward differencing rounds
+  // differently than evaluating the polynomial).
+  static bool SamePath(ImVector<ImVec2> const& aReference, ImVector<ImVec2> const& aCurrent, float aMaxDistance)
+  {
+    if (aReference.Size != aCurrent.Size)
+    {
+      return false;
+    }
+
+    if (0.0f == aMaxDistance)
+    {
+      return 0 == memcmp(aReference.Data, aCurrent.Data, aReference.Size * sizeof(ImVec2));
+    }
+
+    for (int i = 0; i < aReference.Size; ++i)
+    {
+      if (aMaxDistance < fabsf(aReference[i].x - aCurrent[i].x) || aMaxDistance < fabsf(aReference[i].y - aCurrent[i].y))
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  bool RunBezierBenchmarks()
+  {
+    bool passed = true;
+
+    // A context of its own, to flatten at other tolerances than the style's.
+    ImDrawListSharedData data;
+    ImDrawList current(&data);
+    ImVector<ImVec2> reference;
+
+    // Curves that never test flat split down to the last level: the
+    // degenerate ones and loops much bigger than the tolerance.
+    std::vector<Curve> curves =
+    {
+      { ImVec2(100.0f, 100.0f), ImVec2(100.0f, 100.0f), ImVec2(100.0f, 100.0f), ImVec2(100.0f, 100.0f) },
+      { ImVec2(100.0f, 100.0f), ImVec2(100.0f, 100.0f), ImVec2(100.0f, 100.0f), ImVec2(500.0f, 300.0f) },
+      { ImVec2(100.0f, 100.0f), ImVec2(500.0f, 300.0f), ImVec2(500.0f, 300.0f), ImVec2(500.0f, 300.0f) },
+      { ImVec2(0.0f, 0.0f), ImVec2(8000.0f, 8000.0f), ImVec2(-8000.0f, 8000.0f), ImVec2(0.0f, 0.0f) },
+      { ImVec2(0.0f, 0.0f), ImVec2(8000.0f, 8000.0f), ImVec2(-8000.0f, 8000.0f), ImVec2(1.0f, 0.0f) },
+      { ImVec2(0.0f, 0.0f), ImVec2(1e-6f, 0.0f), ImVec2(0.0f, 1e-6f), ImVec2(1e-6f, 1e-6f) },
+      { ImVec2(0.0f, 0.0f), ImVec2(100.0f, 100.0f), ImVec2(200.0f, 200.0f), ImVec2(300.0f, 300.0f) },
+    };
+
+    for (int i = 0; i < 1000; ++i)
+    {
+      curves.push_back(RandomCurve(20000.0f));
+    }
+
+    for (float tolerance : { 1.25f, 0.01f, 0.0001f, 100.0f })
+    {
+      data.CurveTessellationTol = tolerance;
+      for (Curve const& curve : curves)
+      {
+        ReferenceFlatten(reference, curve, 0, tolerance);
+        Flatten(current, curve, 0);
+        passed = passed && SamePath(reference, current._Path, 0.0f);
+      }
+    }
+
+    for (Curve const& curve : curves)
+    {
+      for (int segments : { -5, -1, 1, 2, 32 })
+      {
+        ReferenceFlatten(reference, curve, segments, 0.0f);
+        Flatten(current, curve, segments);
+        passed = passed && SamePath(reference, current._Path, 0.05f);
+      }
+    }
+
+    if (false == passed)
+    {
+      printf("PathBezierCurveTo differs from the reference.\n");
+    }
+
+    // Screen sized curves, path building only.
+    PrintHeader("Bezier flattening, 10k curves", "reference", "current");
+
+    std::vector<Curve> screenCurves(10000);
+    for (Curve& curve : screenCurves)
+    {
+      curve = RandomCurve(1920.0f);
+    }
+
+    data.CurveTessellationTol = ImGui::GetStyle().CurveTessellationTol;
+    for (int segments : { 0, 32 })
+    {
+      double referenceNs = MeasureNs(1, [&]()
+      {
+        for (Curve const& curve : screenCurves)
+        {
+          ReferenceFlatten(reference, curve, segments, data.CurveTessellationTol);
+          Consume(reference.Size);
+        }
+      });
+      double currentNs = MeasureNs(1, [&]()
+      {
+        for (Curve const& curve : screenCurves)
+        {
+          Flatten(current, curve, segments);
+          Consume(current._Path.Size);
+        }
+      });
+      PrintRow(0 == segments ? "auto tessellated" : "32 segments", referenceNs / 1000000.0, currentNs / 1000000.0, "ms");
+    }
+
+    return passed;
+  }
+}
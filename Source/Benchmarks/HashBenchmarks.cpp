@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "imgui.h"
+#include "imgui_internal.h"
+
+#include "Benchmarks.hpp"
+
+namespace SOIS
+{
+  // ImHash as it was before slice-by-8: a table lookup per byte, resetting
+  // to the seed on every "###" of a zero-terminated string.
+  static ImU32 ReferenceHash(void const* aData, int aSize, ImU32 aSeed)
+  {
+    static ImU32 table[256] = { 0 };
+    if (0 == table[1])
+    {
+      for (ImU32 i = 0; i < 256; ++i)
+      {
+        ImU32 crc = i;
+        for (int j = 0; j < 8; ++j)
+        {
+          crc = (crc >> 1) ^ (ImU32(-int(crc & 1)) & 0xEDB88320);
+        }
+        table[i] = crc;
+      }
+    }
+
+    aSeed = ~aSeed;
+    ImU32 crc = aSeed;
+    unsigned char const* current = static_cast<unsigned char const*>(aData);
+
+    if (0 < aSize)
+    {
+      while (aSize--)
+      {
+        crc = (crc >> 8) ^ table[(crc & 0xFF) ^ *current++];
+      }
+    }
+    else
+    {
+      while (unsigned char c = *current++)
+      {
+        if ('#' == c && '#' == current[0] && '#' == current[1])
+        {
+          crc = aSeed;
+        }
+        crc = (crc >> 8) ^ table[(crc & 0xFF) ^ c];
+      }
+    }
+
+    return ~crc;
+  }
+
+  bool RunHashBenchmarks()
+  {
+    bool passed = true;
+
+    // Random labels of 1 to 64 characters, with runs of '#' so the "###"
+    // handling (including overlapping runs) is checked too.
+    constexpr int cLabelCount = 200000;
+    std::vector<char> labelText;
+    std::vector<int> labelOffsets;
+    labelText.reserve(cLabelCount * 34);
+
+    for (int i = 0; i < cLabelCount; ++i)
+    {
+      labelOffsets.push_back(static_cast<int>(labelText.size()));
+      int length = 1 + Random() % 64;
+      for (int c = 0; c < length; ++c)
+      {
+        labelText.push_back(0 == Random() % 4 ? '#' : static_cast<char>('a' + Random() % 26));
+      }
+      labelText.push_back('\0');
+    }
+
+    int mismatches = 0;
+    for (int i = 0; i < cLabelCount; ++i)
+    {
+      char const* label = labelText.data() + labelOffsets[i];
+      ImU32 seed = Random();
+      mismatches += (ReferenceHash(label, 0, seed) != ImHash(label, 0, seed)) ? 1 : 0;
+      mismatches += (ReferenceHash(label, static_cast<int>(strlen(label)), seed) != ImHash(label, static_cast<int>(strlen(label)), seed)) ? 1 : 0;
+    }
+
+    if (0 != mismatches)
+    {
+      printf("ImHash differs from the reference for %d of %d labels.\n", mismatches, cLabelCount * 2);
+      passed = false;
+    }
+
+    // Labels like the ones widgets hash every frame.
+    static char const* const cShortLabels[] =
+    {
+      "Button", "Label###id", "##hidden", "Window 1234", "Open...",
+      "A somewhat longer checkbox label", "Position", "Color##Background",
+    };
+    constexpr int cShortLabelCount = static_cast<int>(IM_ARRAYSIZE(cShortLabels));
+    constexpr int cShortRounds = 100000;
+
+    PrintHeader("ImHash", "reference", "ImHash");
+
+    double shortReference = MeasureNs(cShortRounds * cShortLabelCount, [&]()
+    {
+      ImU32 sum = 0;
+      for (int round = 0; round < cShortRounds; ++round)
+      {
+        for (char const* label : cShortLabels)
+        {
+          sum += ReferenceHash(label, 0, sum);
+        }
+      }
+      Consume(sum);
+    });
+
+    double shortCurrent = MeasureNs(cShortRounds * cShortLabelCount, [&]()
+    {
+      ImU32 sum = 0;
+      for (int round = 0; round < cShortRounds; ++round)
+      {
+        for (char const* label : cShortLabels)
+        {
+          sum += ImHash(label, 0, sum);
+        }
+      }
+      Consume(sum);
+    });
+
+    PrintRow("short labels, per label", shortReference, shortCurrent, "ns");
+
+    // Throughput on long input, as GB/s.
+    constexpr int cLongSize = 4096;
+    constexpr int cLongRounds = 2000;
+    std::vector<char> longText(cLongSize + 1);
+    for (int i = 0; i < cLongSize; ++i)
+    {
+      longText[i] = static_cast<char>('a' + Random() % 26);
+    }
+    longText[cLongSize] = '\0';
+
+    for (int zeroTerminated = 0; zeroTerminated < 2; ++zeroTerminated)
+    {
+      int size = zeroTerminated ? 0 : cLongSize;
+
+      double referenceNs = MeasureNs(cLongRounds, [&]()
+      {
+        ImU32 sum = 0;
+        for (int round = 0; round < cLongRounds; ++round)
+        {
+          sum += ReferenceHash(longText.data(), size, sum);
+        }
+        Consume(sum);
+      });
+
+      double currentNs = MeasureNs(cLongRounds, [&]()
+      {
+        ImU32 sum = 0;
+        for (int round = 0; round < cLongRounds; ++round)
+        {
+          sum += ImHash(longText.data(), size, sum);
+        }
+        Consume(sum);
+      });
+
+      PrintRow(zeroTerminated ? "4 KB string, throughput" : "4 KB buffer, throughput", cLongSize / referenceNs, cLongSize / currentNs, "GB/s");
+    }
+
+    return passed;
+  }
+}
@@ -0,0 +1,138 @@
+#include <stdio.h>
+
+#include <vector>
+
+#include "imgui.h"
+
+#include "Benchmarks.hpp"
+
+namespace SOIS
+{
+  // Storages of aKeys, filled either with SetInt (timed by the caller) or
+  // in bulk, which is the only practical way to get a million keys into a
+  // sorted storage.
+  static void Fill(ImGuiStorage& aStorage, std::vector<ImGuiID> const& aKeys)
+  {
+    for (ImGuiID key : aKeys)
+    {
+      aStorage.SetInt(key, static_cast<int>(key));
+    }
+  }
+
+  static void BulkFill(ImGuiStorage& aStorage, std::vector<ImGuiID> const& aKeys)
+  {
+    aStorage.Data.reserve(static_cast<int>(aKeys.size()));
+    for (ImGuiID key : aKeys)
+    {
+      aStorage.Data.push_back(ImGuiStorage::Pair(key, static_cast<int>(key)));
+    }
+    aStorage.BuildSortByKey();
+  }
+
+  static bool Check(ImGuiStorage const& aStorage, std::vector<ImGuiID> const& aKeys)
+  {
+    for (ImGuiID key : aKeys)
+    {
+      if (static_cast<int>(key) != aStorage.GetInt(key, ~static_cast<int>(key)))
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  bool RunStorageBenchmarks()
+  {
+    bool passed = true;
+
+    // Inserting into a sorted storage memmoves its tail, filling one with a
+    // million keys one by one would take minutes.
+    constexpr int cMaxSortedFill = 100000;
+    // Keys inserted into an already full storage, per run.
+    constexpr int cLateInserts = 1000;
+
+    PrintHeader("ImGuiStorage", "sorted", "hash indexed");
+
+    for (int count : { 1000, 100000, 1000000 })
+    {
+      // Random keys, like the hashed IDs of tree nodes.
+      std::vector<ImGuiID> keys(count);
+      for (ImGuiID& key : keys)
+      {
+        key = Random();
+      }
+
+      std::vector<ImGuiID> lookups(count);
+      for (ImGuiID& key : lookups)
+      {
+        key = keys[Random() % count];
+      }
+
+      double fillNs[2] = { -1.0, -1.0 };
+      double lateInsertNs[2];
+      double lookupNs[2];
+
+      for (int hashed = 0; hashed < 2; ++hashed)
+      {
+        if (hashed || count <= cMaxSortedFill)
+        {
+          fillNs[hashed] = MeasureNs(count, [&]()
+          {
+            ImGuiStorage storage;
+            storage.SetHashIndexed(0 != hashed);
+            Fill(storage, keys);
+          }, count <= cMaxSortedFill / 10 ? 5 : 1);
+        }
+
+        ImGuiStorage storage;
+        storage.SetHashIndexed(0 != hashed);
+        if (hashed)
+        {
+          Fill(storage, keys);
+        }
+        else
+        {
+          BulkFill(storage, keys);
+        }
+
+        // Each run inserts new keys into the (slightly growing) full storage.
+        std::vector<ImGuiID> lateKeys(cLateInserts);
+        lateInsertNs[hashed] = MeasureNs(cLateInserts, [&]()
+        {
+          for (ImGuiID& key : lateKeys)
+          {
+            key = Random();
+          }
+          Fill(storage, lateKeys);
+        }, 3);
+
+        lookupNs[hashed] = MeasureNs(count, [&]()
+        {
+          unsigned sum = 0;
+          for (ImGuiID key : lookups)
+          {
+            sum += static_cast<unsigned>(storage.GetInt(key));
+          }
+          Consume(sum);
+        });
+
+        if (false == Check(storage, keys) || false == Check(storage, lateKeys))
+        {
+          printf("%s storage of %d keys returned a wrong value.\n", hashed ? "A hash indexed" : "A sorted", count);
+          passed = false;
+        }
+      }
+
+      char name[64];
+      snprintf(name, sizeof(name), "%d keys, fill, per insert", count);
+      PrintRow(name, fillNs[0], fillNs[1], "ns");
+      snprintf(name, sizeof(name), "%d keys, one more insert", count);
+      PrintRow(name, lateInsertNs[0], lateInsertNs[1], "ns");
+      snprintf(name, sizeof(name), "%d keys, lookup", count);
+      PrintRow(name, lookupNs[0], lookupNs[1], "ns");
+    }
+
+    return passed;
+  }
+}
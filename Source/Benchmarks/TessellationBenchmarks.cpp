@@ -0,0 +1,440 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(alloca)
+  #if defined(__GLIBC__) || defined(__sun) || defined(__CYGWIN__)
+    #include <alloca.h>
+  #elif defined(_WIN32)
+    #include <malloc.h>
+    #if !defined(alloca)
+      #define alloca _alloca
+    #endif
+  #else
+    #include <stdlib.h>
+  #endif
+#endif
+
+#include <vector>
+
+#define IMGUI_DEFINE_MATH_OPERATORS
+#include "imgui.h"
+#include "imgui_internal.h"
+
+#include "Benchmarks.hpp"
+
+// AddPolyline() and AddConvexPolyFilled() as they were before they were
+// vectorized, unchanged but for being free functions.
+static void ReferenceAddPolyline(ImDrawList* draw_list, const ImVec2* points, const int points_count, ImU32 col, bool closed, float thickness)
+{
+    if (points_count < 2)
+        return;
+
+    const ImVec2 uv = draw_list->_Data->TexUvWhitePixel;
+
+    int count = points_count;
+    if (!closed)
+        count = points_count-1;
+
+    const bool thick_line = thickness > 1.0f;
+    if (draw_list->Flags & ImDrawListFlags_AntiAliasedLines)
+    {
+        // Anti-aliased stroke
+        const float AA_SIZE = 1.0f;
+        const ImU32 col_trans = col & ~IM_COL32_A_MASK;
+
+        const int idx_count = thick_line ? count*18 : count*12;
+        const int vtx_count = thick_line ? points_count*4 : points_count*3;
+        draw_list->PrimReserve(idx_count, vtx_count);
+
+        // Temporary buffer
+        ImVec2* temp_normals = (ImVec2*)alloca(points_count * (thick_line ? 5 : 3) * sizeof(ImVec2));
+        ImVec2* temp_points = temp_normals + points_count;
+
+        for (int i1 = 0; i1 < count; i1++)
+        {
+            const int i2 = (i1+1) == points_count ? 0 : i1+1;
+            ImVec2 diff = points[i2] - points[i1];
+            diff *= ImInvLength(diff, 1.0f);
+            temp_normals[i1].x = diff.y;
+            temp_normals[i1].y = -diff.x;
+        }
+        if (!closed)
+            temp_normals[points_count-1] = temp_normals[points_count-2];
+
+        if (!thick_line)
+        {
+            if (!closed)
+            {
+                temp_points[0] = points[0] + temp_normals[0] * AA_SIZE;
+                temp_points[1] = points[0] - temp_normals[0] * AA_SIZE;
+                temp_points[(points_count-1)*2+0] = points[points_count-1] + temp_normals[points_count-1] * AA_SIZE;
+                temp_points[(points_count-1)*2+1] = points[points_count-1] - temp_normals[points_count-1] * AA_SIZE;
+            }
+
+            // FIXME-OPT: Merge the different loops, possibly remove the temporary buffer.
+            unsigned int idx1 = draw_list->_VtxCurrentIdx;
+            for (int i1 = 0; i1 < count; i1++)
+            {
+                const int i2 = (i1+1) == points_count ? 0 : i1+1;
+                unsigned int idx2 = (i1+1) == points_count ? draw_list->_VtxCurrentIdx : idx1+3;
+
+                // Average normals
+                ImVec2 dm = (temp_normals[i1] + temp_normals[i2]) * 0.5f;
+                float dmr2 = dm.x*dm.x + dm.y*dm.y;
+                if (dmr2 > 0.000001f)
+                {
+                    float scale = 1.0f / dmr2;
+                    if (scale > 100.0f) scale = 100.0f;
+                    dm *= scale;
+                }
+                dm *= AA_SIZE;
+                temp_points[i2*2+0] = points[i2] + dm;
+                temp_points[i2*2+1] = points[i2] - dm;
+
+                // Add indexes
+                draw_list->_IdxWritePtr[0] = (ImDrawIdx)(idx2+0); draw_list->_IdxWritePtr[1] = (ImDrawIdx)(idx1+0); draw_list->_IdxWritePtr[2] = (ImDrawIdx)(idx1+2);
+                draw_list->_IdxWritePtr[3] = (ImDrawIdx)(idx1+2); draw_list->_IdxWritePtr[4] = (ImDrawIdx)(idx2+2); draw_list->_IdxWritePtr[5] = (ImDrawIdx)(idx2+0);
+                draw_list->_IdxWritePtr[6] = (ImDrawIdx)(idx2+1); draw_list->_IdxWritePtr[7] = (ImDrawIdx)(idx1+1); draw_list->_IdxWritePtr[8] = (ImDrawIdx)(idx1+0);
+                draw_list->_IdxWritePtr[9] = (ImDrawIdx)(idx1+0); draw_list->_IdxWritePtr[10]= (ImDrawIdx)(idx2+0); draw_list->_IdxWritePtr[11]= (ImDrawIdx)(idx2+1);
+                draw_list->_IdxWritePtr += 12;
+
+                idx1 = idx2;
+            }
+
+            // Add vertexes
+            for (int i = 0; i < points_count; i++)
+            {
+                draw_list->_VtxWritePtr[0].pos = points[i];          draw_list->_VtxWritePtr[0].uv = uv; draw_list->_VtxWritePtr[0].col = col;
+                draw_list->_VtxWritePtr[1].pos = temp_points[i*2+0]; draw_list->_VtxWritePtr[1].uv = uv; draw_list->_VtxWritePtr[1].col = col_trans;
+                draw_list->_VtxWritePtr[2].pos = temp_points[i*2+1]; draw_list->_VtxWritePtr[2].uv = uv; draw_list->_VtxWritePtr[2].col = col_trans;
+                draw_list->_VtxWritePtr += 3;
+            }
+        }
+        else
+        {
+            const float half_inner_thickness = (thickness - AA_SIZE) * 0.5f;
+            if (!closed)
+            {
+                temp_points[0] = points[0] + temp_normals[0] * (half_inner_thickness + AA_SIZE);
+                temp_points[1] = points[0] + temp_normals[0] * (half_inner_thickness);
+                temp_points[2] = points[0] - temp_normals[0] * (half_inner_thickness);
+                temp_points[3] = points[0] - temp_normals[0] * (half_inner_thickness + AA_SIZE);
+                temp_points[(points_count-1)*4+0] = points[points_count-1] + temp_normals[points_count-1] * (half_inner_thickness + AA_SIZE);
+                temp_points[(points_count-1)*4+1] = points[points_count-1] + temp_normals[points_count-1] * (half_inner_thickness);
+                temp_points[(points_count-1)*4+2] = points[points_count-1] - temp_normals[points_count-1] * (half_inner_thickness);
+                temp_points[(points_count-1)*4+3] = points[points_count-1] - temp_normals[points_count-1] * (half_inner_thickness + AA_SIZE);
+            }
+
+            // FIXME-OPT: Merge the different loops, possibly remove the temporary buffer.
+            unsigned int idx1 = draw_list->_VtxCurrentIdx;
+            for (int i1 = 0; i1 < count; i1++)
+            {
+                const int i2 = (i1+1) == points_count ? 0 : i1+1;
+                unsigned int idx2 = (i1+1) == points_count ? draw_list->_VtxCurrentIdx : idx1+4;
+
+                // Average normals
+                ImVec2 dm = (temp_normals[i1] + temp_normals[i2]) * 0.5f;
+                float dmr2 = dm.x*dm.x + dm.y*dm.y;
+                if (dmr2 > 0.000001f)
+                {
+                    float scale = 1.0f / dmr2;
+                    if (scale > 100.0f) scale = 100.0f;
+                    dm *= scale;
+                }
+                ImVec2 dm_out = dm * (half_inner_thickness + AA_SIZE);
+                ImVec2 dm_in = dm * half_inner_thickness;
+                temp_points[i2*4+0] = points[i2] + dm_out;
+                temp_points[i2*4+1] = points[i2] + dm_in;
+                temp_points[i2*4+2] = points[i2] - dm_in;
+                temp_points[i2*4+3] = points[i2] - dm_out;
+
+                // Add indexes
+                draw_list->_IdxWritePtr[0]  = (ImDrawIdx)(idx2+1); draw_list->_IdxWritePtr[1]  = (ImDrawIdx)(idx1+1); draw_list->_IdxWritePtr[2]  = (ImDrawIdx)(idx1+2);
+                draw_list->_IdxWritePtr[3]  = (ImDrawIdx)(idx1+2); draw_list->_IdxWritePtr[4]  = (ImDrawIdx)(idx2+2); draw_list->_IdxWritePtr[5]  = (ImDrawIdx)(idx2+1);
+                draw_list->_IdxWritePtr[6]  = (ImDrawIdx)(idx2+1); draw_list->_IdxWritePtr[7]  = (ImDrawIdx)(idx1+1); draw_list->_IdxWritePtr[8]  = (ImDrawIdx)(idx1+0);
+                draw_list->_IdxWritePtr[9]  = (ImDrawIdx)(idx1+0); draw_list->_IdxWritePtr[10] = (ImDrawIdx)(idx2+0); draw_list->_IdxWritePtr[11] = (ImDrawIdx)(idx2+1);
+                draw_list->_IdxWritePtr[12] = (ImDrawIdx)(idx2+2); draw_list->_IdxWritePtr[13] = (ImDrawIdx)(idx1+2); draw_list->_IdxWritePtr[14] = (ImDrawIdx)(idx1+3);
+                draw_list->_IdxWritePtr[15] = (ImDrawIdx)(idx1+3); draw_list->_IdxWritePtr[16] = (ImDrawIdx)(idx2+3); draw_list->_IdxWritePtr[17] = (ImDrawIdx)(idx2+2);
+                draw_list->_IdxWritePtr += 18;
+
+                idx1 = idx2;
+            }
+
+            // Add vertexes
+            for (int i = 0; i < points_count; i++)
+            {
+                draw_list->_VtxWritePtr[0].pos = temp_points[i*4+0]; draw_list->_VtxWritePtr[0].uv = uv; draw_list->_VtxWritePtr[0].col = col_trans;
+                draw_list->_VtxWritePtr[1].pos = temp_points[i*4+1]; draw_list->_VtxWritePtr[1].uv = uv; draw_list->_VtxWritePtr[1].col = col;
+                draw_list->_VtxWritePtr[2].pos = temp_points[i*4+2]; draw_list->_VtxWritePtr[2].uv = uv; draw_list->_VtxWritePtr[2].col = col;
+                draw_list->_VtxWritePtr[3].pos = temp_points[i*4+3]; draw_list->_VtxWritePtr[3].uv = uv; draw_list->_VtxWritePtr[3].col = col_trans;
+                draw_list->_VtxWritePtr += 4;
+            }
+        }
+        draw_list->_VtxCurrentIdx += (ImDrawIdx)vtx_count;
+    }
+    else
+    {
+        // Non Anti-aliased Stroke
+        const int idx_count = count*6;
+        const int vtx_count = count*4;      // FIXME-OPT: Not sharing edges
+        draw_list->PrimReserve(idx_count, vtx_count);
+
+        for (int i1 = 0; i1 < count; i1++)
+        {
+            const int i2 = (i1+1) == points_count ? 0 : i1+1;
+            const ImVec2& p1 = points[i1];
+            const ImVec2& p2 = points[i2];
+            ImVec2 diff = p2 - p1;
+            diff *= ImInvLength(diff, 1.0f);
+
+            const float dx = diff.x * (thickness * 0.5f);
+            const float dy = diff.y * (thickness * 0.5f);
+            draw_list->_VtxWritePtr[0].pos.x = p1.x + dy; draw_list->_VtxWritePtr[0].pos.y = p1.y - dx; draw_list->_VtxWritePtr[0].uv = uv; draw_list->_VtxWritePtr[0].col = col;
+            draw_list->_VtxWritePtr[1].pos.x = p2.x + dy; draw_list->_VtxWritePtr[1].pos.y = p2.y - dx; draw_list->_VtxWritePtr[1].uv = uv; draw_list->_VtxWritePtr[1].col = col;
+            draw_list->_VtxWritePtr[2].pos.x = p2.x - dy; draw_list->_VtxWritePtr[2].pos.y = p2.y + dx; draw_list->_VtxWritePtr[2].uv = uv; draw_list->_VtxWritePtr[2].col = col;
+            draw_list->_VtxWritePtr[3].pos.x = p1.x - dy; draw_list->_VtxWritePtr[3].pos.y = p1.y + dx; draw_list->_VtxWritePtr[3].uv = uv; draw_list->_VtxWritePtr[3].col = col;
+            draw_list->_VtxWritePtr += 4;
+
+            draw_list->_IdxWritePtr[0] = (ImDrawIdx)(draw_list->_VtxCurrentIdx); draw_list->_IdxWritePtr[1] = (ImDrawIdx)(draw_list->_VtxCurrentIdx+1); draw_list->_IdxWritePtr[2] = (ImDrawIdx)(draw_list->_VtxCurrentIdx+2);
+            draw_list->_IdxWritePtr[3] = (ImDrawIdx)(draw_list->_VtxCurrentIdx); draw_list->_IdxWritePtr[4] = (ImDrawIdx)(draw_list->_VtxCurrentIdx+2); draw_list->_IdxWritePtr[5] = (ImDrawIdx)(draw_list->_VtxCurrentIdx+3);
+            draw_list->_IdxWritePtr += 6;
+            draw_list->_VtxCurrentIdx += 4;
+        }
+    }
+}
+
+static void ReferenceAddConvexPolyFilled(ImDrawList* draw_list, const ImVec2* points, const int points_count, ImU32 col)
+{
+    const ImVec2 uv = draw_list->_Data->TexUvWhitePixel;
+
+    if (draw_list->Flags & ImDrawListFlags_AntiAliasedFill)
+    {
+        // Anti-aliased Fill
+        const float AA_SIZE = 1.0f;
+        const ImU32 col_trans = col & ~IM_COL32_A_MASK;
+        const int idx_count = (points_count-2)*3 + points_count*6;
+        const int vtx_count = (points_count*2);
+        draw_list->PrimReserve(idx_count, vtx_count);
+
+        // Add indexes for fill
+        unsigned int vtx_inner_idx = draw_list->_VtxCurrentIdx;
+        unsigned int vtx_outer_idx = draw_list->_VtxCurrentIdx+1;
+        for (int i = 2; i < points_count; i++)
+        {
+            draw_list->_IdxWritePtr[0] = (ImDrawIdx)(vtx_inner_idx); draw_list->_IdxWritePtr[1] = (ImDrawIdx)(vtx_inner_idx+((i-1)<<1)); draw_list->_IdxWritePtr[2] = (ImDrawIdx)(vtx_inner_idx+(i<<1));
+            draw_list->_IdxWritePtr += 3;
+        }
+
+        // Compute normals
+        ImVec2* temp_normals = (ImVec2*)alloca(points_count * sizeof(ImVec2));
+        for (int i0 = points_count-1, i1 = 0; i1 < points_count; i0 = i1++)
+        {
+            const ImVec2& p0 = points[i0];
+            const ImVec2& p1 = points[i1];
+            ImVec2 diff = p1 - p0;
+            diff *= ImInvLength(diff, 1.0f);
+            temp_normals[i0].x = diff.y;
+            temp_normals[i0].y = -diff.x;
+        }
+
+        for (int i0 = points_count-1, i1 = 0; i1 < points_count; i0 = i1++)
+        {
+            // Average normals
+            const ImVec2& n0 = temp_normals[i0];
+            const ImVec2& n1 = temp_normals[i1];
+            ImVec2 dm = (n0 + n1) * 0.5f;
+            float dmr2 = dm.x*dm.x + dm.y*dm.y;
+            if (dmr2 > 0.000001f)
+            {
+                float scale = 1.0f / dmr2;
+                if (scale > 100.0f) scale = 100.0f;
+                dm *= scale;
+            }
+            dm *= AA_SIZE * 0.5f;
+
+            // Add vertices
+            draw_list->_VtxWritePtr[0].pos = (points[i1] - dm); draw_list->_VtxWritePtr[0].uv = uv; draw_list->_VtxWritePtr[0].col = col;        // Inner
+            draw_list->_VtxWritePtr[1].pos = (points[i1] + dm); draw_list->_VtxWritePtr[1].uv = uv; draw_list->_VtxWritePtr[1].col = col_trans;  // Outer
+            draw_list->_VtxWritePtr += 2;
+
+            // Add indexes for fringes
+            draw_list->_IdxWritePtr[0] = (ImDrawIdx)(vtx_inner_idx+(i1<<1)); draw_list->_IdxWritePtr[1] = (ImDrawIdx)(vtx_inner_idx+(i0<<1)); draw_list->_IdxWritePtr[2] = (ImDrawIdx)(vtx_outer_idx+(i0<<1));
+            draw_list->_IdxWritePtr[3] = (ImDrawIdx)(vtx_outer_idx+(i0<<1)); draw_list->_IdxWritePtr[4] = (ImDrawIdx)(vtx_outer_idx+(i1<<1)); draw_list->_IdxWritePtr[5] = (ImDrawIdx)(vtx_inner_idx+(i1<<1));
+            draw_list->_IdxWritePtr += 6;
+        }
+        draw_list->_VtxCurrentIdx += (ImDrawIdx)vtx_count;
+    }
+    else
+    {
+        // Non Anti-aliased Fill
+        const int idx_count = (points_count-2)*3;
+        const int vtx_count = points_count;
+        draw_list->PrimReserve(idx_count, vtx_count);
+        for (int i = 0; i < vtx_count; i++)
+        {
+            draw_list->_VtxWritePtr[0].pos = points[i]; draw_list->_VtxWritePtr[0].uv = uv; draw_list->_VtxWritePtr[0].col = col;
+            draw_list->_VtxWritePtr++;
+        }
+        for (int i = 2; i < points_count; i++)
+        {
+            draw_list->_IdxWritePtr[0] = (ImDrawIdx)(draw_list->_VtxCurrentIdx); draw_list->_IdxWritePtr[1] = (ImDrawIdx)(draw_list->_VtxCurrentIdx+i-1); draw_list->_IdxWritePtr[2] = (ImDrawIdx)(draw_list->_VtxCurrentIdx+i);
+            draw_list->_IdxWritePtr += 3;
+        }
+        draw_list->_VtxCurrentIdx += (ImDrawIdx)vtx_count;
+    }
+}
+
+namespace SOIS
+{
+  // A draw list ready for primitives, without VtxOffset: the reference
+  // predates it, both then write exactly the same buffers (the indices of
+  // lines past 64K vertices wrap in both).
+  static void ResetDrawList(ImDrawList& aDrawList)
+  {
+    aDrawList.Clear();
+    aDrawList.Flags = ImDrawListFlags_AntiAliasedLines | ImDrawListFlags_AntiAliasedFill;
+    aDrawList.PushClipRectFullScreen();
+    aDrawList.PushTextureID(ImGui::GetIO().Fonts->TexID);
+  }
+
+  static bool SameBuffers(ImDrawList const& aA, ImDrawList const& aB)
+  {
+    return aA.VtxBuffer.Size == aB.VtxBuffer.Size &&
+           aA.IdxBuffer.Size == aB.IdxBuffer.Size &&
+           0 == memcmp(aA.VtxBuffer.Data, aB.VtxBuffer.Data, aA.VtxBuffer.Size * sizeof(ImDrawVert)) &&
+           0 == memcmp(aA.IdxBuffer.Data, aB.IdxBuffer.Data, aA.IdxBuffer.Size * sizeof(ImDrawIdx));
+  }
+
+  enum class Shape
+  {
+    Line,
+    ClosedLine,
+    ConvexFill
+  };
+
+  struct TessellationCase
+  {
+    char const* mName;
+    int mPoints;
+    Shape mShape;
+    float mThickness;
+  };
+
+  bool RunTessellationBenchmarks()
+  {
+    bool passed = true;
+
+    static TessellationCase const cCases[] =
+    {
+      { "10k points, thin closed line", 10000, Shape::ClosedLine, 1.0f },
+      { "10k points, thick closed line", 10000, Shape::ClosedLine, 3.0f },
+      { "10k points, convex fill", 10000, Shape::ConvexFill, 0.0f },
+      { "60k points, thin open line", 60000, Shape::Line, 1.0f },
+      { "60k points, thick open line", 60000, Shape::Line, 3.0f },
+      { "60k points, convex fill", 60000, Shape::ConvexFill, 0.0f },
+    };
+
+    ImDrawList reference(ImGui::GetDrawListSharedData());
+    ImDrawList current(ImGui::GetDrawListSharedData());
+
+    // Every case, and small and degenerate ones, must give the same buffers.
+    for (int points = 2; points <= 64; ++points)
+    {
+      std::vector<ImVec2> shape(points);
+      for (int i = 0; i < points; ++i)
+      {
+        // Repeats some points, so segments of zero length are covered.
+        float a = (float)(i - i % 3) * 6.2831853f / (float)points;
+        shape[i] = ImVec2(100.0f + 80.0f * cosf(a), 100.0f + 80.0f * sinf(a));
+      }
+
+      for (int closed = 0; closed < 2; ++closed)
+      {
+        for (float thickness : { 1.0f, 2.5f })
+        {
+          ResetDrawList(reference);
+          ResetDrawList(current);
+          ReferenceAddPolyline(&reference, shape.data(), points, IM_COL32(255, 255, 0, 255), 0 != closed, thickness);
+          current.AddPolyline(shape.data(), points, IM_COL32(255, 255, 0, 255), 0 != closed, thickness);
+          passed = passed && SameBuffers(reference, current);
+        }
+      }
+
+      if (3 <= points)
+      {
+        ResetDrawList(reference);
+        ResetDrawList(current);
+        ReferenceAddConvexPolyFilled(&reference, shape.data(), points, IM_COL32(255, 255, 0, 255));
+        current.AddConvexPolyFilled(shape.data(), points, IM_COL32(255, 255, 0, 255));
+        passed = passed && SameBuffers(reference, current);
+      }
+    }
+
+    if (false == passed)
+    {
+      printf("AddPolyline or AddConvexPolyFilled differ from the reference on small shapes.\n");
+    }
+
+    PrintHeader("Polyline tessellation, per call", "reference", "current");
+
+    for (TessellationCase const& tessellationCase : cCases)
+    {
+      // A noisy plot for lines, a circle for fills.
+      std::vector<ImVec2> points(tessellationCase.mPoints);
+      for (int i = 0; i < tessellationCase.mPoints; ++i)
+      {
+        float t = (float)i / (float)tessellationCase.mPoints;
+        if (Shape::ConvexFill == tessellationCase.mShape)
+        {
+          points[i] = ImVec2(500.0f + 400.0f * cosf(t * 6.2831853f), 500.0f + 400.0f * sinf(t * 6.2831853f));
+        }
+        else
+        {
+          points[i] = ImVec2(t * 1800.0f, 500.0f + 300.0f * sinf(t * 40.0f) + (float)(Random() % 100));
+        }
+      }
+
+      bool closed = Shape::ClosedLine == tessellationCase.mShape;
+      auto add = [&](ImDrawList& aDrawList, bool aReference)
+      {
+        ResetDrawList(aDrawList);
+        if (Shape::ConvexFill == tessellationCase.mShape)
+        {
+          if (aReference)
+          {
+            ReferenceAddConvexPolyFilled(&aDrawList, points.data(), tessellationCase.mPoints, IM_COL32(255, 255, 0, 255));
+          }
+          else
+          {
+            aDrawList.AddConvexPolyFilled(points.data(), tessellationCase.mPoints, IM_COL32(255, 255, 0, 255));
+          }
+        }
+        else if (aReference)
+        {
+          ReferenceAddPolyline(&aDrawList, points.data(), tessellationCase.mPoints, IM_COL32(255, 255, 0, 255), closed, tessellationCase.mThickness);
+        }
+        else
+        {
+          aDrawList.AddPolyline(points.data(), tessellationCase.mPoints, IM_COL32(255, 255, 0, 255), closed, tessellationCase.mThickness);
+        }
+      };
+
+      // Buffers grown once, so the timings don't include their first allocation.
+      add(reference, true);
+      add(current, false);
+
+      if (false == SameBuffers(reference, current))
+      {
+        printf("%s: the buffers differ from the reference.\n", tessellationCase.mName);
+        passed = false;
+      }
+
+      double referenceNs = MeasureNs(1, [&]() { add(reference, true); });
+      double currentNs = MeasureNs(1, [&]() { add(current, false); });
+      PrintRow(tessellationCase.mName, referenceNs / 1000.0, currentNs / 1000.0, "us");
+    }
+
+    return passed;
+  }
+}
@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "imgui.h"
+#include "imgui_impl_trace.h"
+
+#include "Benchmarks.hpp"
+
+#if defined(_MSC_VER)
+  #define BENCHMARK_NOINLINE __declspec(noinline)
+#else
+  #define BENCHMARK_NOINLINE __attribute__((noinline))
+#endif
+
+namespace SOIS
+{
+  constexpr int cZones = 1000000;
+
+  // Out of line, so the zones can't be merged or hoisted out of the loops.
+  static BENCHMARK_NOINLINE void LeafZone(unsigned aValue)
+  {
+    IMGUI_TRACE_ZONE("LeafZone");
+    Consume(aValue);
+  }
+
+  static BENCHMARK_NOINLINE void NestedZones(unsigned aValue)
+  {
+    IMGUI_TRACE_ZONE("NestedZones 1");
+    {
+      IMGUI_TRACE_ZONE("NestedZones 2");
+      {
+        IMGUI_TRACE_ZONE("NestedZones 3");
+        LeafZone(aValue);
+      }
+    }
+  }
+
+  static void Leaves()
+  {
+    for (int i = 0; i < cZones; ++i)
+    {
+      LeafZone(static_cast<unsigned>(i));
+    }
+  }
+
+  static void Nested()
+  {
+    for (int i = 0; i < cZones / 4; ++i)
+    {
+      NestedZones(static_cast<unsigned>(i));
+    }
+  }
+
+  // Counts the zones named aName in the trace file.
+  static int CountZones(char const* aFile, char const* aName)
+  {
+    FILE* file = fopen(aFile, "rb");
+    if (nullptr == file)
+    {
+      return -1;
+    }
+
+    std::vector<char> text;
+    char chunk[4096];
+    size_t read;
+    while (0 < (read = fread(chunk, 1, sizeof(chunk), file)))
+    {
+      text.insert(text.end(), chunk, chunk + read);
+    }
+    text.push_back('\0');
+    fclose(file);
+
+    char pattern[128];
+    snprintf(pattern, sizeof(pattern), "{\"name\":\"%s\",\"ph\":\"X\"", aName);
+
+    int count = 0;
+    for (char const* found = strstr(text.data(), pattern); nullptr != found; found = strstr(found + 1, pattern))
+    {
+      ++count;
+    }
+    return count;
+  }
+
+  bool RunTraceBenchmarks()
+  {
+    bool passed = true;
+    bool wasEnabled = ImGui_ImplTrace_IsEnabled();
+
+    PrintHeader("Trace zones, per zone", "disabled", "enabled");
+
+    ImGui_ImplTrace_SetEnabled(false);
+    double leafDisabled = MeasureNs(cZones, Leaves);
+    double nestedDisabled = MeasureNs(cZones, Nested);
+
+    ImGui_ImplTrace_SetEnabled(true);
+    double leafEnabled = MeasureNs(cZones, Leaves);
+    double nestedEnabled = MeasureNs(cZones, Nested);
+
+    PrintRow("single zone", leafDisabled, leafEnabled, "ns");
+    PrintRow("nested zones, depth 4", nestedDisabled, nestedEnabled, "ns");
+
+    // The last zones recorded must be in the trace (with those of the
+    // timed runs that are still in the ring).
+    constexpr int cCheckedZones = 1000;
+    for (int i = 0; i < cCheckedZones; ++i)
+    {
+      NestedZones(static_cast<unsigned>(i));
+    }
+    ImGui_ImplTrace_SetEnabled(wasEnabled);
+
+    char const* file = "TraceBenchmarks.json";
+    ImGui_ImplTrace_WriteFile(file);
+    ImGui_ImplTrace_Shutdown();
+
+    int leaves = CountZones(file, "LeafZone");
+    int outer = CountZones(file, "NestedZones 1");
+    remove(file);
+
+    if (leaves < cCheckedZones || outer < cCheckedZones)
+    {
+      printf("The trace has %d LeafZone and %d NestedZones 1 zones, expected at least %d of each.\n", leaves, outer, cCheckedZones);
+      passed = false;
+    }
+
+    return passed;
+  }
+}
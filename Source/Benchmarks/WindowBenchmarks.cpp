@@ -0,0 +1,197 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
+
+#include "imgui.h"
+#include "imgui_internal.h"
+
+#include "Benchmarks.hpp"
+
+namespace SOIS
+{
+  constexpr int cWindowCount = 5000;
+
+  // A frame with every window, laid out like the sample's "Many windows".
+  static void RunFrame()
+  {
+    ImGui::NewFrame();
+
+    char name[32];
+    for (int i = 0; i < cWindowCount; ++i)
+    {
+      snprintf(name, sizeof(name), "Window %d", i);
+      ImGui::SetNextWindowPos(ImVec2((float)(i % 12) * 160.0f, (float)((i / 12) % 20) * 40.0f + (float)(i / 240) * 4.0f), ImGuiCond_FirstUseEver);
+      ImGui::SetNextWindowSize(ImVec2(150.0f, 36.0f), ImGuiCond_FirstUseEver);
+      ImGui::Begin(name, nullptr, ImGuiWindowFlags_NoSavedSettings);
+      ImGui::Text("%d", i);
+      ImGui::End();
+    }
+
+    ImGui::EndFrame();
+  }
+
+  // FocusWindow() as it was before windows kept their index: a scan from
+  // the front, then erase and push_back. Run on a copy of the window list,
+  // it reads the same window fields FocusWindow() reads.
+  static void ReferenceFocusWindow(ImVector<ImGuiWindow*>& aWindows, ImGuiWindow* aWindow)
+  {
+    Consume(aWindow->NavLastIds[0]);
+    if (aWindow->RootWindow)
+    {
+      aWindow = aWindow->RootWindow;
+    }
+
+    if (aWindow->Flags & ImGuiWindowFlags_NoBringToFrontOnFocus)
+    {
+      return;
+    }
+
+    ImGuiWindow* currentFrontWindow = aWindows.back();
+    if (currentFrontWindow == aWindow || currentFrontWindow->RootWindow == aWindow)
+    {
+      return;
+    }
+
+    for (int i = aWindows.Size - 2; i >= 0; --i)
+    {
+      if (aWindows[i] == aWindow)
+      {
+        aWindows.erase(aWindows.Data + i);
+        aWindows.push_back(aWindow);
+        break;
+      }
+    }
+  }
+
+  // BringWindowToBack() as it was: a scan from the back of the display.
+  static void ReferenceBringWindowToBack(ImVector<ImGuiWindow*>& aWindows, ImGuiWindow* aWindow)
+  {
+    if (aWindows[0] == aWindow)
+    {
+      return;
+    }
+
+    for (int i = 0; i < aWindows.Size; ++i)
+    {
+      if (aWindows[i] == aWindow)
+      {
+        memmove(&aWindows[1], &aWindows[0], (size_t)i * sizeof(ImGuiWindow*));
+        aWindows[0] = aWindow;
+        break;
+      }
+    }
+  }
+
+  static ImGuiWindow* RandomWindow()
+  {
+    char name[32];
+    snprintf(name, sizeof(name), "Window %d", static_cast<int>(Random() % cWindowCount));
+    return ImGui::FindWindowByName(name);
+  }
+
+  bool RunWindowBenchmarks()
+  {
+    bool passed = true;
+    ImGuiContext& g = *ImGui::GetCurrentContext();
+
+    // Creates the windows, then lets them settle.
+    for (int frame = 0; frame < 3; ++frame)
+    {
+      RunFrame();
+    }
+
+    constexpr int cFrames = 200;
+    constexpr int cBackToBack = 2000;
+
+    PrintHeader("5000 windows", "reference", "current");
+
+    // Whole frames, for scale.
+    double frameNs = MeasureNs(20, []()
+    {
+      for (int frame = 0; frame < 20; ++frame)
+      {
+        RunFrame();
+      }
+    }, 1);
+    PrintRow("frame (Begin/End of every window)", -1.0, frameNs / 1000.0, "us");
+
+    // One focus change per frame, the window indices are fresh every time.
+    std::vector<ImGuiWindow*> targets(cBackToBack);
+    double referenceNs = 0.0;
+    double currentNs = 0.0;
+
+    for (int frame = 0; frame < cFrames; ++frame)
+    {
+      ImGuiWindow* window = RandomWindow();
+      ImVector<ImGuiWindow*> windows = g.Windows;
+
+      auto start = std::chrono::steady_clock::now();
+      ReferenceFocusWindow(windows, window);
+      auto middle = std::chrono::steady_clock::now();
+      ImGui::FocusWindow(window);
+      auto end = std::chrono::steady_clock::now();
+
+      referenceNs += std::chrono::duration<double, std::nano>(middle - start).count();
+      currentNs += std::chrono::duration<double, std::nano>(end - middle).count();
+      passed = passed && 0 == memcmp(windows.Data, g.Windows.Data, g.Windows.Size * sizeof(ImGuiWindow*));
+      RunFrame();
+    }
+
+    PrintRow("focus, once per frame", referenceNs / cFrames / 1000.0, currentNs / cFrames / 1000.0, "us");
+
+    // Many focus changes within a frame, the indices go stale.
+    for (ImGuiWindow*& target : targets)
+    {
+      target = RandomWindow();
+    }
+
+    ImVector<ImGuiWindow*> windows = g.Windows;
+    referenceNs = MeasureNs(cBackToBack, [&]()
+    {
+      for (ImGuiWindow* target : targets)
+      {
+        ReferenceFocusWindow(windows, target);
+      }
+    }, 1);
+    currentNs = MeasureNs(cBackToBack, [&]()
+    {
+      for (ImGuiWindow* target : targets)
+      {
+        ImGui::FocusWindow(target);
+      }
+    }, 1);
+    passed = passed && 0 == memcmp(windows.Data, g.Windows.Data, g.Windows.Size * sizeof(ImGuiWindow*));
+
+    PrintRow("focus, back-to-back random", referenceNs / 1000.0, currentNs / 1000.0, "us");
+
+    windows = g.Windows;
+    referenceNs = MeasureNs(cBackToBack, [&]()
+    {
+      for (ImGuiWindow* target : targets)
+      {
+        ReferenceBringWindowToBack(windows, target);
+      }
+    }, 1);
+    currentNs = MeasureNs(cBackToBack, [&]()
+    {
+      for (ImGuiWindow* target : targets)
+      {
+        ImGui::BringWindowToBack(target);
+      }
+    }, 1);
+    passed = passed && 0 == memcmp(windows.Data, g.Windows.Data, g.Windows.Size * sizeof(ImGuiWindow*));
+
+    PrintRow("to back, back-to-back random", referenceNs / 1000.0, currentNs / 1000.0, "us");
+    RunFrame();
+
+    if (false == passed)
+    {
+      printf("FocusWindow() left the windows in a different order than the reference.\n");
+    }
+
+    ImGui::FocusWindow(nullptr);
+    return passed;
+  }
+}
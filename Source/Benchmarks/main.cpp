@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////////
+// Micro benchmarks of the ImGui internals this sample tunes, each against
+// the code it replaced (or the other mode of the same code). They run on
+// the CPU only, without a window or GL context.
+//
+// Pass the names of the benchmarks to run, or nothing to run all of them:
+//   hash      ImHash on short labels and long buffers
+//   storage   ImGuiStorage inserts and lookups, sorted and hash indexed
+//   polyline  Anti-aliased polyline and convex fill tessellation
+//   bezier    Bezier curve flattening, auto tessellated and fixed segments
+//   windows   Focus changes among 5000 windows
+//   trace     Cost of a trace zone, tracing disabled and enabled
+//
+// Exits with 1 if any of them computed a wrong result.
+///////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+
+#include <initializer_list>
+
+#include "imgui.h"
+
+#include "Benchmarks.hpp"
+
+namespace SOIS
+{
+  static volatile unsigned sConsumed = 0;
+  static unsigned sRandomState = 0x12345678;
+
+  unsigned Random()
+  {
+    sRandomState ^= sRandomState << 13;
+    sRandomState ^= sRandomState >> 17;
+    sRandomState ^= sRandomState << 5;
+    return sRandomState;
+  }
+
+  void Consume(unsigned aValue)
+  {
+    sConsumed = sConsumed + aValue;
+  }
+
+  void PrintHeader(char const* aTitle, char const* aBefore, char const* aAfter)
+  {
+    printf("\n%-36s %15s %15s\n", aTitle, aBefore, aAfter);
+  }
+
+  void PrintRow(char const* aName, double aBefore, double aAfter, char const* aUnit)
+  {
+    printf("  %-34s", aName);
+
+    for (double value : { aBefore, aAfter })
+    {
+      if (value < 0.0)
+      {
+        printf(" %10s %-4s", "-", "");
+      }
+      else
+      {
+        printf(" %10.2f %-4s", value, aUnit);
+      }
+    }
+
+    printf("\n");
+  }
+}
+
+struct Benchmark
+{
+  char const* mName;
+  bool (*mRun)();
+};
+
+int main(int argc, char** argv)
+{
+  static Benchmark const cBenchmarks[] =
+  {
+    { "hash", SOIS::RunHashBenchmarks },
+    { "storage", SOIS::RunStorageBenchmarks },
+    { "polyline", SOIS::RunTessellationBenchmarks },
+    { "bezier", SOIS::RunBezierBenchmarks },
+    { "windows", SOIS::RunWindowBenchmarks },
+    { "trace", SOIS::RunTraceBenchmarks },
+  };
+
+  // Some benchmarks need a context (windows, fonts), they all share this one.
+  ImGui::CreateContext();
+  ImGuiIO& io = ImGui::GetIO();
+  io.IniFilename = nullptr;
+  io.DisplaySize = ImVec2(1920.0f, 1080.0f);
+  io.DeltaTime = 1.0f / 60.0f;
+  unsigned char* pixels;
+  int width, height;
+  io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+  bool passed = true;
+
+  for (Benchmark const& benchmark : cBenchmarks)
+  {
+    bool selected = (1 == argc);
+
+    for (int i = 1; i < argc; ++i)
+    {
+      selected = selected || 0 == strcmp(argv[i], benchmark.mName);
+    }
+
+    if (selected && false == benchmark.mRun())
+    {
+      printf("%s: FAILED\n", benchmark.mName);
+      passed = false;
+    }
+  }
+
+  ImGui::DestroyContext();
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,399 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "imgui.h"
+
+#include "FrameAllocator.hpp"
+
+namespace SOIS
+{
+  static size_t const cSizeClasses[] =
+  {
+    16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048,
+    3072, 4096, 6144, 8192, 12288, 16384, 24576, 32768
+  };
+
+  constexpr int cSizeClassCount = static_cast<int>(sizeof(cSizeClasses) / sizeof(cSizeClasses[0]));
+  static_assert(FrameAllocator::cMaxPooledSize == 32768, "The last size class must be cMaxPooledSize.");
+
+  constexpr uint32_t cBlockMagic = 0x534F4953;
+
+  enum class BlockKind : uint16_t
+  {
+    Pool,
+    Large,
+    Arena
+  };
+
+  // In front of every block we hand out, keeps the blocks 16 byte aligned.
+  struct alignas(16) BlockHeader
+  {
+    uint32_t mMagic;
+    BlockKind mKind;
+    uint16_t mSizeClass;
+    size_t mSize;
+  };
+
+  // A pooled block while it's free, overwrites the header.
+  struct FreeBlock
+  {
+    FreeBlock* mNext;
+  };
+
+  // In front of the header of a transient block that didn't fit in the
+  // arena, links the overflow blocks of the frame.
+  struct alignas(16) FrameAllocatorOverflowBlock
+  {
+    FrameAllocatorOverflowBlock* mNext;
+    size_t mSize;
+  };
+
+  struct FrameAllocatorPools
+  {
+    struct Pool
+    {
+      FreeBlock* mFree = nullptr;
+      // Unused end of the last page, blocks are carved from it as needed.
+      char* mCursor = nullptr;
+      size_t mRemaining = 0;
+    };
+
+    Pool mPools[cSizeClassCount];
+  };
+
+  // Hands the pools of a thread back to the allocator when the thread exits.
+  struct FrameAllocatorPoolsHandle
+  {
+    FrameAllocatorPools* mPools = nullptr;
+    ~FrameAllocatorPoolsHandle();
+  };
+
+  static thread_local FrameAllocatorPoolsHandle tPoolsHandle;
+  // Trivially destructible, so still readable while the thread exits.
+  static thread_local FrameAllocatorPools* tPools = nullptr;
+  static thread_local bool tPoolsRetired = false;
+
+  FrameAllocatorPoolsHandle::~FrameAllocatorPoolsHandle()
+  {
+    if (nullptr != mPools)
+    {
+      FrameAllocator::Get().RetireThreadPools(mPools);
+    }
+
+    tPools = nullptr;
+    tPoolsRetired = true;
+  }
+
+  // Size class of every size up to cMaxPooledSize, in steps of 16 bytes.
+  static uint8_t sSizeClassOfSize[FrameAllocator::cMaxPooledSize / 16 + 1];
+
+  static size_t RoundUp16(size_t aSize)
+  {
+    return (aSize + 15) & ~static_cast<size_t>(15);
+  }
+
+  FrameAllocator& FrameAllocator::Get()
+  {
+    // Leaked on purpose, see the comment on FrameAllocator.
+    static FrameAllocator* allocator = new FrameAllocator();
+    return *allocator;
+  }
+
+  FrameAllocator::FrameAllocator()
+  {
+    int sizeClass = 0;
+    for (size_t i = 0; i < sizeof(sSizeClassOfSize); ++i)
+    {
+      while (cSizeClasses[sizeClass] < i * 16)
+      {
+        ++sizeClass;
+      }
+
+      sSizeClassOfSize[i] = static_cast<uint8_t>(sizeClass);
+    }
+  }
+
+  void FrameAllocator::Install()
+  {
+    ImGui::SetAllocatorFunctions(ImGuiAlloc, ImGuiFree, this);
+  }
+
+  void* FrameAllocator::ImGuiAlloc(size_t aSize, void* aUserData)
+  {
+    return static_cast<FrameAllocator*>(aUserData)->Allocate(aSize);
+  }
+
+  void FrameAllocator::ImGuiFree(void* aPointer, void* aUserData)
+  {
+    static_cast<FrameAllocator*>(aUserData)->Free(aPointer);
+  }
+
+  FrameAllocatorPools* FrameAllocator::GetThreadPools()
+  {
+    if (nullptr != tPools || tPoolsRetired)
+    {
+      return tPools;
+    }
+
+    tPools = AcquireThreadPools();
+    tPoolsHandle.mPools = tPools;
+    return tPools;
+  }
+
+  FrameAllocatorPools* FrameAllocator::AcquireThreadPools()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mPoolsLock);
+      if (false == mSparePools.empty())
+      {
+        FrameAllocatorPools* pools = mSparePools.back();
+        mSparePools.pop_back();
+        return pools;
+      }
+    }
+
+    return new FrameAllocatorPools();
+  }
+
+  void FrameAllocator::RetireThreadPools(FrameAllocatorPools* aPools)
+  {
+    std::lock_guard<std::mutex> lock(mPoolsLock);
+    mSparePools.push_back(aPools);
+  }
+
+  void* FrameAllocator::HeapAllocate(size_t aSize)
+  {
+    mHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    mHeapBytes.fetch_add(aSize, std::memory_order_relaxed);
+    mReservedBytes.fetch_add(aSize, std::memory_order_relaxed);
+    return malloc(aSize);
+  }
+
+  void FrameAllocator::HeapFree(void* aPointer, size_t aSize)
+  {
+    mReservedBytes.fetch_sub(aSize, std::memory_order_relaxed);
+    free(aPointer);
+  }
+
+  void* FrameAllocator::Allocate(size_t aSize)
+  {
+    mAllocations.fetch_add(1, std::memory_order_relaxed);
+    mAllocatedBytes.fetch_add(aSize, std::memory_order_relaxed);
+    mLiveBytes.fetch_add(aSize, std::memory_order_relaxed);
+
+    if (aSize <= cMaxPooledSize)
+    {
+      if (void* block = AllocateFromPool(aSize))
+      {
+        return block;
+      }
+    }
+
+    return AllocateLarge(aSize);
+  }
+
+  void* FrameAllocator::AllocateFromPool(size_t aSize)
+  {
+    // Threads that are exiting don't have pools anymore.
+    FrameAllocatorPools* pools = GetThreadPools();
+    if (nullptr == pools)
+    {
+      return nullptr;
+    }
+
+    int sizeClass = sSizeClassOfSize[(aSize + 15) / 16];
+    FrameAllocatorPools::Pool& pool = pools->mPools[sizeClass];
+    BlockHeader* header;
+
+    if (nullptr != pool.mFree)
+    {
+      header = reinterpret_cast<BlockHeader*>(pool.mFree);
+      pool.mFree = pool.mFree->mNext;
+    }
+    else
+    {
+      size_t blockSize = sizeof(BlockHeader) + cSizeClasses[sizeClass];
+      if (pool.mRemaining < blockSize)
+      {
+        // Whatever is left of the last page is too small, it's lost.
+        size_t pageSize = std::max(cPageSize, blockSize * 8);
+        pool.mCursor = static_cast<char*>(HeapAllocate(pageSize));
+        pool.mRemaining = nullptr != pool.mCursor ? pageSize : 0;
+
+        if (nullptr == pool.mCursor)
+        {
+          return nullptr;
+        }
+      }
+
+      header = reinterpret_cast<BlockHeader*>(pool.mCursor);
+      pool.mCursor += blockSize;
+      pool.mRemaining -= blockSize;
+    }
+
+    header->mMagic = cBlockMagic;
+    header->mKind = BlockKind::Pool;
+    header->mSizeClass = static_cast<uint16_t>(sizeClass);
+    header->mSize = aSize;
+    return header + 1;
+  }
+
+  void* FrameAllocator::AllocateLarge(size_t aSize)
+  {
+    auto header = static_cast<BlockHeader*>(HeapAllocate(sizeof(BlockHeader) + aSize));
+    if (nullptr == header)
+    {
+      return nullptr;
+    }
+
+    header->mMagic = cBlockMagic;
+    header->mKind = BlockKind::Large;
+    header->mSizeClass = 0;
+    header->mSize = aSize;
+    return header + 1;
+  }
+
+  void* FrameAllocator::AllocateTransient(size_t aSize)
+  {
+    IM_ASSERT(std::thread::id() == mArenaThread || std::this_thread::get_id() == mArenaThread);
+
+    mAllocations.fetch_add(1, std::memory_order_relaxed);
+    mAllocatedBytes.fetch_add(aSize, std::memory_order_relaxed);
+    mArenaAllocations.fetch_add(1, std::memory_order_relaxed);
+    mArenaBytes.fetch_add(aSize, std::memory_order_relaxed);
+
+    size_t blockSize = sizeof(BlockHeader) + RoundUp16(aSize);
+    BlockHeader* header;
+
+    if (mArenaUsed + blockSize <= mArenaCapacity)
+    {
+      header = reinterpret_cast<BlockHeader*>(mArena + mArenaUsed);
+      mArenaUsed += blockSize;
+    }
+    else
+    {
+      size_t overflowSize = sizeof(FrameAllocatorOverflowBlock) + blockSize;
+      auto overflow = static_cast<FrameAllocatorOverflowBlock*>(HeapAllocate(overflowSize));
+      if (nullptr == overflow)
+      {
+        return nullptr;
+      }
+
+      overflow->mNext = mOverflow;
+      overflow->mSize = overflowSize;
+      mOverflow = overflow;
+      mOverflowBytes += blockSize;
+      header = reinterpret_cast<BlockHeader*>(overflow + 1);
+    }
+
+    header->mMagic = cBlockMagic;
+    header->mKind = BlockKind::Arena;
+    header->mSizeClass = 0;
+    header->mSize = aSize;
+    return header + 1;
+  }
+
+  void FrameAllocator::Free(void* aPointer)
+  {
+    if (nullptr == aPointer)
+    {
+      return;
+    }
+
+    BlockHeader* header = static_cast<BlockHeader*>(aPointer) - 1;
+
+    // Either not ours (allocated before Install()), or freed twice.
+    IM_ASSERT(cBlockMagic == header->mMagic);
+
+    mFrees.fetch_add(1, std::memory_order_relaxed);
+
+    switch (header->mKind)
+    {
+      case BlockKind::Pool:
+      {
+        mLiveBytes.fetch_sub(header->mSize, std::memory_order_relaxed);
+
+        // Blocks freed while the thread exits are lost, there's nowhere
+        // to put them.
+        FrameAllocatorPools* pools = GetThreadPools();
+        if (nullptr != pools)
+        {
+          FrameAllocatorPools::Pool& pool = pools->mPools[header->mSizeClass];
+          auto block = reinterpret_cast<FreeBlock*>(header);
+          block->mNext = pool.mFree;
+          pool.mFree = block;
+        }
+        break;
+      }
+      case BlockKind::Large:
+      {
+        mLiveBytes.fetch_sub(header->mSize, std::memory_order_relaxed);
+        header->mMagic = 0;
+        HeapFree(header, sizeof(BlockHeader) + header->mSize);
+        break;
+      }
+      case BlockKind::Arena:
+      {
+        // Reclaimed by BeginFrame().
+        header->mMagic = 0;
+        break;
+      }
+    }
+  }
+
+  void FrameAllocator::BeginFrame()
+  {
+    mArenaThread = std::this_thread::get_id();
+
+    // Make room for everything this frame needed, so the next one doesn't
+    // overflow again.
+    if (0 != mOverflowBytes)
+    {
+      while (nullptr != mOverflow)
+      {
+        FrameAllocatorOverflowBlock* next = mOverflow->mNext;
+        HeapFree(mOverflow, mOverflow->mSize);
+        mOverflow = next;
+      }
+
+      size_t needed = mArenaUsed + mOverflowBytes;
+      size_t capacity = std::max(cArenaSize, mArenaCapacity);
+      while (capacity < needed)
+      {
+        capacity *= 2;
+      }
+
+      if (nullptr != mArena)
+      {
+        HeapFree(mArena, mArenaCapacity);
+      }
+
+      mArena = static_cast<char*>(HeapAllocate(capacity));
+      mArenaCapacity = nullptr != mArena ? capacity : 0;
+      mOverflowBytes = 0;
+    }
+
+    mArenaUsed = 0;
+
+    mLastFrame.mAllocations = mAllocations.exchange(0, std::memory_order_relaxed);
+    mLastFrame.mFrees = mFrees.exchange(0, std::memory_order_relaxed);
+    mLastFrame.mAllocatedBytes = mAllocatedBytes.exchange(0, std::memory_order_relaxed);
+    mLastFrame.mHeapAllocations = mHeapAllocations.exchange(0, std::memory_order_relaxed);
+    mLastFrame.mHeapBytes = mHeapBytes.exchange(0, std::memory_order_relaxed);
+    mLastFrame.mArenaAllocations = mArenaAllocations.exchange(0, std::memory_order_relaxed);
+    mLastFrame.mArenaBytes = mArenaBytes.exchange(0, std::memory_order_relaxed);
+  }
+
+  AllocatorStats FrameAllocator::GetCurrentFrameStats() const
+  {
+    AllocatorStats stats;
+    stats.mAllocations = mAllocations.load(std::memory_order_relaxed);
+    stats.mFrees = mFrees.load(std::memory_order_relaxed);
+    stats.mAllocatedBytes = mAllocatedBytes.load(std::memory_order_relaxed);
+    stats.mHeapAllocations = mHeapAllocations.load(std::memory_order_relaxed);
+    stats.mHeapBytes = mHeapBytes.load(std::memory_order_relaxed);
+    stats.mArenaAllocations = mArenaAllocations.load(std::memory_order_relaxed);
+    stats.mArenaBytes = mArenaBytes.load(std::memory_order_relaxed);
+    return stats;
+  }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SOIS
+{
+  struct FrameAllocatorPools;
+  struct FrameAllocatorPoolsHandle;
+  struct FrameAllocatorOverflowBlock;
+
+  // Allocation counts of a single frame, from every thread.
+  struct AllocatorStats
+  {
+    // Calls to Allocate() and Free(), whichever way they were served.
+    int mAllocations = 0;
+    int mFrees = 0;
+    size_t mAllocatedBytes = 0;
+    // Allocations that went to the system heap: new pool pages, blocks too
+    // big to pool and arena growth. Steady state frames should have none.
+    int mHeapAllocations = 0;
+    size_t mHeapBytes = 0;
+    // Allocations served by the frame arena.
+    int mArenaAllocations = 0;
+    size_t mArenaBytes = 0;
+  };
+
+  // The allocator ImGui allocates through (see ImGui::SetAllocatorFunctions).
+  //
+  // Long lived allocations come from size class pools, one set per thread so
+  // the common path takes no lock. A freed block goes back to the pools of
+  // the thread freeing it. Pool pages are never handed back to the system,
+  // a UI reaches its high water mark quickly and then only recycles blocks.
+  //
+  // AllocateTransient() hands out scratch memory from a linear arena that is
+  // reset every BeginFrame(), for per frame buffers such as the points of a
+  // plot. Only the thread calling BeginFrame() may use it, and nothing in it
+  // may live past the end of the frame.
+  //
+  // There is one allocator for the process and it's never destroyed, ImGui
+  // objects with static storage may free their memory after main returns.
+  struct FrameAllocator
+  {
+  public:
+    static constexpr size_t cMaxPooledSize = 32768;
+    static constexpr size_t cPageSize = 64 * 1024;
+    static constexpr size_t cArenaSize = 1024 * 1024;
+
+    static FrameAllocator& Get();
+
+    FrameAllocator(FrameAllocator const&) = delete;
+    FrameAllocator& operator=(FrameAllocator const&) = delete;
+
+    // Installs the allocator with ImGui::SetAllocatorFunctions, do it before
+    // anything is allocated through ImGui (before ImGui::CreateContext).
+    void Install();
+
+    void* Allocate(size_t aSize);
+    void Free(void* aPointer);
+
+    // Memory valid until the next BeginFrame(), freeing it is optional.
+    void* AllocateTransient(size_t aSize);
+
+    // Resets the arena and starts counting the next frame.
+    void BeginFrame();
+
+    // Counts of the last complete frame, and of the one in progress.
+    AllocatorStats const& GetLastFrameStats() const { return mLastFrame; }
+    AllocatorStats GetCurrentFrameStats() const;
+
+    size_t GetLiveBytes() const { return mLiveBytes.load(std::memory_order_relaxed); }
+    size_t GetReservedBytes() const { return mReservedBytes.load(std::memory_order_relaxed); }
+
+    static void* ImGuiAlloc(size_t aSize, void* aUserData);
+    static void ImGuiFree(void* aPointer, void* aUserData);
+
+  private:
+    friend struct FrameAllocatorPoolsHandle;
+
+    FrameAllocator();
+
+    FrameAllocatorPools* GetThreadPools();
+    FrameAllocatorPools* AcquireThreadPools();
+    void RetireThreadPools(FrameAllocatorPools* aPools);
+    void* AllocateFromPool(size_t aSize);
+    void* AllocateLarge(size_t aSize);
+    void* HeapAllocate(size_t aSize);
+    void HeapFree(void* aPointer, size_t aSize);
+
+    // Pool sets of threads that exited, handed to the next new thread.
+    std::mutex mPoolsLock;
+    std::vector<FrameAllocatorPools*> mSparePools;
+
+    // The arena, mOverflow lists what didn't fit in mArena this frame (linked
+    // through the blocks themselves, so keeping them never allocates). The
+    // next frame gets an arena big enough for all of it.
+    char* mArena = nullptr;
+    size_t mArenaCapacity = 0;
+    size_t mArenaUsed = 0;
+    FrameAllocatorOverflowBlock* mOverflow = nullptr;
+    size_t mOverflowBytes = 0;
+    std::thread::id mArenaThread;
+
+    std::atomic<int> mAllocations{ 0 };
+    std::atomic<int> mFrees{ 0 };
+    std::atomic<size_t> mAllocatedBytes{ 0 };
+    std::atomic<int> mHeapAllocations{ 0 };
+    std::atomic<size_t> mHeapBytes{ 0 };
+    std::atomic<int> mArenaAllocations{ 0 };
+    std::atomic<size_t> mArenaBytes{ 0 };
+    std::atomic<size_t> mLiveBytes{ 0 };
+    std::atomic<size_t> mReservedBytes{ 0 };
+    AllocatorStats mLastFrame;
+  };
+}
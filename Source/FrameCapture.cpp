@@ -0,0 +1,291 @@
+#include <cstdio>
+#include <cstring>
+
+#include "imgui_impl_trace.h"
+#include "stb_image_write.h"
+
+#include "FrameCapture.hpp"
+
+namespace SOIS
+{
+  FrameCapture::~FrameCapture()
+  {
+    // The GL objects are released by Stop, by now the context may be gone.
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStopWorkers = true;
+    }
+    mJobReady.notify_all();
+
+    for (auto& worker : mWorkers)
+    {
+      worker.join();
+    }
+  }
+
+  void FrameCapture::Start(std::string const& aPathPrefix, CaptureFormat aFormat, int aQuality, int aWorkerCount)
+  {
+    if (mCapturing)
+    {
+      Stop();
+    }
+
+    mPathPrefix = aPathPrefix;
+    mFormat = aFormat;
+    mQuality = aQuality;
+    mCaptured = 0;
+    mDropped = 0;
+    mWritten = 0;
+    mFrame = 0;
+    mNextReadback = 0;
+
+    if (aWorkerCount < 1)
+    {
+      aWorkerCount = 1;
+    }
+
+    // Allow a little slack per worker before we start dropping frames.
+    mStopWorkers = false;
+    mMaxQueuedJobs = static_cast<size_t>(aWorkerCount) * 2;
+    for (int i = 0; i < aWorkerCount; ++i)
+    {
+      mWorkers.emplace_back(&FrameCapture::WorkerLoop, this);
+    }
+
+    for (auto& readback : mReadbacks)
+    {
+      gl::glGenBuffers(1, &readback.mBuffer);
+    }
+
+    mCapturing = true;
+  }
+
+  void FrameCapture::Stop()
+  {
+    if (false == mCapturing)
+    {
+      return;
+    }
+
+    // Oldest first, so the files are queued in frame order.
+    for (int i = 0; i < cReadbackBuffers; ++i)
+    {
+      Readback& readback = mReadbacks[(mNextReadback + i) % cReadbackBuffers];
+
+      if (nullptr != readback.mFence)
+      {
+        Collect(readback, true);
+      }
+
+      gl::glDeleteBuffers(1, &readback.mBuffer);
+      readback = Readback{};
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStopWorkers = true;
+    }
+    mJobReady.notify_all();
+
+    for (auto& worker : mWorkers)
+    {
+      worker.join();
+    }
+
+    mWorkers.clear();
+    mFreePixels.clear();
+    mCapturing = false;
+  }
+
+  void FrameCapture::Capture(int aWidth, int aHeight)
+  {
+    if (false == mCapturing || aWidth <= 0 || aHeight <= 0)
+    {
+      return;
+    }
+
+    IMGUI_TRACE_ZONE("FrameCapture::Capture");
+
+    // Hand off whatever the GPU finished since last frame.
+    for (int i = 0; i < cReadbackBuffers; ++i)
+    {
+      Readback& readback = mReadbacks[(mNextReadback + i) % cReadbackBuffers];
+
+      if (nullptr != readback.mFence && false == Collect(readback, false))
+      {
+        // Later readbacks can't have finished before this one.
+        break;
+      }
+    }
+
+    ++mFrame;
+
+    // Every buffer still being copied into, drop this frame rather than stall.
+    Readback& readback = mReadbacks[mNextReadback];
+    if (nullptr != readback.mFence)
+    {
+      ++mDropped;
+      return;
+    }
+
+    mNextReadback = (mNextReadback + 1) % cReadbackBuffers;
+
+    size_t size = static_cast<size_t>(aWidth) * aHeight * 4;
+    gl::glBindBuffer(gl::GL_PIXEL_PACK_BUFFER, readback.mBuffer);
+
+    if (readback.mSize != size)
+    {
+      gl::glBufferData(gl::GL_PIXEL_PACK_BUFFER, size, nullptr, gl::GL_STREAM_READ);
+      readback.mSize = size;
+    }
+
+    // With a pack buffer bound glReadPixels only queues the copy.
+    gl::glPixelStorei(gl::GL_PACK_ALIGNMENT, 1);
+    gl::glReadPixels(0, 0, aWidth, aHeight, gl::GL_RGBA, gl::GL_UNSIGNED_BYTE, nullptr);
+    gl::glBindBuffer(gl::GL_PIXEL_PACK_BUFFER, 0);
+
+    readback.mFence = gl::glFenceSync(gl::GL_SYNC_GPU_COMMANDS_COMPLETE, gl::UnusedMask::GL_NONE_BIT);
+    readback.mWidth = aWidth;
+    readback.mHeight = aHeight;
+    readback.mFrame = mFrame;
+    ++mCaptured;
+  }
+
+  bool FrameCapture::Collect(Readback& aReadback, bool aWait)
+  {
+    gl::GLuint64 timeout = aWait ? ~gl::GLuint64{ 0 } : 0;
+    gl::GLenum status = gl::glClientWaitSync(aReadback.mFence, aWait ? gl::SyncObjectMask::GL_SYNC_FLUSH_COMMANDS_BIT : gl::SyncObjectMask::GL_NONE_BIT, timeout);
+
+    if (gl::GL_TIMEOUT_EXPIRED == status)
+    {
+      return false;
+    }
+
+    gl::glDeleteSync(aReadback.mFence);
+    aReadback.mFence = nullptr;
+
+    if (gl::GL_WAIT_FAILED == status)
+    {
+      ++mDropped;
+      return true;
+    }
+
+    EncodeJob job;
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+
+      // Workers are behind, keep the ring moving and lose this frame.
+      if (false == aWait && mJobs.size() >= mMaxQueuedJobs)
+      {
+        ++mDropped;
+        return true;
+      }
+
+      if (false == mFreePixels.empty())
+      {
+        job.mPixels = std::move(mFreePixels.back());
+        mFreePixels.pop_back();
+      }
+    }
+
+    job.mWidth = aReadback.mWidth;
+    job.mHeight = aReadback.mHeight;
+    job.mFrame = aReadback.mFrame;
+    job.mPixels.resize(aReadback.mSize);
+
+    gl::glBindBuffer(gl::GL_PIXEL_PACK_BUFFER, aReadback.mBuffer);
+    auto mapped = static_cast<unsigned char const*>(gl::glMapBufferRange(gl::GL_PIXEL_PACK_BUFFER, 0, aReadback.mSize, gl::BufferAccessMask::GL_MAP_READ_BIT));
+
+    if (nullptr != mapped)
+    {
+      // GL's origin is the bottom left, images start at the top. Flipping
+      // while copying out of the mapping costs nothing extra.
+      size_t rowSize = static_cast<size_t>(job.mWidth) * 4;
+      for (int y = 0; y < job.mHeight; ++y)
+      {
+        std::memcpy(job.mPixels.data() + rowSize * y, mapped + rowSize * (job.mHeight - 1 - y), rowSize);
+      }
+
+      gl::glUnmapBuffer(gl::GL_PIXEL_PACK_BUFFER);
+    }
+
+    gl::glBindBuffer(gl::GL_PIXEL_PACK_BUFFER, 0);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (nullptr == mapped)
+    {
+      ++mDropped;
+      mFreePixels.emplace_back(std::move(job.mPixels));
+      return true;
+    }
+
+    mJobs.emplace_back(std::move(job));
+    mJobReady.notify_one();
+    return true;
+  }
+
+  void FrameCapture::WorkerLoop()
+  {
+    ImGui_ImplTrace_SetThreadName("Capture worker");
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (true)
+    {
+      mJobReady.wait(lock, [this]() { return mStopWorkers || false == mJobs.empty(); });
+
+      // Drain the queue before stopping so Stop() doesn't lose frames.
+      if (mJobs.empty())
+      {
+        return;
+      }
+
+      EncodeJob job = std::move(mJobs.front());
+      mJobs.pop_front();
+
+      lock.unlock();
+      Encode(job);
+      lock.lock();
+
+      mFreePixels.emplace_back(std::move(job.mPixels));
+    }
+  }
+
+  static void WriteToFile(void* aContext, void* aData, int aSize)
+  {
+    fwrite(aData, 1, static_cast<size_t>(aSize), static_cast<FILE*>(aContext));
+  }
+
+  void FrameCapture::Encode(EncodeJob& aJob)
+  {
+    IMGUI_TRACE_ZONE("FrameCapture::Encode");
+
+    char path[32];
+    snprintf(path, sizeof(path), "%06llu.%s", static_cast<unsigned long long>(aJob.mFrame), CaptureFormat::Png == mFormat ? "png" : "jpg");
+
+    std::string file = mPathPrefix + path;
+    FILE* output = fopen(file.c_str(), "wb");
+
+    if (nullptr == output)
+    {
+      fprintf(stderr, "Failed to open %s for writing.\n", file.c_str());
+      return;
+    }
+
+    int written = 0;
+    if (CaptureFormat::Png == mFormat)
+    {
+      written = stbi_write_png_to_func(WriteToFile, output, aJob.mWidth, aJob.mHeight, 4, aJob.mPixels.data(), aJob.mWidth * 4);
+    }
+    else
+    {
+      written = stbi_write_jpg_to_func(WriteToFile, output, aJob.mWidth, aJob.mHeight, 4, aJob.mPixels.data(), mQuality);
+    }
+
+    fclose(output);
+
+    if (0 != written)
+    {
+      ++mWritten;
+    }
+  }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glbinding/gl/gl.h>
+
+namespace SOIS
+{
+  enum class CaptureFormat
+  {
+    Png,
+    Jpg
+  };
+
+  // Captures rendered frames to numbered image files without stalling the
+  // render thread. Each frame is read into one of a ring of pixel buffer
+  // objects, which we only map once its fence says the copy finished (a few
+  // frames later). Mapped pixels go to a pool of worker threads for encoding.
+  // When either the ring or the workers fall behind we drop frames rather
+  // than wait for them.
+  struct FrameCapture
+  {
+  public:
+    static constexpr int cReadbackBuffers = 3;
+
+    FrameCapture() = default;
+    ~FrameCapture();
+
+    FrameCapture(FrameCapture const&) = delete;
+    FrameCapture& operator=(FrameCapture const&) = delete;
+
+    // Starts writing frames to aPathPrefix followed by the frame number and
+    // extension, ie "capture/frame_" gives "capture/frame_000042.png".
+    // aQuality is only used for CaptureFormat::Jpg.
+    void Start(std::string const& aPathPrefix, CaptureFormat aFormat = CaptureFormat::Png, int aQuality = 90, int aWorkerCount = 2);
+
+    // Finishes the frames still in flight, waits for the workers to write
+    // them and releases the GL objects. Needs the GL context to be current.
+    void Stop();
+
+    bool IsCapturing() const { return mCapturing; }
+
+    // Queues a readback of the bound read framebuffer, and hands any earlier
+    // readbacks that completed to the workers. Call after rendering and
+    // before the swap.
+    void Capture(int aWidth, int aHeight);
+
+    int GetCapturedCount() const { return mCaptured; }
+    int GetDroppedCount() const { return mDropped; }
+    int GetWrittenCount() const { return mWritten.load(); }
+
+  private:
+    struct Readback
+    {
+      gl::GLuint mBuffer = 0;
+      gl::GLsync mFence = nullptr;
+      size_t mSize = 0;
+      int mWidth = 0;
+      int mHeight = 0;
+      uint64_t mFrame = 0;
+    };
+
+    struct EncodeJob
+    {
+      std::vector<unsigned char> mPixels;
+      int mWidth = 0;
+      int mHeight = 0;
+      uint64_t mFrame = 0;
+    };
+
+    // Maps a finished readback and queues it for encoding. When aWait is
+    // false and the GPU isn't done yet this returns false and does nothing.
+    bool Collect(Readback& aReadback, bool aWait);
+    void WorkerLoop();
+    void Encode(EncodeJob& aJob);
+
+    Readback mReadbacks[cReadbackBuffers];
+    int mNextReadback = 0;
+    uint64_t mFrame = 0;
+
+    std::string mPathPrefix;
+    CaptureFormat mFormat = CaptureFormat::Png;
+    int mQuality = 90;
+    bool mCapturing = false;
+    int mCaptured = 0;
+    int mDropped = 0;
+    std::atomic<int> mWritten{ 0 };
+
+    // Encoding jobs, and spare pixel storage so steady state capture doesn't
+    // allocate. Both are guarded by mMutex.
+    std::vector<std::thread> mWorkers;
+    std::mutex mMutex;
+    std::condition_variable mJobReady;
+    std::deque<EncodeJob> mJobs;
+    std::vector<std::vector<unsigned char>> mFreePixels;
+    size_t mMaxQueuedJobs = 0;
+    bool mStopWorkers = false;
+  };
+}
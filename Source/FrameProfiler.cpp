@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <cstring>
+
+#include "imgui.h"
+
+#include "FrameProfiler.hpp"
+
+namespace SOIS
+{
+  static ImU32 const cPhaseColors[cFramePhaseCount] =
+  {
+    IM_COL32(90, 150, 220, 255),
+    IM_COL32(110, 190, 120, 255),
+    IM_COL32(220, 180, 80, 255),
+    IM_COL32(200, 110, 200, 255),
+    IM_COL32(230, 110, 90, 255),
+    IM_COL32(150, 150, 150, 255),
+  };
+
+  static float ToMs(FrameProfiler::Clock::duration aDuration)
+  {
+    return std::chrono::duration<float, std::milli>(aDuration).count();
+  }
+
+  static bool HasTimerQueries()
+  {
+    gl::GLint major = 0, minor = 0;
+    gl::glGetIntegerv(gl::GL_MAJOR_VERSION, &major);
+    gl::glGetIntegerv(gl::GL_MINOR_VERSION, &minor);
+
+    if (major * 10 + minor >= 33)
+    {
+      return true;
+    }
+
+    gl::GLint count = 0;
+    gl::glGetIntegerv(gl::GL_NUM_EXTENSIONS, &count);
+    for (gl::GLint i = 0; i < count; ++i)
+    {
+      auto extension = reinterpret_cast<char const*>(gl::glGetStringi(gl::GL_EXTENSIONS, static_cast<gl::GLuint>(i)));
+      if (nullptr != extension && 0 == strcmp(extension, "GL_ARB_timer_query"))
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  char const* FrameProfiler::GetPhaseName(FramePhase aPhase)
+  {
+    switch (aPhase)
+    {
+      case FramePhase::PollEvents: return "Poll events";
+      case FramePhase::NewFrame: return "New frame";
+      case FramePhase::UserUpdate: return "User update";
+      case FramePhase::Render: return "ImGui::Render";
+      case FramePhase::RenderDrawData: return "Render draw data";
+      case FramePhase::SwapBuffers: return "Swap buffers";
+      default: return "";
+    }
+  }
+
+  void FrameProfiler::Initialize()
+  {
+    if (HasTimerQueries())
+    {
+      gl::glGenQueries(cQueryBuffers * cFramePhaseCount, &mQueries[0][0]);
+    }
+  }
+
+  void FrameProfiler::Shutdown()
+  {
+    if (HasGpuTimers())
+    {
+      gl::glDeleteQueries(cQueryBuffers * cFramePhaseCount, &mQueries[0][0]);
+    }
+
+    memset(mQueries, 0, sizeof(mQueries));
+    memset(mQueryIssued, 0, sizeof(mQueryIssued));
+  }
+
+  void FrameProfiler::BeginFrame()
+  {
+    if (false == mEnabled)
+    {
+      return;
+    }
+
+    mInFrame = true;
+    mFrameStart = Clock::now();
+    mHistory[mCurrent] = FrameTiming{};
+
+    // Reusing the older query buffer, read whatever it has first.
+    mQueryBuffer = (mQueryBuffer + 1) % cQueryBuffers;
+    CollectQueries(mQueryBuffer);
+    mQueryFrame[mQueryBuffer] = mCurrent;
+  }
+
+  void FrameProfiler::EndFrame()
+  {
+    if (false == mInFrame)
+    {
+      return;
+    }
+
+    mInFrame = false;
+    mHistory[mCurrent].mFrameMs = ToMs(Clock::now() - mFrameStart);
+    mCurrent = (mCurrent + 1) % cHistorySize;
+
+    if (mHistoryCount < cHistorySize)
+    {
+      ++mHistoryCount;
+    }
+  }
+
+  void FrameProfiler::BeginPhase(FramePhase aPhase)
+  {
+    if (false == mInFrame)
+    {
+      return;
+    }
+
+    int phase = static_cast<int>(aPhase);
+    mPhaseStart[phase] = Clock::now();
+    mHistory[mCurrent].mCpuStartMs[phase] = ToMs(mPhaseStart[phase] - mFrameStart);
+
+    if (HasGpuTimers())
+    {
+      gl::glBeginQuery(gl::GL_TIME_ELAPSED, mQueries[mQueryBuffer][phase]);
+      mQueryIssued[mQueryBuffer][phase] = true;
+    }
+  }
+
+  void FrameProfiler::EndPhase(FramePhase aPhase)
+  {
+    if (false == mInFrame)
+    {
+      return;
+    }
+
+    int phase = static_cast<int>(aPhase);
+    mHistory[mCurrent].mCpuMs[phase] = ToMs(Clock::now() - mPhaseStart[phase]);
+
+    if (HasGpuTimers())
+    {
+      gl::glEndQuery(gl::GL_TIME_ELAPSED);
+    }
+  }
+
+  void FrameProfiler::CollectQueries(int aBuffer)
+  {
+    FrameTiming& timing = mHistory[mQueryFrame[aBuffer]];
+    bool anyIssued = false;
+    bool allAvailable = true;
+
+    for (int phase = 0; phase < cFramePhaseCount; ++phase)
+    {
+      if (false == mQueryIssued[aBuffer][phase])
+      {
+        continue;
+      }
+
+      anyIssued = true;
+      mQueryIssued[aBuffer][phase] = false;
+
+      gl::GLint available = 0;
+      gl::glGetQueryObjectiv(mQueries[aBuffer][phase], gl::GL_QUERY_RESULT_AVAILABLE, &available);
+
+      // Never wait, a result that isn't ready by now is simply lost.
+      if (0 == available)
+      {
+        allAvailable = false;
+        continue;
+      }
+
+      gl::GLuint64 elapsed = 0;
+      gl::glGetQueryObjectui64v(mQueries[aBuffer][phase], gl::GL_QUERY_RESULT, &elapsed);
+      timing.mGpuMs[phase] = static_cast<float>(static_cast<double>(elapsed) / 1000000.0);
+    }
+
+    timing.mGpuValid = anyIssued && allAvailable;
+  }
+
+  FrameTiming const& FrameProfiler::GetFrame(int aAge) const
+  {
+    int index = (mCurrent - 1 - aAge) % cHistorySize;
+    return mHistory[index < 0 ? index + cHistorySize : index];
+  }
+
+  void FrameProfiler::DrawOverlay(bool* aOpen) const
+  {
+    if (false == ImGui::Begin("Frame profiler", aOpen))
+    {
+      ImGui::End();
+      return;
+    }
+
+    if (0 == mHistoryCount)
+    {
+      ImGui::TextUnformatted(mEnabled ? "Waiting for the first frame." : "Profiling is disabled.");
+      ImGui::End();
+      return;
+    }
+
+    // GPU results lag behind, show the newest frame that has them.
+    FrameTiming const& last = GetFrame(0);
+    FrameTiming const* gpu = nullptr;
+    for (int age = 0; age < mHistoryCount && age <= cQueryBuffers + 1; ++age)
+    {
+      if (GetFrame(age).mGpuValid)
+      {
+        gpu = &GetFrame(age);
+        break;
+      }
+    }
+
+    ImGui::Text("Frame %.2f ms", last.mFrameMs);
+    for (int phase = 0; phase < cFramePhaseCount; ++phase)
+    {
+      ImGui::ColorButton(GetPhaseName(static_cast<FramePhase>(phase)), ImColor(cPhaseColors[phase]), ImGuiColorEditFlags_NoTooltip, ImVec2(10.0f, 10.0f));
+      ImGui::SameLine();
+      if (nullptr != gpu)
+        ImGui::Text("%-18s CPU %6.3f ms  GPU %6.3f ms", GetPhaseName(static_cast<FramePhase>(phase)), last.mCpuMs[phase], gpu->mGpuMs[phase]);
+      else
+        ImGui::Text("%-18s CPU %6.3f ms  GPU n/a", GetPhaseName(static_cast<FramePhase>(phase)), last.mCpuMs[phase]);
+    }
+
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    float width = ImGui::GetContentRegionAvail().x;
+    float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+
+    // Flame graph of the last frame, CPU phases at their actual start times
+    // and GPU phases back to back underneath, both scaled to the frame time.
+    float scale = last.mFrameMs > 0.0f ? width / last.mFrameMs : 0.0f;
+    for (int row = 0; row < 2; ++row)
+    {
+      ImVec2 origin = ImGui::GetCursorScreenPos();
+      drawList->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + rowHeight), IM_COL32(40, 40, 40, 255));
+
+      float gpuStart = 0.0f;
+      for (int phase = 0; phase < cFramePhaseCount; ++phase)
+      {
+        float start = 0.0f;
+        float duration = 0.0f;
+        if (0 == row)
+        {
+          start = last.mCpuStartMs[phase];
+          duration = last.mCpuMs[phase];
+        }
+        else if (nullptr != gpu)
+        {
+          start = gpuStart;
+          duration = gpu->mGpuMs[phase];
+          gpuStart += duration;
+        }
+
+        if (duration <= 0.0f)
+        {
+          continue;
+        }
+
+        ImVec2 min(origin.x + start * scale, origin.y);
+        ImVec2 max(origin.x + std::min((start + duration) * scale, width), origin.y + rowHeight);
+        if (max.x - min.x < 1.0f)
+        {
+          max.x = min.x + 1.0f;
+        }
+
+        drawList->AddRectFilled(min, max, cPhaseColors[phase]);
+
+        char const* name = GetPhaseName(static_cast<FramePhase>(phase));
+        if (ImGui::CalcTextSize(name).x + 4.0f < max.x - min.x)
+        {
+          drawList->AddText(ImVec2(min.x + 2.0f, min.y + 2.0f), IM_COL32_BLACK, name);
+        }
+      }
+
+      drawList->AddText(ImVec2(origin.x + width - ImGui::CalcTextSize("GPU").x - 2.0f, origin.y + 2.0f), IM_COL32_WHITE, 0 == row ? "CPU" : "GPU");
+      ImGui::Dummy(ImVec2(width, rowHeight + 2.0f));
+    }
+
+    // Rolling history, one column per frame with the CPU phases stacked,
+    // scaled so the slowest frame fits.
+    float graphHeight = 80.0f;
+    float longest = 1.0f;
+    for (int age = 0; age < mHistoryCount; ++age)
+    {
+      longest = std::max(longest, GetFrame(age).mFrameMs);
+    }
+
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    drawList->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + graphHeight), IM_COL32(40, 40, 40, 255));
+
+    float column = width / cHistorySize;
+    for (int age = 0; age < mHistoryCount; ++age)
+    {
+      FrameTiming const& timing = GetFrame(age);
+      float x = origin.x + width - (age + 1) * column;
+      float y = origin.y + graphHeight;
+
+      for (int phase = 0; phase < cFramePhaseCount; ++phase)
+      {
+        float height = timing.mCpuMs[phase] / longest * graphHeight;
+        if (height <= 0.0f)
+        {
+          continue;
+        }
+
+        drawList->AddRectFilled(ImVec2(x, y - height), ImVec2(x + std::max(column - 1.0f, 1.0f), y), cPhaseColors[phase]);
+        y -= height;
+      }
+    }
+
+    ImGui::Dummy(ImVec2(width, graphHeight));
+    ImGui::Text("History of %d frames, longest %.2f ms", mHistoryCount, longest);
+    ImGui::End();
+  }
+}
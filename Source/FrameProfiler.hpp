@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+
+#include <glbinding/gl/gl.h>
+
+namespace SOIS
+{
+  // The parts of a frame ApplicationContext times, in the order they run.
+  enum class FramePhase
+  {
+    PollEvents,
+    NewFrame,
+    UserUpdate,
+    Render,
+    RenderDrawData,
+    SwapBuffers,
+    Count
+  };
+
+  constexpr int cFramePhaseCount = static_cast<int>(FramePhase::Count);
+
+  // Timings of a single frame, all in milliseconds. CPU starts are relative
+  // to the start of the frame. GPU times arrive a couple of frames late, and
+  // mGpuValid stays false if the driver never got around to them.
+  struct FrameTiming
+  {
+    float mFrameMs = 0.0f;
+    float mCpuStartMs[cFramePhaseCount] = {};
+    float mCpuMs[cFramePhaseCount] = {};
+    float mGpuMs[cFramePhaseCount] = {};
+    bool mGpuValid = false;
+  };
+
+  // Records CPU and GPU time per FramePhase, keeping a rolling history of the
+  // last cHistorySize frames. GPU time comes from GL_TIME_ELAPSED queries,
+  // double buffered and only read once their results are available, so the
+  // profiler never waits on the GPU. While a phase is timed on the GPU, user
+  // code can't run its own GL_TIME_ELAPSED queries.
+  struct FrameProfiler
+  {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int cHistorySize = 240;
+    static constexpr int cQueryBuffers = 2;
+
+    FrameProfiler() = default;
+    ~FrameProfiler() = default;
+
+    FrameProfiler(FrameProfiler const&) = delete;
+    FrameProfiler& operator=(FrameProfiler const&) = delete;
+
+    // GPU timing needs GL 3.3 or ARB_timer_query, without it only CPU times
+    // are recorded. Needs the GL context to be current.
+    void Initialize();
+    void Shutdown();
+
+    void SetEnabled(bool aEnabled) { mEnabled = aEnabled; }
+    bool GetEnabled() const { return mEnabled; }
+    bool HasGpuTimers() const { return 0 != mQueries[0][0]; }
+
+    void BeginFrame();
+    void EndFrame();
+    void BeginPhase(FramePhase aPhase);
+    void EndPhase(FramePhase aPhase);
+
+    // aAge 0 is the last completed frame, up to GetHistoryCount() - 1.
+    FrameTiming const& GetFrame(int aAge) const;
+    int GetHistoryCount() const { return mHistoryCount; }
+
+    // A window with the last frame's phases laid out as a flame graph, and
+    // the history as stacked bars.
+    void DrawOverlay(bool* aOpen = nullptr) const;
+
+    static char const* GetPhaseName(FramePhase aPhase);
+
+  private:
+    void CollectQueries(int aBuffer);
+
+    bool mEnabled = false;
+    bool mInFrame = false;
+
+    FrameTiming mHistory[cHistorySize];
+    int mCurrent = 0;
+    int mHistoryCount = 0;
+    Clock::time_point mFrameStart;
+    Clock::time_point mPhaseStart[cFramePhaseCount];
+
+    // Each query buffer remembers which history entry its results belong to.
+    gl::GLuint mQueries[cQueryBuffers][cFramePhaseCount] = {};
+    bool mQueryIssued[cQueryBuffers][cFramePhaseCount] = {};
+    int mQueryFrame[cQueryBuffers] = {};
+    int mQueryBuffer = 0;
+  };
+}
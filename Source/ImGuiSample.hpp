@@ -1,17 +1,38 @@
 #pragma once
 
+#include <cmath>
+#include <cstdio>
+
 #include "imgui.h"
+#include "imgui_impl_opengl3.h"
+#include "imgui_textview.h"
 #include "glm/glm.hpp"
 
+#include "ApplicationContext.hpp"
+
 namespace SOIS
 {
     struct ImGuiSample
     {
       bool show_demo_window = true;
       bool show_another_window = false;
+      bool streaming_renderer = true;
+      bool show_log_view = false;
+      bool stream_log = false;
+      bool show_many_windows = false;
+      int many_windows_count = 5000;
+      bool show_dense_plot = false;
+      int dense_plot_samples = 100000;
+      bool show_wires = false;
+      int wires_count = 2000;
+      ImDrawListBlock wires_grid;
+      ImVec2 wires_grid_size;
+      char log_path[256] = "";
+      ImGuiTextDocument log_document;
+      int capture_format = 0;
       glm::vec4 mClearColor = glm::vec4(0.45f, 0.55f, 0.60f, 1.00f);
 
-      void Update()
+      void Update(ApplicationContext& aContext)
       {
         // 1. Show the big demo window (Most of the sample code is in ImGui::ShowDemoWindow()! You can browse its code to learn more about Dear ImGui!).
         if (show_demo_window)
@@ -27,6 +48,16 @@ namespace SOIS
           ImGui::Text("This is some useful text.");               // Display some text (you can use a format strings too)
           ImGui::Checkbox("Demo Window", &show_demo_window);      // Edit bools storing our window open/close state
           ImGui::Checkbox("Another Window", &show_another_window);
+          ImGui::Checkbox("Log View", &show_log_view);
+          ImGui::Checkbox("Many windows", &show_many_windows);
+          if (show_many_windows)
+          {
+            ImGui::SameLine();
+            ImGui::SliderInt("##count", &many_windows_count, 1, 10000);
+          }
+          ImGui::Checkbox("Dense plot", &show_dense_plot);
+          ImGui::SameLine();
+          ImGui::Checkbox("Wires", &show_wires);
 
           ImGui::SliderFloat("float", &f, 0.0f, 1.0f);            // Edit 1 float using a slider from 0.0f to 1.0f
           ImGui::ColorEdit3("clear color", (float*)&mClearColor); // Edit 3 floats representing a color
@@ -37,9 +68,73 @@ namespace SOIS
           ImGui::Text("counter = %d", counter);
 
           ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+
+          // Draw calls of the previous frame, toggle the streaming renderer to compare batched and per-command submission.
+          auto stats = ImGui_ImplOpenGL3_GetRenderStats();
+          ImGui::Text("Renderer: %d draw calls for %d commands, %d bytes uploaded", stats->DrawCalls, stats->CmdCount, stats->UploadedBytes);
+          if (ImGui::Checkbox("Streaming renderer", &streaming_renderer))
+            ImGui_ImplOpenGL3_SetStreamingBuffers(streaming_renderer);
+
+          // Allocations of the previous frame, none should reach the heap once nothing changes.
+          auto const& allocations = aContext.GetAllocator().GetLastFrameStats();
+          ImGui::Text("Allocator: %d allocations (%d from the heap), %d frees, %.1f KB live", allocations.mAllocations, allocations.mHeapAllocations, allocations.mFrees, aContext.GetAllocator().GetLiveBytes() / 1024.0f);
+
+          // Frame pacing, compare the input latency of each mode.
+          const char* pacing_names[] = { "VSync", "Uncapped", "FPS cap", "Low latency" };
+          int pacing = (int)aContext.GetFramePacing();
+          float target_fps = (float)aContext.GetTargetFps();
+          bool pacing_changed = ImGui::Combo("Frame pacing", &pacing, pacing_names, IM_ARRAYSIZE(pacing_names));
+          if (pacing == (int)FramePacing::FpsCap)
+            pacing_changed |= ImGui::SliderFloat("Target FPS", &target_fps, 10.0f, 240.0f, "%.0f");
+          if (pacing_changed)
+            aContext.SetFramePacing((FramePacing)pacing, target_fps);
+          ImGui::Text("Input to present %.2f ms (average %.2f ms)", aContext.GetLatency().mLastMs, aContext.GetLatency().mAverageMs);
+
+          // Only redraw on input, the demo's animated widgets stop while idle.
+          bool idle_rendering = aContext.GetIdleRendering();
+          if (ImGui::Checkbox("Idle rendering", &idle_rendering))
+            aContext.SetIdleRendering(idle_rendering);
+
+          // Skip presenting frames identical to the one on screen.
+          bool skip_unchanged = aContext.GetSkipUnchangedFrames();
+          if (ImGui::Checkbox("Skip unchanged frames", &skip_unchanged))
+            aContext.SetSkipUnchangedFrames(skip_unchanged);
+          ImGui::SameLine();
+          ImGui::Text("(%d skipped)", aContext.GetSkippedFrameCount());
+
+          // Write every frame to capture_NNNNNN.png (or .jpg) next to the executable.
+          FrameCapture& capture = aContext.GetCapture();
+          bool capturing = capture.IsCapturing();
+          ImGui::Combo("Capture format", &capture_format, "PNG\0JPG\0");
+          if (ImGui::Checkbox("Capture frames", &capturing))
+          {
+            if (capturing)
+              capture.Start("capture_", (CaptureFormat)capture_format);
+            else
+              capture.Stop();
+          }
+          ImGui::SameLine();
+          ImGui::Text("(%d captured, %d written, %d dropped)", capture.GetCapturedCount(), capture.GetWrittenCount(), capture.GetDroppedCount());
+
+          // Per phase CPU and GPU times of each frame.
+          FrameProfiler& profiler = aContext.GetProfiler();
+          bool profiling = profiler.GetEnabled();
+          if (ImGui::Checkbox("Frame profiler", &profiling))
+            profiler.SetEnabled(profiling);
+
+          // Record trace zones, and save the recent ones for chrome://tracing or ui.perfetto.dev.
+          bool tracing = aContext.GetTracing();
+          if (ImGui::Checkbox("Tracing", &tracing))
+            aContext.SetTracing(tracing);
+          ImGui::SameLine();
+          if (ImGui::Button("Write trace (F12)"))
+            aContext.WriteTrace();
           ImGui::End();
         }
 
+        if (aContext.GetProfiler().GetEnabled())
+          aContext.GetProfiler().DrawOverlay();
+
         // 3. Show another simple window.
         if (show_another_window)
         {
@@ -49,6 +144,119 @@ namespace SOIS
             show_another_window = false;
           ImGui::End();
         }
+
+        // 4. A log console, only the visible lines are drawn however big the document gets.
+        if (show_log_view)
+        {
+          ImGui::Begin("Log View", &show_log_view);
+          if (ImGui::Button("Append 100000 lines"))
+            for (int i = 0; i < 100000; i++)
+              log_document.Appendf("Line %d appended on frame %d\n", log_document.GetLineCount(), ImGui::GetFrameCount());
+          ImGui::SameLine();
+          ImGui::Checkbox("Stream", &stream_log);
+          ImGui::SameLine();
+          if (ImGui::Button("Clear"))
+            log_document.Clear();
+
+          // Large files are mapped rather than read, and indexed a slice per frame.
+          ImGui::InputText("##path", log_path, IM_ARRAYSIZE(log_path));
+          ImGui::SameLine();
+          if (ImGui::Button("Open file"))
+            log_document.MapFile(log_path);
+          ImGui::Text("%d lines, %.1f MB%s", log_document.GetLineCount(), log_document.GetTextSize() / (1024.0 * 1024.0), log_document.IsIndexed() ? "" : ", indexing...");
+
+          if (stream_log)
+            log_document.Appendf("Frame %d, %.3f ms\n", ImGui::GetFrameCount(), 1000.0f / ImGui::GetIO().Framerate);
+          ImGui::TextView("log", &log_document);
+          ImGui::End();
+        }
+
+        // 5. Stress test for focus and CTRL+TAB with thousands of windows, tiled over the screen.
+        if (show_many_windows)
+        {
+          ImVec2 display_size = ImGui::GetIO().DisplaySize;
+          int columns = (int)(display_size.x / 160.0f);
+          if (columns < 1)
+            columns = 1;
+          for (int i = 0; i < many_windows_count; i++)
+          {
+            char name[32];
+            snprintf(name, IM_ARRAYSIZE(name), "Window %d", i);
+            ImGui::SetNextWindowPos(ImVec2((float)(i % columns) * 160.0f, (float)((i / columns) % 20) * 40.0f + (float)(i / (columns * 20)) * 4.0f), ImGuiCond_FirstUseEver);
+            ImGui::SetNextWindowSize(ImVec2(150.0f, 36.0f), ImGuiCond_FirstUseEver);
+            ImGui::Begin(name, nullptr, ImGuiWindowFlags_NoSavedSettings);
+            ImGui::Text("%d", i);
+            ImGui::End();
+          }
+        }
+
+        // 6. A plot with far more than 64K vertices in one window, drawn with 16-bit indices.
+        if (show_dense_plot)
+        {
+          ImGui::SetNextWindowSize(ImVec2(600.0f, 300.0f), ImGuiCond_FirstUseEver);
+          ImGui::Begin("Dense plot", &show_dense_plot);
+          ImGui::SliderInt("Samples", &dense_plot_samples, 2, 500000);
+
+          ImDrawList* draw_list = ImGui::GetWindowDrawList();
+          ImVec2 origin = ImGui::GetCursorScreenPos();
+          ImVec2 size = ImGui::GetContentRegionAvail();
+          float time = (float)ImGui::GetTime();
+          // Only needed until the polyline is tessellated, so it comes from the frame arena.
+          ImVec2* dense_plot_points = static_cast<ImVec2*>(aContext.GetAllocator().AllocateTransient(sizeof(ImVec2) * dense_plot_samples));
+          for (int i = 0; i < dense_plot_samples; i++)
+          {
+            float t = (float)i / (float)(dense_plot_samples - 1);
+            float value = 0.5f + 0.3f * sinf(t * 40.0f + time) + 0.15f * sinf(t * 1700.0f + time * 3.0f);
+            dense_plot_points[i] = ImVec2(origin.x + t * size.x, origin.y + value * size.y);
+          }
+          int commands = draw_list->CmdBuffer.Size;
+          draw_list->AddPolyline(dense_plot_points, dense_plot_samples, IM_COL32(255, 200, 0, 255), false, 1.0f);
+          ImGui::Text("%d vertices in this window, the plot took %d draw commands", draw_list->VtxBuffer.Size, draw_list->CmdBuffer.Size - commands + 1);
+          ImGui::End();
+        }
+
+        // 7. Node graph style wires, thousands of Bezier curves flattened and stroked in one call.
+        if (show_wires)
+        {
+          ImGui::SetNextWindowSize(ImVec2(600.0f, 400.0f), ImGuiCond_FirstUseEver);
+          ImGui::Begin("Wires", &show_wires);
+          ImGui::SliderInt("Count", &wires_count, 1, 20000);
+
+          ImDrawList* draw_list = ImGui::GetWindowDrawList();
+          ImVec2 origin = ImGui::GetCursorScreenPos();
+          ImVec2 size = ImGui::GetContentRegionAvail();
+
+          // The grid behind only changes with the window size, it's recorded once and appended again every frame.
+          if (!wires_grid.Valid || wires_grid_size.x != size.x || wires_grid_size.y != size.y)
+          {
+            wires_grid_size = size;
+            draw_list->BeginBlock(&wires_grid);
+            for (float x = 0.0f; x < size.x; x += 16.0f)
+              draw_list->AddLine(ImVec2(x, 0.0f), ImVec2(x, size.y), IM_COL32(255, 255, 255, 24));
+            for (float y = 0.0f; y < size.y; y += 16.0f)
+              draw_list->AddLine(ImVec2(0.0f, y), ImVec2(size.x, y), IM_COL32(255, 255, 255, 24));
+            draw_list->EndBlock();
+          }
+          draw_list->AddBlock(&wires_grid, origin);
+
+          float time = (float)ImGui::GetTime();
+          ImVec2* wires_points = static_cast<ImVec2*>(aContext.GetAllocator().AllocateTransient(sizeof(ImVec2) * wires_count * 4));
+          for (int i = 0; i < wires_count; i++)
+          {
+            // From an output on the left to an input on the right, with horizontal tangents.
+            float from = 0.5f + 0.5f * sinf((float)i * 12.9898f);
+            float to = 0.5f + 0.5f * sinf((float)i * 78.233f + time * 0.5f);
+            ImVec2 p0(origin.x, origin.y + from * size.y);
+            ImVec2 p1(origin.x + size.x, origin.y + to * size.y);
+            float tangent = size.x * 0.5f;
+            wires_points[i * 4 + 0] = p0;
+            wires_points[i * 4 + 1] = ImVec2(p0.x + tangent, p0.y);
+            wires_points[i * 4 + 2] = ImVec2(p1.x - tangent, p1.y);
+            wires_points[i * 4 + 3] = p1;
+          }
+          draw_list->AddBezierCurves(wires_points, wires_count, IM_COL32(200, 200, 100, 160), 1.5f);
+          ImGui::End();
+        }
       }
     };
 }
\ No newline at end of file
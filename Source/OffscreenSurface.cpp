@@ -0,0 +1,210 @@
+#include <cstring>
+
+#include "OffscreenSurface.hpp"
+
+#if defined(SOIS_HAS_EGL)
+  // We never need the X11 types EGL would otherwise pull in.
+  #define EGL_NO_X11
+  #define MESA_EGL_NO_X11_HEADERS
+  #include <EGL/egl.h>
+  #include <EGL/eglext.h>
+#else
+  #include <GLFW/glfw3.h>
+#endif
+
+namespace SOIS
+{
+  OffscreenSurface::~OffscreenSurface()
+  {
+    Destroy();
+  }
+
+#if defined(SOIS_HAS_EGL)
+  // Prefers Mesa's surfaceless platform, which needs neither a window system
+  // nor a GPU. Falls back to the default display, which may still be headless
+  // on drivers exposing EGL devices.
+  static EGLDisplay GetHeadlessDisplay()
+  {
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    char const* extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+    if (nullptr != getPlatformDisplay &&
+        nullptr != extensions &&
+        nullptr != std::strstr(extensions, "EGL_MESA_platform_surfaceless"))
+    {
+      EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+
+      if (EGL_NO_DISPLAY != display)
+      {
+        return display;
+      }
+    }
+
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  }
+
+  bool OffscreenSurface::CreateContext()
+  {
+    EGLDisplay display = GetHeadlessDisplay();
+
+    if (EGL_NO_DISPLAY == display ||
+        EGL_FALSE == eglInitialize(display, nullptr, nullptr))
+    {
+      return false;
+    }
+
+    mDisplay = display;
+
+    EGLint const configAttributes[] = {
+      EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+      EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+      EGL_RED_SIZE, 8,
+      EGL_GREEN_SIZE, 8,
+      EGL_BLUE_SIZE, 8,
+      EGL_ALPHA_SIZE, 8,
+      EGL_NONE
+    };
+
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (EGL_FALSE == eglBindAPI(EGL_OPENGL_API) ||
+        EGL_FALSE == eglChooseConfig(display, configAttributes, &config, 1, &configCount) ||
+        0 == configCount)
+    {
+      return false;
+    }
+
+    mContext = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr);
+
+    if (EGL_NO_CONTEXT == mContext)
+    {
+      return false;
+    }
+
+    // We render into our own framebuffer, the surface only exists because
+    // not every driver supports making a context current without one.
+    char const* extensions = eglQueryString(display, EGL_EXTENSIONS);
+    bool surfaceless = nullptr != extensions && nullptr != std::strstr(extensions, "EGL_KHR_surfaceless_context");
+
+    if (false == surfaceless)
+    {
+      EGLint const surfaceAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+      mSurface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+
+      if (EGL_NO_SURFACE == mSurface)
+      {
+        return false;
+      }
+    }
+
+    EGLSurface surface = surfaceless ? EGL_NO_SURFACE : static_cast<EGLSurface>(mSurface);
+    return EGL_FALSE != eglMakeCurrent(display, surface, surface, static_cast<EGLContext>(mContext));
+  }
+
+  OffscreenSurface::ProcAddress OffscreenSurface::GetProcAddress(char const* aName)
+  {
+    return eglGetProcAddress(aName);
+  }
+#else
+  bool OffscreenSurface::CreateContext()
+  {
+    // Headless applications may not have called ApplicationInitialization.
+    if (!glfwInit())
+    {
+      return false;
+    }
+
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(1, 1, "Offscreen", nullptr, nullptr);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+    if (nullptr == window)
+    {
+      return false;
+    }
+
+    mContext = window;
+    glfwMakeContextCurrent(window);
+    return true;
+  }
+
+  OffscreenSurface::ProcAddress OffscreenSurface::GetProcAddress(char const* aName)
+  {
+    return glfwGetProcAddress(aName);
+  }
+#endif
+
+  bool OffscreenSurface::CreateFramebuffer(int aWidth, int aHeight)
+  {
+    mWidth = aWidth;
+    mHeight = aHeight;
+
+    gl::glGenRenderbuffers(1, &mColorBuffer);
+    gl::glBindRenderbuffer(gl::GL_RENDERBUFFER, mColorBuffer);
+    gl::glRenderbufferStorage(gl::GL_RENDERBUFFER, gl::GL_RGBA8, aWidth, aHeight);
+
+    gl::glGenFramebuffers(1, &mFramebuffer);
+    gl::glBindFramebuffer(gl::GL_FRAMEBUFFER, mFramebuffer);
+    gl::glFramebufferRenderbuffer(gl::GL_FRAMEBUFFER, gl::GL_COLOR_ATTACHMENT0, gl::GL_RENDERBUFFER, mColorBuffer);
+
+    return gl::GL_FRAMEBUFFER_COMPLETE == gl::glCheckFramebufferStatus(gl::GL_FRAMEBUFFER);
+  }
+
+  void OffscreenSurface::Destroy()
+  {
+    if (nullptr == mContext)
+    {
+      return;
+    }
+
+    if (0 != mFramebuffer)
+    {
+      gl::glDeleteFramebuffers(1, &mFramebuffer);
+      gl::glDeleteRenderbuffers(1, &mColorBuffer);
+      mFramebuffer = mColorBuffer = 0;
+    }
+
+#if defined(SOIS_HAS_EGL)
+    EGLDisplay display = static_cast<EGLDisplay>(mDisplay);
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(display, static_cast<EGLContext>(mContext));
+
+    if (nullptr != mSurface)
+    {
+      eglDestroySurface(display, static_cast<EGLSurface>(mSurface));
+    }
+
+    eglTerminate(display);
+#else
+    glfwDestroyWindow(static_cast<GLFWwindow*>(mContext));
+#endif
+
+    mDisplay = mContext = mSurface = nullptr;
+  }
+
+  void OffscreenSurface::Bind()
+  {
+    gl::glBindFramebuffer(gl::GL_FRAMEBUFFER, mFramebuffer);
+  }
+
+  void OffscreenSurface::Read(std::vector<unsigned char>& aRgba)
+  {
+    size_t rowSize = static_cast<size_t>(mWidth) * 4;
+    aRgba.resize(rowSize * mHeight);
+
+    gl::glBindFramebuffer(gl::GL_READ_FRAMEBUFFER, mFramebuffer);
+    gl::glPixelStorei(gl::GL_PACK_ALIGNMENT, 1);
+    gl::glReadPixels(0, 0, mWidth, mHeight, gl::GL_RGBA, gl::GL_UNSIGNED_BYTE, aRgba.data());
+
+    // GL's origin is the bottom left, images start at the top.
+    std::vector<unsigned char> row(rowSize);
+    for (int y = 0; y < mHeight / 2; ++y)
+    {
+      unsigned char* top = aRgba.data() + rowSize * y;
+      unsigned char* bottom = aRgba.data() + rowSize * (mHeight - 1 - y);
+      std::memcpy(row.data(), top, rowSize);
+      std::memcpy(top, bottom, rowSize);
+      std::memcpy(bottom, row.data(), rowSize);
+    }
+  }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+
+#include <glbinding/gl/gl.h>
+
+namespace SOIS
+{
+  // A GL context that renders into a framebuffer object instead of a window.
+  // Where EGL is available (SOIS_HAS_EGL) the context comes from a surfaceless
+  // or pbuffer EGL display, so no window system is needed at all (Mesa's
+  // llvmpipe works on GPU-less machines). Otherwise we fall back to a hidden
+  // GLFW window, which still needs a window system but never shows anything.
+  struct OffscreenSurface
+  {
+  public:
+    OffscreenSurface() = default;
+    ~OffscreenSurface();
+
+    OffscreenSurface(OffscreenSurface const&) = delete;
+    OffscreenSurface& operator=(OffscreenSurface const&) = delete;
+
+    // Creates the context and makes it current. The framebuffer is created
+    // separately by CreateFramebuffer, once GL functions are loaded.
+    bool CreateContext();
+
+    // GL loader function for the contexts made by CreateContext.
+    using ProcAddress = void (*)();
+    static ProcAddress GetProcAddress(char const* aName);
+
+    bool CreateFramebuffer(int aWidth, int aHeight);
+    void Destroy();
+
+    // Binds our framebuffer for drawing and reading.
+    void Bind();
+
+    // Reads the framebuffer back as tightly packed RGBA, top row first.
+    void Read(std::vector<unsigned char>& aRgba);
+
+    int GetWidth() const { return mWidth; }
+    int GetHeight() const { return mHeight; }
+
+  private:
+    // Opaque EGL handles (or the hidden GLFW window) so users of this header
+    // don't need the platform headers.
+    void* mDisplay = nullptr;
+    void* mContext = nullptr;
+    void* mSurface = nullptr;
+
+    gl::GLuint mFramebuffer = 0;
+    gl::GLuint mColorBuffer = 0;
+    int mWidth = 0;
+    int mHeight = 0;
+  };
+}
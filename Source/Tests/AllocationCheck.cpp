@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+  #include <execinfo.h>
+  #define SOIS_HAS_EXECINFO
+#elif defined(_WIN32)
+  #include <windows.h>
+#endif
+
+#include "imgui.h"
+
+#include "AllocationCheck.hpp"
+#include "FrameAllocator.hpp"
+
+namespace SOIS
+{
+  constexpr int cMaxStackFrames = 24;
+  constexpr int cMaxStacks = 64;
+
+  // Leaves out the frame of Record() (or of the hook, when Record() was
+  // inlined into it).
+  constexpr int cSkippedFrames = 1;
+
+  struct AllocationStack
+  {
+    void* mFrames[cMaxStackFrames];
+    int mFrameCount;
+    char const* mSource;
+    int mCount;
+    size_t mBytes;
+  };
+
+  static std::atomic<bool> sArmed{ false };
+  static std::atomic<int> sCount{ 0 };
+
+  // Fixed storage, recording an allocation must not allocate.
+  static std::mutex sStacksLock;
+  static AllocationStack sStacks[cMaxStacks];
+  static int sStackCount = 0;
+  static int sUnrecordedCount = 0;
+
+  // Unwinders may allocate, don't record what they do.
+  static thread_local bool tRecording = false;
+
+  static int CaptureStack(void** aFrames, int aMaxFrames)
+  {
+    #if defined(SOIS_HAS_EXECINFO)
+      return backtrace(aFrames, aMaxFrames);
+    #elif defined(_WIN32)
+      return CaptureStackBackTrace(0, static_cast<DWORD>(aMaxFrames), aFrames, nullptr);
+    #else
+      (void)aFrames;
+      (void)aMaxFrames;
+      return 0;
+    #endif
+  }
+
+  static void PrintStack(FILE* aOutput, void* const* aFrames, int aFrameCount)
+  {
+    #if defined(SOIS_HAS_EXECINFO)
+      fflush(aOutput);
+      backtrace_symbols_fd(aFrames, aFrameCount, fileno(aOutput));
+    #else
+      // No symbols here, look the addresses up in the debugger or with the
+      // map file.
+      for (int i = 0; i < aFrameCount; ++i)
+      {
+        fprintf(aOutput, "    %p\n", aFrames[i]);
+      }
+    #endif
+  }
+
+  static void Record(size_t aSize, char const* aSource)
+  {
+    if (false == sArmed.load(std::memory_order_relaxed) || tRecording)
+    {
+      return;
+    }
+
+    tRecording = true;
+    sCount.fetch_add(1, std::memory_order_relaxed);
+
+    void* frames[cMaxStackFrames + cSkippedFrames];
+    int frameCount = CaptureStack(frames, cMaxStackFrames + cSkippedFrames);
+    int skipped = std::min(frameCount, cSkippedFrames);
+    frameCount -= skipped;
+
+    {
+      std::lock_guard<std::mutex> lock(sStacksLock);
+
+      AllocationStack* stack = nullptr;
+      for (int i = 0; i < sStackCount && nullptr == stack; ++i)
+      {
+        AllocationStack& candidate = sStacks[i];
+        if (candidate.mSource == aSource &&
+            candidate.mFrameCount == frameCount &&
+            0 == memcmp(candidate.mFrames, frames + skipped, frameCount * sizeof(void*)))
+        {
+          stack = &candidate;
+        }
+      }
+
+      if (nullptr == stack && sStackCount < cMaxStacks)
+      {
+        stack = &sStacks[sStackCount++];
+        memcpy(stack->mFrames, frames + skipped, frameCount * sizeof(void*));
+        stack->mFrameCount = frameCount;
+        stack->mSource = aSource;
+        stack->mCount = 0;
+        stack->mBytes = 0;
+      }
+
+      if (nullptr != stack)
+      {
+        ++stack->mCount;
+        stack->mBytes += aSize;
+      }
+      else
+      {
+        ++sUnrecordedCount;
+      }
+    }
+
+    tRecording = false;
+  }
+
+  static void* CheckedImGuiAlloc(size_t aSize, void* aUserData)
+  {
+    Record(aSize, "ImGui::MemAlloc");
+    return FrameAllocator::ImGuiAlloc(aSize, aUserData);
+  }
+
+  static void CheckedImGuiFree(void* aPointer, void* aUserData)
+  {
+    FrameAllocator::ImGuiFree(aPointer, aUserData);
+  }
+
+  void ArmAllocationCheck()
+  {
+    // The first backtrace loads the unwinder, which allocates.
+    void* frames[4];
+    CaptureStack(frames, 4);
+
+    {
+      std::lock_guard<std::mutex> lock(sStacksLock);
+      sStackCount = 0;
+      sUnrecordedCount = 0;
+    }
+
+    sCount = 0;
+    ImGui::SetAllocatorFunctions(CheckedImGuiAlloc, CheckedImGuiFree, &FrameAllocator::Get());
+    sArmed = true;
+  }
+
+  void DisarmAllocationCheck()
+  {
+    sArmed = false;
+    FrameAllocator::Get().Install();
+  }
+
+  int GetCheckedAllocationCount()
+  {
+    return sCount.load(std::memory_order_relaxed);
+  }
+
+  bool ReportAllocationCheck(FILE* aOutput)
+  {
+    std::lock_guard<std::mutex> lock(sStacksLock);
+
+    int count = sCount.load(std::memory_order_relaxed);
+    if (0 == count)
+    {
+      fprintf(aOutput, "Allocation check passed, no allocations.\n");
+      return true;
+    }
+
+    std::sort(sStacks, sStacks + sStackCount, [](AllocationStack const& aLeft, AllocationStack const& aRight)
+    {
+      return aLeft.mCount > aRight.mCount;
+    });
+
+    fprintf(aOutput, "Allocation check failed, %d allocations from %d call stacks:\n", count, sStackCount);
+    for (int i = 0; i < sStackCount; ++i)
+    {
+      AllocationStack const& stack = sStacks[i];
+      fprintf(aOutput, "\n%d allocations (%zu bytes) through %s:\n", stack.mCount, stack.mBytes, stack.mSource);
+      PrintStack(aOutput, stack.mFrames, stack.mFrameCount);
+    }
+
+    if (0 != sUnrecordedCount)
+    {
+      fprintf(aOutput, "\n%d more allocations from call stacks we had no room for.\n", sUnrecordedCount);
+    }
+
+    return false;
+  }
+}
+
+// Replacements of the global allocation functions, the sized and aligned
+// variants aren't replaced: the sized ones forward to these by default.
+void* operator new(size_t aSize)
+{
+  SOIS::Record(aSize, "operator new");
+  void* pointer = malloc(0 != aSize ? aSize : 1);
+  if (nullptr == pointer)
+  {
+    throw std::bad_alloc();
+  }
+
+  return pointer;
+}
+
+void* operator new[](size_t aSize)
+{
+  SOIS::Record(aSize, "operator new[]");
+  void* pointer = malloc(0 != aSize ? aSize : 1);
+  if (nullptr == pointer)
+  {
+    throw std::bad_alloc();
+  }
+
+  return pointer;
+}
+
+void* operator new(size_t aSize, std::nothrow_t const&) noexcept
+{
+  SOIS::Record(aSize, "operator new");
+  return malloc(0 != aSize ? aSize : 1);
+}
+
+void* operator new[](size_t aSize, std::nothrow_t const&) noexcept
+{
+  SOIS::Record(aSize, "operator new[]");
+  return malloc(0 != aSize ? aSize : 1);
+}
+
+void operator delete(void* aPointer) noexcept
+{
+  free(aPointer);
+}
+
+void operator delete[](void* aPointer) noexcept
+{
+  free(aPointer);
+}
+
+void operator delete(void* aPointer, std::nothrow_t const&) noexcept
+{
+  free(aPointer);
+}
+
+void operator delete[](void* aPointer, std::nothrow_t const&) noexcept
+{
+  free(aPointer);
+}
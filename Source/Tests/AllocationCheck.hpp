@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdio>
+
+namespace SOIS
+{
+  // Catches allocations in frames that shouldn't have any. While armed, every
+  // allocation made through ImGui (see FrameAllocator) or the global operator
+  // new is counted, and the call stacks they came from are kept for the
+  // report. Arm it once the UI has warmed up: a steady state frame of a UI
+  // that doesn't change should allocate nothing.
+  //
+  // This replaces the global operator new/delete of the executable, they
+  // forward to malloc/free and only check a flag while disarmed.
+
+  // ImGui must already be set up, arming swaps in our own allocator
+  // functions (which still allocate from FrameAllocator).
+  void ArmAllocationCheck();
+  void DisarmAllocationCheck();
+
+  // Allocations since the check was last armed.
+  int GetCheckedAllocationCount();
+
+  // Writes each distinct call stack that allocated while armed, most
+  // frequent first. Returns false if there was any.
+  bool ReportAllocationCheck(FILE* aOutput);
+}
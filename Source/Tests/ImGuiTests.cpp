@@ -0,0 +1,114 @@
+///////////////////////////////////////////////////////////////////////////
+// Regression tests of the ImGui internals this sample changed. They run on
+// the CPU only, in a context without a window or GL context, and exit with
+// 1 if any of them failed.
+///////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <string.h>
+
+#include "imgui.h"
+#include "imgui_internal.h"
+
+namespace SOIS
+{
+  static bool sPassed = true;
+
+  static void Check(bool aCondition, char const* aTest, char const* aWhat)
+  {
+    if (false == aCondition)
+    {
+      printf("%s: %s\n", aTest, aWhat);
+      sPassed = false;
+    }
+  }
+
+  static void BeginTestFrame()
+  {
+    ImGui::NewFrame();
+    ImGui::Begin("Tests", nullptr, ImGuiWindowFlags_NoSavedSettings);
+  }
+
+  static void EndTestFrame()
+  {
+    ImGui::End();
+    ImGui::EndFrame();
+  }
+
+  // Without a text_end, the text length (and the cache key) comes from
+  // strlen, for labels both shorter and longer than the cached ones.
+  static void TestCalcTextSizeWithoutEnd()
+  {
+    char const* labels[] = { "GPU", "some long label", "some longer label, well past the cached length" };
+
+    for (int frame = 0; frame < 3; ++frame)
+    {
+      BeginTestFrame();
+
+      for (char const* label : labels)
+      {
+        ImVec2 size = ImGui::CalcTextSize(label);
+        ImVec2 sizeWithEnd = ImGui::CalcTextSize(label, label + strlen(label));
+        Check(size.x == sizeWithEnd.x && size.y == sizeWithEnd.y, "CalcTextSize without text_end", label);
+      }
+
+      ImVec2 wrapped = ImGui::CalcTextSize("some longer label, wrapped at a small width", nullptr, false, 40.0f);
+      Check(ImGui::GetFontSize() < wrapped.y, "CalcTextSize without text_end", "wrapped label on one line");
+
+      EndTestFrame();
+    }
+  }
+
+  static void InputTextFrame(char* aBuffer, int aSize, bool aFocus)
+  {
+    BeginTestFrame();
+    if (aFocus)
+    {
+      ImGui::SetKeyboardFocusHere();
+    }
+    ImGui::InputTextMultiline("##Text", aBuffer, aSize);
+    EndTestFrame();
+  }
+
+  // The application writes to the buffer while the field is active, then
+  // the field is edited: the whole buffer must hold the field's text, not
+  // the application's bytes before the edit and the field's after it.
+  static void TestInputTextExternalWrite()
+  {
+    char buffer[64] = "hello\nworld";
+
+    InputTextFrame(buffer, sizeof(buffer), true);
+    InputTextFrame(buffer, sizeof(buffer), false);
+
+    ImGui::GetIO().AddInputCharactersUTF8("Qab");
+    InputTextFrame(buffer, sizeof(buffer), false);
+    Check(0 == strcmp(buffer, "Qabhello\nworld"), "InputText external write", "typing before the write");
+
+    buffer[0] = 'z';
+    buffer[1] = 'z';
+    InputTextFrame(buffer, sizeof(buffer), false);
+
+    ImGui::GetIO().AddInputCharactersUTF8("c");
+    InputTextFrame(buffer, sizeof(buffer), false);
+    Check(0 == strcmp(buffer, "Qabchello\nworld"), "InputText external write", "typing after the write");
+
+    ImGui::ClearActiveID();
+  }
+}
+
+int main(int, char**)
+{
+  ImGui::CreateContext();
+  ImGuiIO& io = ImGui::GetIO();
+  io.IniFilename = nullptr;
+  io.DisplaySize = ImVec2(1920.0f, 1080.0f);
+  io.DeltaTime = 1.0f / 60.0f;
+  unsigned char* pixels;
+  int width, height;
+  io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+  SOIS::TestCalcTextSizeWithoutEnd();
+  SOIS::TestInputTextExternalWrite();
+
+  ImGui::DestroyContext();
+  return SOIS::sPassed ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+///////////////////////////////////////////////////////////////////////////
+// Renders the ImGui sample (with the ImGui demo) headlessly, and fails
+// (exit code 1) if any frame after the first --warmup N (default 60)
+// allocated, printing the call stacks that did. Runs --frames N (default
+// 200) frames in total.
+///////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+
+#include "AllocationCheck.hpp"
+#include "ImGuiSample.hpp"
+#include "ApplicationContext.hpp"
+
+int main(int argc, char** argv)
+{
+  SOIS::ContextSettings settings;
+  settings.mHeadless = true;
+  int frames = 200;
+  int warmupFrames = 60;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (0 == strcmp(argv[i], "--frames") && i + 1 < argc)
+    {
+      frames = atoi(argv[++i]);
+    }
+    else if (0 == strcmp(argv[i], "--warmup") && i + 1 < argc)
+    {
+      warmupFrames = atoi(argv[++i]);
+    }
+  }
+
+  SOIS::ApplicationContext context{ settings };
+  SOIS::ImGuiSample sample;
+
+  int frame = 0;
+  while (context.Update())
+  {
+    // From here on, every frame is the same as the last one.
+    if (warmupFrames == frame++)
+    {
+      SOIS::ArmAllocationCheck();
+    }
+
+    sample.Update(context);
+    context.mClearColor = sample.mClearColor;
+
+    if (frames <= frame)
+    {
+      context.EndApplication();
+    }
+  }
+
+  SOIS::DisarmAllocationCheck();
+  if (frame <= warmupFrames)
+  {
+    std::cout << "Only " << frame << " frames ran, the check needs more than the " << warmupFrames << " warm-up frames." << std::endl;
+    return 1;
+  }
+
+  if (false == SOIS::ReportAllocationCheck(stdout))
+  {
+    return 1;
+  }
+
+  return 0;
+}
@@ -10,6 +10,9 @@
 // Most of your set up can happen after the context creation, and any
 // updates can happen inside of the while loop.
 //
+// Pass --headless to render offscreen without a window, optionally with
+// --frames N (default 600) and --output file.png to save the last frame.
+//
 // Dependencies:
 // glbinding
 // GLFW
@@ -19,19 +22,47 @@
 // stb libraries
 ///////////////////////////////////////////////////////////////////////////
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <iostream>
 
+#include "stb_image_write.h"
+
 #include "ImGuiSample.hpp"
 #include "ApplicationContext.hpp"
 
-int main(int, char**)
+int main(int argc, char** argv)
 {
+  SOIS::ContextSettings settings;
+  int headlessFrames = 600;
+  const char* outputFile = nullptr;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (0 == strcmp(argv[i], "--headless"))
+    {
+      settings.mHeadless = true;
+    }
+    else if (0 == strcmp(argv[i], "--frames") && i + 1 < argc)
+    {
+      headlessFrames = atoi(argv[++i]);
+    }
+    else if (0 == strcmp(argv[i], "--output") && i + 1 < argc)
+    {
+      outputFile = argv[++i];
+    }
+  }
+
   ///////////////////////////////////////////////////////////////////////////
   // Application set up, after this you can run "any" OpenGL or ImGui code
   // you'd like in the while loop down below.
   ///////////////////////////////////////////////////////////////////////////
-  SOIS::ApplicationInitialization();
-  SOIS::ApplicationContext context;
+  if (false == settings.mHeadless)
+  {
+    SOIS::ApplicationInitialization();
+  }
+
+  SOIS::ApplicationContext context{ settings };
 
   ///////////////////////////////////////////////////////////////////////////
   // This is not required to call any ImGui code you write. It's simply
@@ -151,18 +182,35 @@ int main(int, char**)
     // reference. So I suspect checking that out if you want to do more 
     // interesting things.
     ///////////////////////////////////////////////////////////////////////////
-    sample.Update();
+    sample.Update(context);
     context.mClearColor = sample.mClearColor;
 
     ///////////////////////////////////////////////////////////////////////////
     // The rest of the loop is just the stuff you need to do to actually run
     // the hello-triangle example we set up above.
     ///////////////////////////////////////////////////////////////////////////
-    // draw our first triangle
+    // draw our first triangle (it never changes, if yours do and you skip
+    // unchanged frames, call context.Invalidate() when they do.)
     gl::glUseProgram(shaderProgram);
     gl::glBindVertexArray(VAO); // seeing as we only have a single VAO there's no need to bind it every time, but we'll do so to keep things a bit more organized
     //glDrawArrays(GL_TRIANGLES, 0, 6);
     gl::glDrawElements(gl::GL_TRIANGLES, 6, gl::GL_UNSIGNED_INT, 0);
+
+    // Headless runs have no window to close, so stop after enough frames.
+    if (context.IsHeadless() && 0 >= --headlessFrames)
+    {
+      context.EndApplication();
+    }
+  }
+
+  std::vector<unsigned char> pixels;
+  int width, height;
+  if (nullptr != outputFile && context.ReadFramebuffer(pixels, width, height))
+  {
+    if (0 == stbi_write_png(outputFile, width, height, 4, pixels.data(), width * 4))
+    {
+      std::cout << "Failed to write " << outputFile << std::endl;
+    }
   }
 
   return 0;